@@ -104,6 +104,8 @@ common/CScriptObj.cpp
 common/CScriptObj.h
 common/CSectorTemplate.cpp
 common/CSectorTemplate.h
+common/CSlab.cpp
+common/CSlab.h
 common/CSocket.cpp
 common/CSocket.h
 common/CString.cpp
@@ -48,6 +48,7 @@ enum ENCRYPTION_TYPE
 // HuffMan Compression Class
 
 #define COMPRESS_TREE_SIZE (256+1)
+#define COMPRESS_MAXLENGTH(len) ((((len) + 1) * 15 + 7) / 8)	// worst case output size of CHuffman::Compress
 
 class CHuffman
 {
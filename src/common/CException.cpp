@@ -67,6 +67,10 @@ CGrayError::CGrayError( const CGrayError &e ) :
 	m_hError( e.m_hError ),
 	m_pszDescription( e.m_pszDescription )
 {
+#ifdef THREAD_SAMPLE_CALLSTACK
+	m_fStackTrace = e.m_fStackTrace;
+	e.m_fStackTrace = false;
+#endif
 }
 
 CGrayError::CGrayError( LOGL_TYPE eSev, DWORD hErr, LPCTSTR pszDescription ) :
@@ -74,10 +78,19 @@ CGrayError::CGrayError( LOGL_TYPE eSev, DWORD hErr, LPCTSTR pszDescription ) :
 	m_hError( hErr ),
 	m_pszDescription( pszDescription )
 {
+#ifdef THREAD_SAMPLE_CALLSTACK
+	StackDebugInformation::captureStackTrace();
+	m_fStackTrace = true;
+#endif
 }
 
 CGrayError::~CGrayError() 
 {
+#ifdef THREAD_SAMPLE_CALLSTACK
+	// EXC_CATCH has printed the callstack by now, a handler elsewhere never will
+	if ( m_fStackTrace )
+		StackDebugInformation::clearStackTrace();
+#endif
 }
 
 // --------------------------------------------------------------------------------
@@ -248,7 +261,10 @@ void SetExceptionTranslator()
 		sigset_t set;
 
 		g_Log.Event( LOGL_FATAL, "%s\n", strsignal(sig) );
-#ifdef THREAD_TRACK_CALLSTACK
+#ifdef THREAD_SAMPLE_CALLSTACK
+		StackDebugInformation::captureStackTrace();
+#endif
+#if defined(THREAD_TRACK_CALLSTACK) || defined(THREAD_SAMPLE_CALLSTACK)
 		StackDebugInformation::printStackTrace();
 #endif
 
@@ -268,6 +284,15 @@ void SetExceptionTranslator()
 	{
 		while (waitpid((pid_t)(-1), 0, WNOHANG) > 0) {}
 	}
+
+#ifdef THREAD_SAMPLE_CALLSTACK
+	void _cdecl Signal_StackTrace( int sig = 0 )
+	{
+		// a thread seems frozen, record where it is (see AbstractSphereThread::requestStackTrace)
+		UNREFERENCED_PARAMETER(sig);
+		StackDebugInformation::captureStackTrace();
+	}
+#endif
 #endif
 
 void SetUnixSignals( bool bSet )
@@ -283,6 +308,13 @@ void SetUnixSignals( bool bSet )
 	signal( SIGFPE,		bSet ? &Signal_Illegal_Instruction : SIG_DFL );
 	signal( SIGPIPE,	bSet ? SIG_IGN : SIG_DFL );
 	signal( SIGCHLD,	bSet ? &Signal_Children : SIG_DFL );
+#ifdef THREAD_SAMPLE_CALLSTACK
+	signal( THREAD_SAMPLE_SIGNAL,	bSet ? &Signal_StackTrace : SIG_DFL );
+
+	// the first backtrace() loads libgcc, don't let that happen in a signal handler
+	void *pFrame;
+	backtrace(&pFrame, 1);
+#endif
 #else
 	UNREFERENCED_PARAMETER(bSet);
 #endif
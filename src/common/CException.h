@@ -30,6 +30,10 @@ public:
 	LOGL_TYPE m_eSeverity;	// const
 	DWORD m_hError;	// HRESULT S_OK, "winerror.h" code. 0x20000000 = start of custom codes.
 	LPCTSTR m_pszDescription;
+#ifdef THREAD_SAMPLE_CALLSTACK
+private:
+	mutable bool m_fStackTrace;	// the callstack of this thread is ours to clear (the last copy has it)
+#endif
 public:
 	CGrayError( LOGL_TYPE eSev, DWORD hErr, LPCTSTR pszDescription );
 	CGrayError( const CGrayError& e );	// copy contstructor needed.
@@ -100,7 +104,7 @@ public:
 
 	#define EXC_SET(a) inLocalBlock = a; inLocalBlockCnt++
 
-	#ifdef THREAD_TRACK_CALLSTACK
+	#if defined(THREAD_TRACK_CALLSTACK) || defined(THREAD_SAMPLE_CALLSTACK)
 		#define EXC_CATCH_EXCEPTION(a) \
 			bCATCHExcept = true; \
 			StackDebugInformation::printStackTrace(); \
@@ -140,7 +144,7 @@ public:
 
 	#define EXC_SETSUB(a) inLocalSubBlock = a; inLocalSubBlockCnt++
 
-	#ifdef THREAD_TRACK_CALLSTACK
+	#if defined(THREAD_TRACK_CALLSTACK) || defined(THREAD_SAMPLE_CALLSTACK)
 		#define EXC_CATCH_SUB(a,b) \
 			bCATCHExceptSub = true; \
 			StackDebugInformation::printStackTrace(); \
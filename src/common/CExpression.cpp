@@ -288,9 +288,9 @@ int Calc_GetRandVal( int iqty )
 		return( 0 );
 	if ( iqty >= INT_MAX )
 	{
-		return( IMULDIV( g_World.m_Rand.randInt(), (DWORD) iqty, INT_MAX )) ;
+		return( IMULDIV( CSectorTicker::GetRand().randInt(), (DWORD) iqty, INT_MAX )) ;
 	}
-	return( g_World.m_Rand.randInt() % iqty );
+	return( CSectorTicker::GetRand().randInt() % iqty );
 }
 
 int Calc_GetRandVal2( int iMin, int iMax )
@@ -301,7 +301,7 @@ int Calc_GetRandVal2( int iMin, int iMax )
 		iMin = iMax;
 		iMax = tmp;
 	}
-	return(iMin + g_World.m_Rand.randInt() % ((iMax - iMin) + 1) );
+	return(iMin + CSectorTicker::GetRand().randInt() % ((iMax - iMin) + 1) );
 }
 
 INT64 Calc_GetRandLLVal( INT64 iqty )
@@ -310,9 +310,9 @@ INT64 Calc_GetRandLLVal( INT64 iqty )
 		return( 0 );
 	if ( iqty >= LLONG_MAX )
 	{
-		return( IMULDIV( g_World.m_Rand.genrand64_int64(), (DWORD) iqty, LLONG_MAX )) ;
+		return( IMULDIV( CSectorTicker::GetRand().genrand64_int64(), (DWORD) iqty, LLONG_MAX )) ;
 	}
-	return( g_World.m_Rand.genrand64_int64() % iqty );
+	return( CSectorTicker::GetRand().genrand64_int64() % iqty );
 }
 
 INT64 Calc_GetRandLLVal2( INT64 iMin, INT64 iMax )
@@ -323,7 +323,7 @@ INT64 Calc_GetRandLLVal2( INT64 iMin, INT64 iMax )
 		iMin = iMax;
 		iMax = tmp;
 	}
-	return(iMin + g_World.m_Rand.genrand64_int64() % ((iMax - iMin) + 1) );
+	return(iMin + CSectorTicker::GetRand().genrand64_int64() % ((iMax - iMin) + 1) );
 }
 
 int Calc_GetBellCurve( int iValDiff, int iVariance )
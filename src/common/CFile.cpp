@@ -2,6 +2,7 @@
 
 #ifndef _WIN32
 #include <errno.h>	// errno
+#include <sys/mman.h>	// mmap
 #endif
 
 #include "CString.h"
@@ -293,10 +294,63 @@ void CGFile::Close()
 	if ( ! IsFileOpen())
 		return;
 
+	UnmapView();
 	CloseBase();
 	m_hFile = NOFILE_HANDLE;
 }
 
+bool CGFile::MapView()
+{
+	ADDTOCALLSTACK("CGFile::MapView");
+	// Map the whole file read only, the OS page cache keeps what is used.
+	if ( IsMapped())
+		return( true );
+	if ( ! IsFileOpen() || IsWriteMode())
+		return( false );
+
+	DWORD dwLength = GetLength();
+	if (( dwLength == 0 ) || ( dwLength == static_cast<DWORD>(-1) ))
+		return( false );
+
+#ifdef _WIN32
+	m_hMapping = CreateFileMapping( m_hFile, NULL, PAGE_READONLY, 0, 0, NULL );
+	if ( m_hMapping == NULL )
+		return( false );
+	void * pView = MapViewOfFile( m_hMapping, FILE_MAP_READ, 0, 0, 0 );
+	if ( pView == NULL )
+	{
+		CloseHandle( m_hMapping );
+		m_hMapping = NULL;
+		return( false );
+	}
+#else
+	void * pView = mmap( NULL, dwLength, PROT_READ, MAP_SHARED, m_hFile, 0 );
+	if ( pView == MAP_FAILED )
+		return( false );
+#endif
+
+	m_pMapView = static_cast<const BYTE *>(pView);
+	m_dwMapLength = dwLength;
+	return( true );
+}
+
+void CGFile::UnmapView()
+{
+	ADDTOCALLSTACK("CGFile::UnmapView");
+	if ( m_pMapView == NULL )
+		return;
+
+#ifdef _WIN32
+	UnmapViewOfFile( m_pMapView );
+	CloseHandle( m_hMapping );
+	m_hMapping = NULL;
+#else
+	munmap( const_cast<BYTE *>(m_pMapView), m_dwMapLength );
+#endif
+	m_pMapView = NULL;
+	m_dwMapLength = 0;
+}
+
 //***************************************************************************
 // -CFileText
 
@@ -167,6 +167,11 @@ class CGFile : public CFile
 {
 private:
 	UINT m_uMode;	///< MMSYSTEM may use 32 bit flags.
+	const BYTE * m_pMapView;	///< Read only view of the whole file (MulMapping), NULL if not mapped.
+	DWORD m_dwMapLength;		///< Length of m_pMapView.
+#ifdef _WIN32
+	HANDLE m_hMapping;			///< File mapping object behind m_pMapView.
+#endif
 public:
 	static const char *m_sClassName;
 private:
@@ -250,10 +255,48 @@ public:
 	* @brief Closes the file if is open.
 	*/
 	virtual void Close();
+
+	/**
+	* @brief Maps the whole (open, read only) file into memory.
+	*
+	* Reads can then be served from the page cache without a Seek() + Read().
+	* The view stays valid until UnmapView() or Close().
+	* @return true if the file is mapped, false otherwise (reads keep using the handle).
+	*/
+	bool MapView();
+	/**
+	* @brief Releases the view created by MapView(), if any.
+	*/
+	void UnmapView();
+	/**
+	* @brief Check if file is mapped into memory.
+	* @return true if MapView() succeeded, false otherwise.
+	*/
+	bool IsMapped() const { return( m_pMapView != NULL ); }
+	/**
+	* @brief Gets a pointer to some data inside the mapped file.
+	* @param dwOffset offset of the data from the start of the file.
+	* @param dwLength length of the data.
+	* @return pointer to the data, NULL if the file is not mapped or the data is out of the file.
+	*/
+	const BYTE * GetMapView( DWORD dwOffset, DWORD dwLength ) const
+	{
+		if (( m_pMapView == NULL ) || ( dwOffset > m_dwMapLength ) || ( dwLength > m_dwMapLength - dwOffset ))
+			return( NULL );
+		return( m_pMapView + dwOffset );
+	}
 	
 	// File Access
 public:
-	CGFile() { m_uMode = 0; }
+	CGFile()
+	{
+		m_uMode = 0;
+		m_pMapView = NULL;
+		m_dwMapLength = 0;
+#ifdef _WIN32
+		m_hMapping = NULL;
+#endif
+	}
 	virtual ~CGFile() { Close(); }
 
 private:
@@ -191,15 +191,12 @@ CGrayItemInfo::CGrayItemInfo( ITEMID_TYPE id )
 		}
 	}
 
-	if ( g_Install.m_File[filedata].Seek( offset, SEEK_SET ) != offset )
-	{
-		throw CGrayError(LOGL_CRIT, CGFile::GetLastError(), "CTileItemType.ReadInfo: TileData Seek");
-	}
-
+	// ReadMulData() copies out of the mapped file if MulMapping is on.
 	switch (format)
 	{
 		case VERFORMAT_HIGHSEAS: // high seas format (CUOItemTypeRec2)
-			if ( g_Install.m_File[filedata].Read( static_cast <CUOItemTypeRec2 *>(this), sizeof(CUOItemTypeRec2)) <= 0 )
+			Index.SetupIndex( offset, sizeof(CUOItemTypeRec2));
+			if ( !g_Install.ReadMulData( g_Install.m_File[filedata], Index, static_cast <CUOItemTypeRec2 *>(this)))
 				throw CGrayError(LOGL_CRIT, CGFile::GetLastError(), "CTileItemType.ReadInfo: TileData Read");
 			break;
 
@@ -207,7 +204,8 @@ CGrayItemInfo::CGrayItemInfo( ITEMID_TYPE id )
 		default:
 		{
 			CUOItemTypeRec record;
-			if ( g_Install.m_File[filedata].Read( static_cast <CUOItemTypeRec *>(&record), sizeof(CUOItemTypeRec)) <= 0 )
+			Index.SetupIndex( offset, sizeof(CUOItemTypeRec));
+			if ( !g_Install.ReadMulData( g_Install.m_File[filedata], Index, static_cast <CUOItemTypeRec *>(&record)))
 				throw CGrayError(LOGL_CRIT, CGFile::GetLastError(), "CTileTerrainType.ReadInfo: TileData Read");
 			
 			m_flags = record.m_flags;
@@ -296,15 +294,12 @@ CGrayTerrainInfo::CGrayTerrainInfo( TERRAIN_TYPE id )
 		}
 	}
 
-	if ( g_Install.m_File[filedata].Seek( offset, SEEK_SET ) != offset )
-	{
-		throw CGrayError(LOGL_CRIT, CGFile::GetLastError(), "CTileTerrainType.ReadInfo: TileData Seek");
-	}
-
+	// ReadMulData() copies out of the mapped file if MulMapping is on.
 	switch (format)
 	{
 		case VERFORMAT_HIGHSEAS: // high seas format (CUOTerrainTypeRec2)
-			if ( g_Install.m_File[filedata].Read(static_cast <CUOTerrainTypeRec2 *>(this), sizeof(CUOTerrainTypeRec2)) <= 0 )
+			Index.SetupIndex( offset, sizeof(CUOTerrainTypeRec2));
+			if ( !g_Install.ReadMulData( g_Install.m_File[filedata], Index, static_cast <CUOTerrainTypeRec2 *>(this)))
 				throw CGrayError(LOGL_CRIT, CGFile::GetLastError(), "CTileTerrainType.ReadInfo: TileData Read");
 			break;
 
@@ -312,7 +307,8 @@ CGrayTerrainInfo::CGrayTerrainInfo( TERRAIN_TYPE id )
 		default:
 		{
 			CUOTerrainTypeRec record;
-			if ( g_Install.m_File[filedata].Read(static_cast <CUOTerrainTypeRec *>(&record), sizeof(CUOTerrainTypeRec)) <= 0 )
+			Index.SetupIndex( offset, sizeof(CUOTerrainTypeRec));
+			if ( !g_Install.ReadMulData( g_Install.m_File[filedata], Index, static_cast <CUOTerrainTypeRec *>(&record)))
 				throw CGrayError(LOGL_CRIT, CGFile::GetLastError(), "CTileTerrainType.ReadInfo: TileData Read");
 
 			m_flags = record.m_flags;
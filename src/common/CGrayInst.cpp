@@ -380,6 +380,9 @@ VERFILE_TYPE CGrayInstall::OpenFiles( DWORD dwMask )
 			break;
 	}
 
+	if ( g_Cfg.m_fMulMapping )
+		MapFiles();
+
 	DetectMulVersions();
 	g_MapList.Init();
 
@@ -388,11 +391,51 @@ VERFILE_TYPE CGrayInstall::OpenFiles( DWORD dwMask )
 	return static_cast<VERFILE_TYPE>(i);
 }
 
+void CGrayInstall::MapFiles()
+{
+	ADDTOCALLSTACK("CGrayInstall::MapFiles");
+	// Map the files read while the server runs (MulMapping).
+	// The map blocks then point straight into the maps instead of keeping a copy.
+	// Files that can't be mapped just keep being read.
+	static const VERFILE_TYPE sm_MappedFiles[] = { VERFILE_TILEDATA, VERFILE_MULTIIDX, VERFILE_MULTI, VERFILE_VERDATA };
+	for ( size_t i = 0; i < COUNTOF(sm_MappedFiles); i++ )
+	{
+		CGFile & file = m_File[sm_MappedFiles[i]];
+		if ( file.IsFileOpen() && !file.MapView() )
+			g_Log.EventWarn("Unable to map '%s' into memory, reading it instead.\n", static_cast<LPCTSTR>(file.GetFilePath()));
+	}
+
+	for ( int m = 0; m < 256; m++ )
+	{
+		CGFile * pFiles[] = { &m_Maps[m], &m_Staidx[m], &m_Statics[m] };
+		for ( size_t i = 0; i < COUNTOF(pFiles); i++ )
+		{
+			if ( pFiles[i]->IsFileOpen() && !pFiles[i]->MapView() )
+				g_Log.EventWarn("Unable to map '%s' into memory, reading it instead.\n", static_cast<LPCTSTR>(pFiles[i]->GetFilePath()));
+		}
+	}
+}
+
 void CGrayInstall::CloseFiles()
 {
 	ADDTOCALLSTACK("CGrayInstall::CloseFiles");
 	int i;
 
+	// Cached map blocks may point into the mapped files.
+	bool fMapped = false;
+	for ( i = 0; i < 256 && !fMapped; i++ )
+		fMapped = ( m_Maps[i].IsMapped() || m_Statics[i].IsMapped() );
+	if ( fMapped )
+	{
+		for ( i = 0; i < 256; i++ )
+		{
+			if ( !g_MapList.m_maps[i] )
+				continue;
+			for ( int s = 0; s < g_MapList.GetSectorQty(i); s++ )
+				g_World.GetSector(i, s)->ClearMapBlockCache();
+		}
+	}
+
 	for ( i = 0; i < VERFILE_QTY; i++ )
 	{
 		if ( m_File[i].IsFileOpen() ) m_File[i].Close();
@@ -416,6 +459,16 @@ bool CGrayInstall::ReadMulIndex(CGFile &file, DWORD id, CUOIndexRec &Index)
 	ADDTOCALLSTACK("CGrayInstall::ReadMulIndex");
 	DWORD lOffset = id * sizeof(CUOIndexRec);
 
+	if ( file.IsMapped())
+	{
+		const BYTE * pView = file.GetMapView(lOffset, sizeof(CUOIndexRec));
+		if ( pView == NULL )
+			return false;
+		memcpy(&Index, pView, sizeof(CUOIndexRec));
+		return Index.HasData();
+	}
+
+	SimpleThreadLock lock(m_ReadLock);
 	if ( file.Seek(lOffset, SEEK_SET) != lOffset )
 		return false;
 
@@ -428,16 +481,34 @@ bool CGrayInstall::ReadMulIndex(CGFile &file, DWORD id, CUOIndexRec &Index)
 bool CGrayInstall::ReadMulData(CGFile &file, const CUOIndexRec &Index, void * pData)
 {
 	ADDTOCALLSTACK("CGrayInstall::ReadMulData");
+	DWORD dwLength = Index.GetBlockLength();
+	if ( file.IsMapped())
+	{
+		const void * pView = GetMulView(file, Index);
+		if ( pView == NULL )
+			return false;
+		memcpy(pData, pView, dwLength);
+		return true;
+	}
+
+	SimpleThreadLock lock(m_ReadLock);
 	if ( file.Seek(Index.GetFileOffset(), SEEK_SET) != Index.GetFileOffset() )
 		return false;
 
-	DWORD dwLength = Index.GetBlockLength();
 	if ( file.Read(pData, dwLength) != dwLength )
 		return false;
 
 	return true;
 }
 
+const void * CGrayInstall::GetMulView(const CGFile &file, const CUOIndexRec &Index) const
+{
+	ADDTOCALLSTACK("CGrayInstall::GetMulView");
+	// Get the data in place if the file is mapped. (MulMapping)
+	// RETURN: NULL = not mapped or out of the file, use ReadMulData().
+	return file.GetMapView(Index.GetFileOffset(), Index.GetBlockLength());
+}
+
 bool CGrayInstall::ReadMulIndex(VERFILE_TYPE fileindex, VERFILE_TYPE filedata, DWORD id, CUOIndexRec & Index)
 {
 	ADDTOCALLSTACK("CGrayInstall::ReadMulIndex");
@@ -6,6 +6,7 @@
 #include "../common/CFile.h"
 #include "../common/CArray.h"
 #include "../common/CsvFile.h"
+#include "../sphere/mutex.h"
 
 ////////////////////////////////////////////////////////
 
@@ -43,6 +44,7 @@ public:
 	MapAddress m_UopMapAddress[256][256]; //For uop parsing. Note: might need to be ajusted later if format changes.
 
 	CSVFile m_CsvFiles[8];		// doors.txt, stairs.txt (x2), roof.txt, misc.txt, teleprts.txt, floors.txt, walls.txt
+	SimpleMutex m_ReadLock;		// Seek() + Read() of the files that are not mapped, the sector threads share them
 
 public:
 	CGString GetFullExePath( LPCTSTR pszName = NULL ) const
@@ -73,6 +75,7 @@ public:
 	VERFILE_TYPE OpenFiles( DWORD dwMask );
 	bool OpenFile( CGFile & file, LPCTSTR pszName, WORD wFlags );
 	bool OpenFile( VERFILE_TYPE i );
+	void MapFiles();
 	void CloseFiles();
 
 	static LPCTSTR GetBaseFileName( VERFILE_TYPE i );
@@ -101,6 +104,7 @@ public:
 
 	bool ReadMulIndex(CGFile &file, DWORD id, CUOIndexRec &Index);
 	bool ReadMulData(CGFile &file, const CUOIndexRec &Index, void * pData);
+	const void * GetMulView(const CGFile &file, const CUOIndexRec &Index) const;
 	
 public:
 	CGrayInstall()
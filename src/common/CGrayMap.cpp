@@ -335,9 +335,21 @@ void CGrayStaticsBlock::LoadStatics( DWORD ulBlockIndex, int map )
 		}
 		m_iStatics = index.GetBlockLength()/sizeof(CUOStaticItemRec);
 		ASSERT(m_iStatics);
-		m_pStatics = new CUOStaticItemRec[m_iStatics];
-		ASSERT(m_pStatics);
-		if ( ! g_Install.ReadMulData(g_Install.m_Statics[g_MapList.m_mapnum[map]], index, m_pStatics) )
+
+		// Just look at them in place if the statics file is mapped. (MulMapping)
+		CGFile & file = g_Install.m_Statics[g_MapList.m_mapnum[map]];
+		m_pStatics = static_cast<const CUOStaticItemRec *>(g_Install.GetMulView(file, index));
+		if ( m_pStatics != NULL )
+		{
+			m_fOwnStatics = false;
+			return;
+		}
+
+		CUOStaticItemRec * pStatics = new CUOStaticItemRec[m_iStatics];
+		ASSERT(pStatics);
+		m_pStatics = pStatics;
+		m_fOwnStatics = true;
+		if ( ! g_Install.ReadMulData(file, index, pStatics) )
 		{
 			throw CGrayError(LOGL_CRIT, CGFile::GetLastError(), "CGrayMapBlock: Read Statics");
 		}
@@ -351,14 +363,17 @@ void CGrayStaticsBlock::LoadStatics( size_t iCount, CUOStaticItemRec * pStatics
 	m_iStatics = iCount;
 	if ( m_iStatics > 0 )
 	{
-		m_pStatics = new CUOStaticItemRec[m_iStatics];
-		memcpy(m_pStatics, pStatics, sizeof(CUOStaticItemRec) * m_iStatics);
+		CUOStaticItemRec * pCopy = new CUOStaticItemRec[m_iStatics];
+		memcpy(pCopy, pStatics, sizeof(CUOStaticItemRec) * m_iStatics);
+		m_pStatics = pCopy;
+		m_fOwnStatics = true;
 	}
 	else
 	{
-		if ( m_pStatics != NULL )
+		if ( m_fOwnStatics && m_pStatics != NULL )
 			delete[] m_pStatics;
 		m_pStatics = NULL;
+		m_fOwnStatics = false;
 	}
 }
 
@@ -376,6 +391,64 @@ bool CGrayStaticsBlock::IsStaticPoint( size_t i, int xo, int yo ) const
 
 size_t CGrayMapBlock::sm_iCount = 0;
 
+const CGrayStaticsLOS & CGrayMapBlock::GetStaticsLOS( int xo, int yo ) const
+{
+	ADDTOCALLSTACK("CGrayMapBlock::GetStaticsLOS");
+	ASSERT( xo >= 0 && xo < UO_BLOCK_SIZE );
+	ASSERT( yo >= 0 && yo < UO_BLOCK_SIZE );
+
+	if ( !m_fStaticsLOS || ( m_dwStaticsLOSStamp != CSectorBase::sm_dwWalkGlobal ))
+	{
+		// Sum up the statics of each point, the same way CChar::CanSeeLOS_New looks at them.
+		memset( m_StaticsLOS, 0, sizeof(m_StaticsLOS));
+		for ( size_t i = 0; i < m_Statics.GetStaticQty(); ++i )
+		{
+			const CUOStaticItemRec * pStatic = m_Statics.GetStatic(i);
+			if ( pStatic->m_x >= UO_BLOCK_SIZE || pStatic->m_y >= UO_BLOCK_SIZE )
+				continue;
+
+			CGrayStaticsLOS & los = m_StaticsLOS[ pStatic->m_y*UO_BLOCK_SIZE + pStatic->m_x ];
+			los.m_bFlags |= LOSSTATIC_ANY;
+
+			const CItemBase * pItemDef = CItemBase::FindItemBase(pStatic->GetDispID());
+			if ( pItemDef == NULL )
+				continue;
+
+			DWORD wTFlags = pItemDef->GetTFlags();
+			height_t Height = pItemDef->GetHeight();
+			if ( pItemDef->GetID() != pStatic->GetDispID() )	// not a parent item
+			{
+				const CItemBaseDupe * pDupeDef = CItemBaseDupe::GetDupeRef(static_cast<ITEMID_TYPE>(pStatic->GetDispID()));
+				if ( pDupeDef != NULL )
+				{
+					wTFlags = pDupeDef->GetTFlags();
+					Height = pDupeDef->GetHeight();
+				}
+			}
+			if ( !(wTFlags & (UFLAG1_WALL|UFLAG1_BLOCK|UFLAG2_PLATFORM)) && !(pItemDef->m_Can & CAN_I_BLOCKLOS) )
+				continue;
+
+			Height = (wTFlags & UFLAG2_CLIMBABLE) ? Height / 2 : Height;
+			signed char zBottom = pStatic->m_z;
+			signed char zTop = static_cast<signed char>(minimum(Height + zBottom, UO_SIZE_Z));
+			if ( !(los.m_bFlags & LOSSTATIC_BLOCK) )
+			{
+				los.m_bFlags |= LOSSTATIC_BLOCK;
+				los.m_zBottom = zBottom;
+				los.m_zTop = zTop;
+			}
+			else
+			{
+				los.m_zBottom = minimum(los.m_zBottom, zBottom);
+				los.m_zTop = maximum(los.m_zTop, zTop);
+			}
+		}
+		m_dwStaticsLOSStamp = CSectorBase::sm_dwWalkGlobal;
+		m_fStaticsLOS = true;
+	}
+	return( m_StaticsLOS[ yo*UO_BLOCK_SIZE + xo ] );
+}
+
 void CGrayMapBlock::Load( int bx, int by )
 {
 	ADDTOCALLSTACK("CGrayMapBlock::Load");
@@ -468,18 +541,29 @@ void CGrayMapBlock::Load( int bx, int by )
 			fileOffset += firstBlockDataEntryOffset + ((firstDataEntryOffset) * (block / 100)) + (blockHeaderLength * block);*/
 		}
 
-		// seek to position in file
-		if ( pFile->Seek( fileOffset, SEEK_SET ) != fileOffset )
+		// look at it in place if the map file is mapped (MulMapping)
+		index.SetupIndex( fileOffset, sizeof(CUOMapBlock));
+		const CUOMapBlock * pTerrain = static_cast<const CUOMapBlock *>(g_Install.GetMulView(*pFile, index));
+		if ( pTerrain != NULL )
 		{
-			memset( &m_Terrain, 0, sizeof(m_Terrain));
-			throw CGrayError(LOGL_CRIT, CGFile::GetLastError(), "CGrayMapBlock: Seek Ver");
+			m_pTerrain = pTerrain;
 		}
-
-		// read terrain data
-		if ( pFile->Read( &m_Terrain, sizeof(CUOMapBlock)) <= 0 )
+		else
 		{
-			memset( &m_Terrain, 0, sizeof( m_Terrain ));
-			throw CGrayError(LOGL_CRIT, CGFile::GetLastError(), "CGrayMapBlock: Read");
+			// seek to position in file
+			SimpleThreadLock lock(g_Install.m_ReadLock);
+			if ( pFile->Seek( fileOffset, SEEK_SET ) != fileOffset )
+			{
+				memset( &m_Terrain, 0, sizeof(m_Terrain));
+				throw CGrayError(LOGL_CRIT, CGFile::GetLastError(), "CGrayMapBlock: Seek Ver");
+			}
+
+			// read terrain data
+			if ( pFile->Read( &m_Terrain, sizeof(CUOMapBlock)) <= 0 )
+			{
+				memset( &m_Terrain, 0, sizeof( m_Terrain ));
+				throw CGrayError(LOGL_CRIT, CGFile::GetLastError(), "CGrayMapBlock: Read");
+			}
 		}
 	}
 
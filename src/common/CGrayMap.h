@@ -48,7 +48,8 @@ class CGrayStaticsBlock
 {
 private:
 	size_t m_iStatics;
-	CUOStaticItemRec * m_pStatics;	// dyn alloc array block.
+	const CUOStaticItemRec * m_pStatics;	// dyn alloc array block, or a view into the mapped statics file.
+	bool m_fOwnStatics;					// m_pStatics was allocated here.
 public:
 	void LoadStatics(DWORD dwBlockIndex, int map);
 	void LoadStatics(size_t iCount, CUOStaticItemRec * pStatics);
@@ -58,10 +59,11 @@ public:
 	{
 		m_iStatics = 0;
 		m_pStatics = NULL;
+		m_fOwnStatics = false;
 	}
 	~CGrayStaticsBlock()
 	{
-		if ( m_pStatics != NULL )
+		if ( m_fOwnStatics && m_pStatics != NULL )
 			delete[] m_pStatics;
 	}
 
@@ -82,6 +84,16 @@ public:
 	bool IsStaticPoint( size_t i, int xo, int yo ) const;
 };
 
+struct CGrayStaticsLOS
+{
+	// The statics of one point, summed up for line of sight checks. (CChar::CanSeeLOS_New)
+#define LOSSTATIC_ANY	0x01	// there are statics here
+#define LOSSTATIC_BLOCK	0x02	// some of them can block the view, between m_zBottom and m_zTop
+	BYTE m_bFlags;
+	signed char m_zBottom;	// lowest bottom of the statics that can block
+	signed char m_zTop;		// highest top of the statics that can block
+};
+
 struct CGrayMapBlocker
 {
 	DWORD m_dwBlockFlags;	// How does this item block ? CAN_I_PLATFORM
@@ -222,11 +234,17 @@ private:
 	static size_t sm_iCount;	// count number of loaded blocks.
 
 	CUOMapBlock m_Terrain;
+	const CUOMapBlock * m_pTerrain;	// m_Terrain, or a view into the mapped map file.
 
 public:
 	static const char *m_sClassName;
 	CGrayStaticsBlock m_Statics;
 	CGrayCachedMulItem m_CacheTime;	// keep track of the use time of this item. (client does not care about this)
+private:
+	mutable bool m_fStaticsLOS;			// m_StaticsLOS has been built
+	mutable DWORD m_dwStaticsLOSStamp;	// CSectorBase::sm_dwWalkGlobal it was built at (item definitions may change)
+	mutable CGrayStaticsLOS m_StaticsLOS[UO_BLOCK_SIZE*UO_BLOCK_SIZE];
+
 private:
 	void Load(int bx, int by);	// NOTE: This will "throw" on failure !
 	void LoadDiffs(DWORD dwBlockIndex, int map);
@@ -237,6 +255,9 @@ public:
 	{
 		sm_iCount++;
 		m_map = pt.m_map;
+		m_pTerrain = &m_Terrain;
+		m_fStaticsLOS = false;
+		m_dwStaticsLOSStamp = 0;
 		Load(pt.m_x/UO_BLOCK_SIZE, pt.m_y/UO_BLOCK_SIZE);
 	}
 
@@ -245,6 +266,9 @@ public:
 	{
 		sm_iCount++;
 		m_map = map;
+		m_pTerrain = &m_Terrain;
+		m_fStaticsLOS = false;
+		m_dwStaticsLOSStamp = 0;
 		Load( bx, by );
 	}
 
@@ -273,12 +297,13 @@ public:
 	{
 		ASSERT( xo >= 0 && xo < UO_BLOCK_SIZE );
 		ASSERT( yo >= 0 && yo < UO_BLOCK_SIZE );
-		return( &( m_Terrain.m_Meter[ yo*UO_BLOCK_SIZE + xo ] ));
+		return( &( m_pTerrain->m_Meter[ yo*UO_BLOCK_SIZE + xo ] ));
 	}
 	const CUOMapBlock * GetTerrainBlock() const
 	{
-		return( &m_Terrain );
+		return( m_pTerrain );
 	}
+	const CGrayStaticsLOS & GetStaticsLOS( int xo, int yo ) const;
 };
 
 class CGrayMulti : public CGrayCachedMulItem
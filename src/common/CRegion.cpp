@@ -1003,13 +1003,9 @@ TRIGRET_TYPE CRegionBase::OnRegionTrigger( CTextConsole * pSrc, RTRIG_TYPE iActi
 		CResourceLink * pLink = m_Events[i];
 		if ( !pLink || ( pLink->GetResType() != RES_REGIONTYPE ) || !pLink->HasTrigger(iAction) )
 			continue;
-		CResourceLock s;
-		if ( pLink->ResourceLock(s) )
-		{
-			iRet = CScriptObj::OnTriggerScript(s, sm_szTrigName[iAction], pSrc);
-			if ( iRet == TRIGRET_RET_TRUE )
-				return iRet;
-		}
+		iRet = CScriptObj::OnTriggerScript(pLink, iAction, sm_szTrigName[iAction], pSrc);
+		if ( iRet == TRIGRET_RET_TRUE )
+			return iRet;
 	}
 
 	//	EVENTSREGION triggers (constant events of regions set from sphere.ini)
@@ -1018,10 +1014,7 @@ TRIGRET_TYPE CRegionBase::OnRegionTrigger( CTextConsole * pSrc, RTRIG_TYPE iActi
 		CResourceLink * pLink = g_Cfg.m_pEventsRegionLink[i];
 		if ( !pLink || ( pLink->GetResType() != RES_REGIONTYPE ) || !pLink->HasTrigger(iAction) )
 			continue;
-		CResourceLock s;
-		if ( !pLink->ResourceLock(s) )
-			continue;
-		iRet = CScriptObj::OnTriggerScript(s, sm_szTrigName[iAction], pSrc);
+		iRet = CScriptObj::OnTriggerScript(pLink, iAction, sm_szTrigName[iAction], pSrc);
 		if ( iRet != TRIGRET_RET_FALSE && iRet != TRIGRET_RET_DEFAULT )
 			return iRet;
 	}
@@ -5,13 +5,20 @@
 #include "CRect.h"
 #include "graymul.h"
 
+class CSectorIndexCell;
+
 class CObjBaseTemplate : public CGObListRec
 {
 	// A dynamic object of some sort.
+	friend class CSectorIndexCell;
+	friend class CSectorObjList;
 private:
 	CGrayUID	m_UID;		// How the server will refer to this. 0 = static item
 	CGString	m_sName;	// unique name for the individual object.
 	CPointMap	m_pt;		// List is sorted by m_z_sort.
+	CSectorIndexCell *	m_pIndexCell;	// (SectorGrid) cell of the sector list we are in
+	size_t		m_iIndexSlot;	// our slot in m_pIndexCell
+	bool		m_fDeletePending;	// Delete() was called, may still be in a sector list until the end of the tick phase (SectorThreads)
 protected:
 	void DupeCopy( const CObjBaseTemplate * pObj )
 	{
@@ -26,11 +33,18 @@ protected:
 		// don't set container flags through here.
 		m_UID.SetObjUID( dwIndex );	// Will have UID_F_ITEM as well.
 	}
+	void SetDeletePending()
+	{
+		m_fDeletePending = true;
+	}
 
 public:
 	static const char *m_sClassName;
 	CObjBaseTemplate()
 	{
+		m_pIndexCell = NULL;
+		m_iIndexSlot = 0;
+		m_fDeletePending = false;
 	}
 	virtual ~CObjBaseTemplate()
 	{
@@ -59,6 +73,7 @@ public:
 	bool IsTopLevel() const			{ return m_UID.IsObjTopLevel(); }
 	bool IsValidUID() const			{ return m_UID.IsValidUID(); }
 	bool IsDeleted() const;
+	bool IsDeletePending() const	{ return m_fDeletePending; }
 
 	void SetContainerFlags( DWORD dwFlags = 0 )
 	{
@@ -116,6 +131,8 @@ public:
 		SetContainerFlags(0);
 		ASSERT( pt.IsValidPoint() );	// already checked b4.
 		m_pt = pt;
+		if ( m_pIndexCell )
+			UpdateSectorIndex();
 	}
 	const CPointMap & GetTopPoint() const
 	{
@@ -137,7 +154,12 @@ public:
 	void SetUnkPoint( const CPointMap & pt )
 	{
 		m_pt = pt;
+		if ( m_pIndexCell )
+			UpdateSectorIndex();
 	}
+private:
+	void UpdateSectorIndex();
+public:
 
 	// Distance and direction
 	int GetTopDist( const CPointMap & pt ) const
@@ -420,7 +420,7 @@ bool CResourceDef::SetResourceName( LPCTSTR pszName )
 	if ( iVarNum < 0 )
 		return( false );
 
-	SetResourceVar( dynamic_cast <const CVarDefContNum*>( g_Exp.m_VarDefs.GetAt( iVarNum )));
+	SetResourceVar( dynamic_cast <const CVarDefContNum*>( g_Exp.m_VarDefs.GetKey( pszName )));
 	return( true );
 }
 
@@ -816,6 +816,7 @@ void CResourceLink::ScanSection( RES_TYPE restype )
 	ASSERT(m_pScript);
 	LPCTSTR const * ppTable = NULL;
 	int iQty = 0;
+	bool fCompile = false;	// precompile the trigger bodies (hot item/char triggers only)
 
 	switch (restype)
 	{
@@ -823,12 +824,14 @@ void CResourceLink::ScanSection( RES_TYPE restype )
 		case RES_ITEMDEF:
 			ppTable = CItem::sm_szTrigName;
 			iQty = ITRIG_QTY;
+			fCompile = true;
 			break;
 		case RES_CHARDEF:
 		case RES_EVENTS:
 		case RES_SKILLCLASS:
 			ppTable = CChar::sm_szTrigName;
 			iQty = CTRIG_QTY;
+			fCompile = true;
 			break;
 		case RES_SKILL:
 			ppTable = CSkillDef::sm_szTrigName;
@@ -857,7 +860,13 @@ void CResourceLink::ScanSection( RES_TYPE restype )
 	}
 	ClearTriggers();
 
-	while ( m_pScript->ReadKey(false))
+	if ( fCompile )
+	{
+		CScriptObj::OnTriggerCompile(*m_pScript);
+		m_pScript->SeekContext(m_Context);
+	}
+
+	for ( CScriptLineContext context = m_pScript->GetContext(); m_pScript->ReadKey(false); context = m_pScript->GetContext() )
 	{
 		if ( m_pScript->IsKeyHead( "DEFNAME", 7 ))
 		{
@@ -882,6 +891,7 @@ void CResourceLink::ScanSection( RES_TYPE restype )
 						DEBUG_ERR(( "Duplicate trigger '%s' in '%s'\n", ppTable[iTrigger], GetResourceName()));
 						continue;
 					}
+					m_TriggerContext[iTrigger] = context;	// remember where it is for ResourceLockTrigger()
 				}
 			}
 			else
@@ -927,6 +937,7 @@ void CResourceLink::CopyTransfer(CResourceLink *pLink)
 	m_pScript = pLink->m_pScript;
 	m_Context = pLink->m_Context;
 	memcpy(m_dwOnTriggers, pLink->m_dwOnTriggers, sizeof(m_dwOnTriggers));
+	m_TriggerContext = pLink->m_TriggerContext;
 	m_lRefInstances = pLink->m_lRefInstances;
 	pLink->m_lRefInstances = 0;	// instance has been transfered.
 }
@@ -935,6 +946,7 @@ void CResourceLink::ClearTriggers()
 {
 	ADDTOCALLSTACK("CResourceLink::ClearTriggers");
 	memset(m_dwOnTriggers, 0, sizeof(m_dwOnTriggers));
+	m_TriggerContext.clear();
 }
 
 void CResourceLink::SetTrigger(int i)
@@ -999,6 +1011,32 @@ bool CResourceLink::ResourceLock( CResourceLock &s )
 	return false;
 }
 
+bool CResourceLink::ResourceLockTrigger( CResourceLock &s, int iTrigger, LPCTSTR pszTrigName )
+{
+	ADDTOCALLSTACK("CResourceLink::ResourceLockTrigger");
+	// Open a locked copy of this script, positioned at the body of the given trigger.
+	// Seek straight to the ON=@ line found by ScanSection, and only search the whole
+	// section if the trigger is not indexed (or the index is for another trigger table).
+	// RETURN: true = found it.
+	if ( !IsLinked() )
+		return false;
+
+	std::map<int, CScriptLineContext>::const_iterator it = m_TriggerContext.find(iTrigger);
+	if (( it != m_TriggerContext.end() ) && ( s.OpenLock(m_pScript, it->second) == 0 ))
+	{
+		if ( s.ReadKey(false) && s.IsKeyHead("ON", 2) )
+		{
+			s.ParseKeyLate();
+			if ( strcmpi(s.GetArgRaw(), pszTrigName) == 0 )
+				return true;
+		}
+	}
+
+	if ( !ResourceLock(s) )
+		return false;
+	return OnTriggerFind(s, pszTrigName);
+}
+
 //***************************************************************************
 //	CScriptFileContext
 
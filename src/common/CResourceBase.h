@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CTime.h"
+#include <map>
 
 enum RES_TYPE	// all the script resource blocks we know how to deal with !
 {
@@ -497,6 +498,7 @@ class CResourceLink : public CResourceDef
 private:
 	CResourceScript * m_pScript;	// we already found the script.
 	CScriptLineContext m_Context;
+	std::map<int, CScriptLineContext> m_TriggerContext;	// trigger -> its ON=@ line, indexed by ScanSection.
 
 	DWORD m_lRefInstances;	// How many CResourceRef objects refer to this ?
 public:
@@ -533,6 +535,7 @@ public:
 	void SetTrigger( int i );
 	bool HasTrigger( int i ) const;
 	bool ResourceLock( CResourceLock & s );
+	bool ResourceLockTrigger( CResourceLock & s, int iTrigger, LPCTSTR pszTrigName );
 
 public:
 	CResourceLink( RESOURCE_ID rid, const CVarDefContNum * pDef = NULL );
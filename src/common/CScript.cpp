@@ -613,3 +613,387 @@ void _cdecl CScript::WriteKeyFormat( LPCTSTR pszKey, LPCTSTR pszVal, ... )
 	va_end( vargs );
 }
 
+
+///////////////////////////////////////////////////////////////
+// -CScriptBinary
+
+// Interned key and section names, shared by all the binary saves.
+// Sectors are serialized on several threads, so the table is locked.
+// Names are never freed, the ids have to stay valid while running.
+static SimpleMutex sm_BinaryKeyLock;
+static std::map<std::string, WORD> sm_BinaryKeyIds;
+static std::vector<LPCTSTR> sm_BinaryKeyNames;
+
+CScriptBinary::CScriptBinary()
+{
+	m_fBinary = false;
+	m_dwKeysDefined = 0;
+	memset(m_KeyCache, 0, sizeof(m_KeyCache));
+}
+
+CScriptBinary::~CScriptBinary()
+{
+	Close();
+}
+
+bool CScriptBinary::IsBinaryFile( LPCTSTR pszFilename ) // static
+{
+	ADDTOCALLSTACK("CScriptBinary::IsBinaryFile");
+	CGFile File;
+	if ( !File.Open(pszFilename, OF_READ|OF_BINARY) )
+		return false;
+
+	char szMagic[4];
+	if ( File.Read(szMagic, sizeof(szMagic)) != sizeof(szMagic) )
+		return false;
+	return( memcmp(szMagic, SCRIPTBIN_MAGIC, sizeof(szMagic)) == 0 );
+}
+
+#ifndef _WIN32
+void CScriptBinary::LockFork( bool fLock ) // static
+{
+	// Held while forking, so no sector thread has the key table locked in the child.
+	if ( fLock )
+		sm_BinaryKeyLock.lock();
+	else
+		sm_BinaryKeyLock.unlock();
+}
+#endif
+
+WORD CScriptBinary::GetKeyId( LPCTSTR pszName )
+{
+	ADDTOCALLSTACK_INTENSIVE("CScriptBinary::GetKeyId");
+	// RETURN: the interned id of the name, SCRIPTBIN_KEY_MAX = not interned.
+	// Keys are mostly string literals, so the cache is indexed by the pointer.
+	KeyCache & cache = m_KeyCache[(reinterpret_cast<size_t>(pszName) >> 2) % COUNTOF(m_KeyCache)];
+	if ( cache.m_pszName && !strcmp(cache.m_pszName, pszName) )
+		return cache.m_wId;
+
+	WORD wId;
+	{
+		SimpleThreadLock lock(sm_BinaryKeyLock);
+		std::map<std::string, WORD>::const_iterator it = sm_BinaryKeyIds.find(pszName);
+		if ( it != sm_BinaryKeyIds.end() )
+		{
+			wId = it->second;
+		}
+		else
+		{
+			size_t iLen = strlen(pszName);
+			if ( sm_BinaryKeyNames.size() >= SCRIPTBIN_KEY_MAX || iLen >= SCRIPT_MAX_LINE_LEN/2 )
+				return SCRIPTBIN_KEY_MAX;
+
+			TCHAR * pszCopy = new TCHAR[iLen + 1];
+			strcpy(pszCopy, pszName);
+			wId = static_cast<WORD>(sm_BinaryKeyNames.size());
+			sm_BinaryKeyNames.push_back(pszCopy);
+			sm_BinaryKeyIds[pszCopy] = wId;
+		}
+		cache.m_pszName = sm_BinaryKeyNames[wId];
+	}
+	cache.m_wId = wId;
+	return wId;
+}
+
+void CScriptBinary::AddBytes( const void * pData, size_t iLen )
+{
+	const BYTE * pBytes = static_cast<const BYTE *>(pData);
+	m_Buffer.insert(m_Buffer.end(), pBytes, pBytes + iLen);
+}
+
+void CScriptBinary::AddWord( WORD wVal )
+{
+	AddByte(static_cast<BYTE>(wVal));
+	AddByte(static_cast<BYTE>(wVal >> 8));
+}
+
+void CScriptBinary::AddDWord( DWORD dwVal )
+{
+	AddWord(static_cast<WORD>(dwVal));
+	AddWord(static_cast<WORD>(dwVal >> 16));
+}
+
+void CScriptBinary::AddRecord( BYTE bType, WORD wId, LPCTSTR pszText, size_t iLen )
+{
+	AddByte(bType);
+	if ( bType != SCRIPTBIN_REC_LINE )
+		AddWord(wId);
+	AddDWord(static_cast<DWORD>(iLen));
+	AddBytes(pszText, iLen);
+}
+
+bool CScriptBinary::ReadBytes( void * pData, size_t iLen )
+{
+	return( PhysicalScriptFile::Read(pData, iLen) == iLen );
+}
+
+bool CScriptBinary::ReadWord( WORD & wVal )
+{
+	BYTE bData[2];
+	if ( !ReadBytes(bData, sizeof(bData)) )
+		return false;
+	wVal = static_cast<WORD>(bData[0] | (bData[1] << 8));
+	return true;
+}
+
+bool CScriptBinary::ReadDWord( DWORD & dwVal )
+{
+	WORD wLow, wHigh;
+	if ( !ReadWord(wLow) || !ReadWord(wHigh) )
+		return false;
+	dwVal = static_cast<DWORD>(wLow) | (static_cast<DWORD>(wHigh) << 16);
+	return true;
+}
+
+bool CScriptBinary::ReadText( TCHAR * pszText, DWORD dwLen, size_t iMax )
+{
+	// Read dwLen chars, only keep what fits in iMax like a text line would.
+	size_t iRead = minimum(static_cast<size_t>(dwLen), iMax);
+	if ( !ReadBytes(pszText, iRead) )
+		return false;
+	pszText[iRead] = '\0';
+	if ( iRead < dwLen )
+		PhysicalScriptFile::Seek(static_cast<LONG>(dwLen - iRead), SEEK_CUR);
+	return true;
+}
+
+bool CScriptBinary::Open( LPCTSTR pszFilename, UINT wFlags )
+{
+	ADDTOCALLSTACK("CScriptBinary::Open");
+	if ( !m_fBinary )
+		return CScript::Open(pszFilename, wFlags);
+
+	// never cached, the records are read straight from the file.
+	if ( !CScript::Open(pszFilename, wFlags|OF_DEFAULTMODE) )
+		return false;
+
+	m_Buffer.clear();
+	m_dwKeysDefined = 0;
+	m_KeyNames.clear();
+
+	if ( IsWriteMode() )
+	{
+		AddBytes(SCRIPTBIN_MAGIC, 4);
+		AddDWord(SCRIPTBIN_VERSION);
+		PhysicalScriptFile::Write(&m_Buffer[0], static_cast<DWORD>(m_Buffer.size()));
+		m_Buffer.clear();
+		return true;
+	}
+
+	char szMagic[4];
+	DWORD dwVersion = 0;
+	if ( !ReadBytes(szMagic, sizeof(szMagic)) || memcmp(szMagic, SCRIPTBIN_MAGIC, sizeof(szMagic)) || !ReadDWord(dwVersion) )
+	{
+		g_Log.Event(LOGL_ERROR, "'%s' is not a binary save\n", static_cast<LPCTSTR>(GetFilePath()));
+		CScript::Close();
+		return false;
+	}
+	if ( dwVersion > SCRIPTBIN_VERSION )
+	{
+		g_Log.Event(LOGL_ERROR, "'%s' is a binary save of version %lu, this build reads up to version %d\n", static_cast<LPCTSTR>(GetFilePath()), dwVersion, SCRIPTBIN_VERSION);
+		CScript::Close();
+		return false;
+	}
+	return true;
+}
+
+void CScriptBinary::Close()
+{
+	ADDTOCALLSTACK("CScriptBinary::Close");
+	if ( m_fBinary && IsFileOpen() && IsWriteMode() )
+		FlushBlock();
+	CScript::Close();
+}
+
+bool CScriptBinary::ReadTextLine( bool fRemoveBlanks )
+{
+	ADDTOCALLSTACK("CScriptBinary::ReadTextLine");
+	if ( !m_fBinary )
+		return CScript::ReadTextLine(fRemoveBlanks);
+
+	// Give the records back as the lines of the text file.
+	TCHAR * pszLine = GetKeyBufferRaw(SCRIPT_MAX_LINE_LEN);
+	BYTE bType;
+	while ( ReadBytes(&bType, 1) )
+	{
+		WORD wId = 0;
+		DWORD dwLen = 0;
+		switch ( bType )
+		{
+			case SCRIPTBIN_REC_KEYDEF:
+				{
+					WORD wLen = 0;
+					if ( !ReadWord(wId) || !ReadWord(wLen) || !ReadText(pszLine, wLen, SCRIPT_MAX_LINE_LEN/2) )
+						goto corrupt;
+					if ( m_KeyNames.size() <= wId )
+						m_KeyNames.resize(wId + 1);
+					m_KeyNames[wId] = pszLine;
+				}
+				continue;
+
+			case SCRIPTBIN_REC_BLOCK:
+				// the records of the block just follow.
+				if ( !ReadDWord(dwLen) )
+					goto corrupt;
+				continue;
+
+			case SCRIPTBIN_REC_SECTION:
+			case SCRIPTBIN_REC_KEY:
+				{
+					if ( !ReadWord(wId) || !ReadDWord(dwLen) || wId >= m_KeyNames.size() || m_KeyNames[wId].IsEmpty() )
+						goto corrupt;
+
+					size_t iLen;
+					if ( bType == SCRIPTBIN_REC_SECTION )
+						iLen = sprintf(pszLine, dwLen ? "[%s " : "[%s", static_cast<LPCTSTR>(m_KeyNames[wId]));
+					else
+						iLen = sprintf(pszLine, "%s=", static_cast<LPCTSTR>(m_KeyNames[wId]));
+
+					if ( !ReadText(pszLine + iLen, dwLen, SCRIPT_MAX_LINE_LEN - iLen - 1) )
+						goto corrupt;
+					if ( bType == SCRIPTBIN_REC_SECTION )
+						strcat(pszLine, "]");
+				}
+				break;
+
+			case SCRIPTBIN_REC_LINE:
+				if ( !ReadDWord(dwLen) || !ReadText(pszLine, dwLen, SCRIPT_MAX_LINE_LEN) )
+					goto corrupt;
+				break;
+
+			default:
+				goto corrupt;
+		}
+
+		m_iLineNum++;
+		if ( fRemoveBlanks )
+		{
+			if ( ParseKeyEnd() <= 0 )
+				continue;
+		}
+		return( true );
+	}
+
+	m_pszKey[0] = '\0';
+	return( false );
+
+corrupt:
+	g_Log.Event(LOGL_ERROR, "'%s' bad binary record at offset %lu, record %d\n", static_cast<LPCTSTR>(GetFilePath()), static_cast<DWORD>(GetPosition()), m_iLineNum);
+	m_pszKey[0] = '\0';
+	return( false );
+}
+
+bool _cdecl CScriptBinary::WriteSection( LPCTSTR pszSection, ... )
+{
+	ADDTOCALLSTACK_INTENSIVE("CScriptBinary::WriteSection");
+	TemporaryString pszTemp;
+	va_list vargs;
+	va_start( vargs, pszSection );
+	_vsnprintf(pszTemp, pszTemp.realLength(), pszSection, vargs);
+	va_end( vargs );
+
+	if ( !m_fBinary )
+		return CScript::WriteSection("%s", static_cast<LPCTSTR>(pszTemp));
+
+	// [NAME args]
+	TCHAR * pszName = pszTemp;
+	TCHAR * pszArgs = strchr(pszName, ' ');
+	if ( pszArgs != NULL )
+		*pszArgs = '\0';
+
+	WORD wId = GetKeyId(pszName);
+	if ( pszArgs != NULL )
+		*pszArgs++ = ' ';
+	else
+		pszArgs = pszName + strlen(pszName);
+
+	if ( wId == SCRIPTBIN_KEY_MAX )
+	{
+		TemporaryString pszLine;
+		sprintf(pszLine, "[%s]", pszName);
+		AddRecord(SCRIPTBIN_REC_LINE, 0, pszLine, strlen(pszLine));
+		return( true );
+	}
+
+	AddRecord(SCRIPTBIN_REC_SECTION, wId, pszArgs, strlen(pszArgs));
+	return( true );
+}
+
+bool CScriptBinary::WriteKey( LPCTSTR pszKey, LPCTSTR pszVal )
+{
+	ADDTOCALLSTACK_INTENSIVE("CScriptBinary::WriteKey");
+	if ( !m_fBinary )
+		return CScript::WriteKey(pszKey, pszVal);
+
+	if ( pszKey == NULL || pszKey[0] == '\0' )
+		return false;
+
+	if ( pszVal == NULL || pszVal[0] == '\0' )
+	{
+		// Books are like this. No real keys.
+		size_t iLen = strcspn(pszKey, "\r\n");
+		if ( pszKey[iLen] != '\0' )
+			g_Log.Event( LOGL_WARN|LOGM_CHEAT, "carriage return in key (book?) - truncating\n" );
+		AddRecord(SCRIPTBIN_REC_LINE, 0, pszKey, iLen);
+		return( true );
+	}
+
+	size_t iLen = strcspn(pszVal, "\r\n");
+	if ( pszVal[iLen] != '\0' )
+		g_Log.Event( LOGL_WARN|LOGM_CHEAT, "carriage return in key value - truncating\n" );
+
+	WORD wId = GetKeyId(pszKey);
+	if ( wId == SCRIPTBIN_KEY_MAX )
+	{
+		TemporaryString pszLine;
+		size_t iMax = static_cast<size_t>(pszLine.realLength());
+		size_t iLineLen = strcpylen(pszLine, pszKey, iMax / 2);
+		pszLine.setAt(static_cast<int>(iLineLen++), '=');
+		iLineLen += strcpylen(static_cast<TCHAR *>(pszLine) + iLineLen, pszVal, minimum(iLen + 1, iMax - iLineLen));
+		AddRecord(SCRIPTBIN_REC_LINE, 0, pszLine, iLineLen);
+		return( true );
+	}
+
+	AddRecord(SCRIPTBIN_REC_KEY, wId, pszVal, iLen);
+	return( true );
+}
+
+void CScriptBinary::FlushBlock()
+{
+	ADDTOCALLSTACK("CScriptBinary::FlushBlock");
+	// Write the records collected so far to the file, as one block.
+	if ( !m_fBinary || m_Buffer.empty() || !IsFileOpen() )
+		return;
+
+	std::vector<BYTE> block;
+	block.swap(m_Buffer);
+
+	// Keys interned since the previous block have to be defined first.
+	{
+		SimpleThreadLock lock(sm_BinaryKeyLock);
+		for ( ; m_dwKeysDefined < sm_BinaryKeyNames.size(); m_dwKeysDefined++ )
+		{
+			LPCTSTR pszName = sm_BinaryKeyNames[m_dwKeysDefined];
+			size_t iLen = strlen(pszName);
+			AddByte(SCRIPTBIN_REC_KEYDEF);
+			AddWord(static_cast<WORD>(m_dwKeysDefined));
+			AddWord(static_cast<WORD>(iLen));
+			AddBytes(pszName, iLen);
+		}
+	}
+	AddByte(SCRIPTBIN_REC_BLOCK);
+	AddDWord(static_cast<DWORD>(block.size()));
+
+	PhysicalScriptFile::Write(&m_Buffer[0], static_cast<DWORD>(m_Buffer.size()));
+	PhysicalScriptFile::Write(&block[0], static_cast<DWORD>(block.size()));
+	m_Buffer.clear();
+}
+
+void CScriptBinary::WriteBlock( CScriptBinary & s )
+{
+	ADDTOCALLSTACK("CScriptBinary::WriteBlock");
+	// Append the records collected by s (without a file) as a block of this file.
+	FlushBlock();
+	m_Buffer.swap(s.m_Buffer);
+	FlushBlock();
+}
@@ -162,6 +162,19 @@ public:
 	virtual bool ReadTextLine( bool fRemoveBlanks );	// looking for a section or reading strangly formated section.
 	bool FindTextHeader( LPCTSTR pszName ); // Find a section in the current script
 
+#ifdef _NOSCRIPTCACHE
+	// compiled script lines are kept only with the script cache.
+	bool InitCompiledLines()
+	{
+		return false;
+	}
+	CScriptCompiledLine * GetCompiledLine( DWORD dwLine ) const
+	{
+		UNREFERENCED_PARAMETER(dwLine);
+		return NULL;
+	}
+#endif
+
 public:
 	virtual bool Open( LPCTSTR szFilename = NULL, UINT Flags = OF_READ|OF_TEXT );
 	virtual void Close();
@@ -205,8 +218,8 @@ public:
 	bool ReadKeyParse();
 
 	// Write stuff out to a script file.
-	bool _cdecl WriteSection( LPCTSTR pszSection, ... ) __printfargs(2,3);
-	bool WriteKey( LPCTSTR pszKey, LPCTSTR pszVal );
+	virtual bool _cdecl WriteSection( LPCTSTR pszSection, ... ) __printfargs(2,3);
+	virtual bool WriteKey( LPCTSTR pszKey, LPCTSTR pszVal );
 	void _cdecl WriteKeyFormat( LPCTSTR pszKey, LPCTSTR pszFormat, ... ) __printfargs(3,4);
 
 	void WriteKeyVal( LPCTSTR pszKey, INT64 dwVal )
@@ -234,4 +247,92 @@ public:
 	}
 };
 
+// Binary saves. (SaveBinary)
+#define SCRIPTBIN_MAGIC		"SPHB"
+#define SCRIPTBIN_VERSION	1
+#define SCRIPTBIN_KEY_MAX	0xFFFF	// keys past this are not interned, but written as plain lines.
+
+enum SCRIPTBIN_REC_TYPE
+{
+	// Each record starts with its type BYTE, fields are little endian.
+	SCRIPTBIN_REC_KEYDEF = 1,	// WORD id, WORD len, name. Defines an interned key before it is used.
+	SCRIPTBIN_REC_SECTION,		// WORD id, DWORD len, args. = [NAME args]
+	SCRIPTBIN_REC_KEY,			// WORD id, DWORD len, value. = NAME=value
+	SCRIPTBIN_REC_LINE,			// DWORD len, text. Lines without a value. (books)
+	SCRIPTBIN_REC_BLOCK,		// DWORD len. The records of one sector, or of anything written in between.
+	SCRIPTBIN_REC_QTY
+};
+
+class CScriptBinary : public CScript
+{
+	// A script file written as length prefixed records instead of text.
+	// Section and key names are interned, the values are kept as they would be in the text file.
+	// The records are read back as text lines, so everything loading a CScript can load it.
+	// Behaves as a plain CScript until SetBinary().
+	// Without an open file it just collects the records, see WriteBlock().
+private:
+	struct KeyCache
+	{
+		LPCTSTR m_pszName;	// interned name.
+		WORD m_wId;
+	};
+
+	bool m_fBinary;
+	std::vector<BYTE> m_Buffer;			// records not written to the file yet.
+	DWORD m_dwKeysDefined;				// interned keys already defined in the file.
+	std::vector<CGString> m_KeyNames;	// keys defined in the file being read.
+	KeyCache m_KeyCache[64];			// recent keys, saves locking the shared key table.
+
+public:
+	static const char *m_sClassName;
+
+private:
+	WORD GetKeyId( LPCTSTR pszName );
+	void AddBytes( const void * pData, size_t iLen );
+	void AddByte( BYTE bVal )
+	{
+		m_Buffer.push_back(bVal);
+	}
+	void AddWord( WORD wVal );
+	void AddDWord( DWORD dwVal );
+	void AddRecord( BYTE bType, WORD wId, LPCTSTR pszText, size_t iLen );
+
+	bool ReadBytes( void * pData, size_t iLen );
+	bool ReadWord( WORD & wVal );
+	bool ReadDWord( DWORD & dwVal );
+	bool ReadText( TCHAR * pszText, DWORD dwLen, size_t iMax );
+
+public:
+	void SetBinary( bool fBinary )
+	{
+		// before Open()
+		m_fBinary = fBinary;
+	}
+	virtual bool IsBinaryMode() const
+	{
+		return m_fBinary;
+	}
+	static bool IsBinaryFile( LPCTSTR pszFilename );
+#ifndef _WIN32
+	static void LockFork( bool fLock );	// around fork() (SaveFork)
+#endif
+
+	virtual bool Open( LPCTSTR pszFilename = NULL, UINT Flags = OF_READ|OF_TEXT );
+	virtual void Close();
+	virtual bool ReadTextLine( bool fRemoveBlanks );
+
+	virtual bool _cdecl WriteSection( LPCTSTR pszSection, ... ) __printfargs(2,3);
+	virtual bool WriteKey( LPCTSTR pszKey, LPCTSTR pszVal );
+	void FlushBlock();
+	void WriteBlock( CScriptBinary & s );
+
+public:
+	CScriptBinary();
+	virtual ~CScriptBinary();
+
+private:
+	CScriptBinary(const CScriptBinary& copy);
+	CScriptBinary& operator=(const CScriptBinary& other);
+};
+
 #endif // _INC_CSCRIPT_H
@@ -508,6 +508,7 @@ bool CScriptObj::r_Call( LPCTSTR pszFunction, CTextConsole * pSrc, CScriptTrigge
 	CResourceLock sFunction;
 	if ( pFunction->ResourceLock(sFunction) )
 	{
+		ProfileScope functionScope(pFunction->GetName());
 		TScriptProfiler::TScriptProfilerFunction *pFun = NULL;
 		ULONGLONG llTicksStart, llTicksEnd;
 
@@ -1882,7 +1883,7 @@ TRIGRET_TYPE CScriptObj::OnTriggerForLoop( CScript &s, int iType, CTextConsole *
 					break;
 
 				// Acquire the object with this UID and check it exists
-				CObjBase * pObj = g_World.FindUID( dwUID );
+				CObjBase * pObj = g_World.FindUIDSlot( dwUID );
 				if ( pObj == NULL )
 					continue;
 
@@ -1982,6 +1983,27 @@ TRIGRET_TYPE CScriptObj::OnTriggerScript( CScript & s, LPCTSTR pszTrigName, CTex
 	if ( !OnTriggerFind(s, pszTrigName) )
 		return TRIGRET_RET_DEFAULT;
 
+	ProfileScope scriptScope(pszTrigName, s.GetFileTitle());
+	return OnTriggerScriptRun(s, pszTrigName, pSrc, pArgs);
+}
+
+TRIGRET_TYPE CScriptObj::OnTriggerScript( CResourceLink * pLink, int iTrigger, LPCTSTR pszTrigName, CTextConsole * pSrc, CScriptTriggerArgs * pArgs )
+{
+	ADDTOCALLSTACK("CScriptObj::OnTriggerScript");
+	// Same as above, but let the resource seek straight to its trigger.
+	ASSERT(pLink);
+	CResourceLock s;
+	if ( !pLink->ResourceLockTrigger(s, iTrigger, pszTrigName) )
+		return TRIGRET_RET_DEFAULT;
+
+	ProfileScope scriptScope(pszTrigName, pLink->GetResourceName());
+	return OnTriggerScriptRun(s, pszTrigName, pSrc, pArgs);
+}
+
+TRIGRET_TYPE CScriptObj::OnTriggerScriptRun( CScript & s, LPCTSTR pszTrigName, CTextConsole * pSrc, CScriptTriggerArgs * pArgs )
+{
+	ADDTOCALLSTACK("CScriptObj::OnTriggerScriptRun");
+	// The trigger header has been read, run its body.
 	ProfileTask scriptsTask(PROFILE_SCRIPTS);
 
 	TScriptProfiler::TScriptProfilerTrigger	*pTrig = NULL;
@@ -2123,11 +2145,198 @@ LPCTSTR const CScriptObj::sm_szScriptKeys[SK_QTY+1] =
 	NULL
 };
 
+// Extra keyword marks only used while compiling a section.
+#define SCRIPTKEY_TRIGGER	-3	// "ON=@Trigger", ends the block being read
+#define SCRIPTKEY_END		-4	// next [SECTION] header or end of file
+
+struct CScriptCompileLine
+{
+	DWORD m_dwLine;		// position of the line in the script file
+	short m_iKeyword;	// SK_TYPE or one of the SCRIPTKEY_* marks
+};
+
+static int OnTriggerCompileSkip( const std::vector<CScriptCompileLine> & vLines, size_t iStart, std::vector<int> & vSkipEnd, std::vector<BYTE> & vSkipRet )
+{
+	// Follow what OnTriggerRun(TRIGRUN_SECTION_FALSE) reads when started at line iStart.
+	// RETURN: index of the line that ends the block (its TRIGRET_TYPE is kept in vSkipRet[iStart])
+	//  -1 = the block runs past the end of the section, leave it to the interpreter.
+	if ( iStart >= vLines.size() )
+		return -1;
+	if ( vSkipEnd[iStart] != -2 )
+		return vSkipEnd[iStart];
+
+	int iEnd = -1;
+	TRIGRET_TYPE iRet = TRIGRET_RET_DEFAULT;
+	size_t i = iStart;
+	while ( (iEnd < 0) && (i < vLines.size()) )
+	{
+		switch ( vLines[i].m_iKeyword )
+		{
+			case SCRIPTKEY_END:
+			case SCRIPTKEY_TRIGGER:
+				iEnd = static_cast<int>(i);
+				iRet = TRIGRET_RET_DEFAULT;
+				break;
+			case SK_ENDIF:
+			case SK_END:
+			case SK_ENDDO:
+			case SK_ENDFOR:
+			case SK_ENDRAND:
+			case SK_ENDSWITCH:
+			case SK_ENDWHILE:
+				iEnd = static_cast<int>(i);
+				iRet = TRIGRET_ENDIF;
+				break;
+			case SK_ELIF:
+			case SK_ELSEIF:
+				iEnd = static_cast<int>(i);
+				iRet = TRIGRET_ELSEIF;
+				break;
+			case SK_ELSE:
+				iEnd = static_cast<int>(i);
+				iRet = TRIGRET_ELSE;
+				break;
+			case SK_IF:
+				{
+					size_t j = i + 1;
+					for (;;)
+					{
+						int iSub = OnTriggerCompileSkip(vLines, j, vSkipEnd, vSkipRet);
+						if ( iSub < 0 )
+						{
+							vSkipEnd[iStart] = -1;
+							return -1;
+						}
+						BYTE bSubRet = vSkipRet[j];
+						j = static_cast<size_t>(iSub) + 1;
+						if ( bSubRet != TRIGRET_ELSEIF && bSubRet != TRIGRET_ELSE )
+							break;
+					}
+					i = j;
+				}
+				break;
+			case SK_WHILE:
+			case SK_FOR:
+			case SK_FORCHARLAYER:
+			case SK_FORCHARMEMORYTYPE:
+			case SK_FORCHAR:
+			case SK_FORCLIENTS:
+			case SK_FORCONT:
+			case SK_FORCONTID:
+			case SK_FORCONTTYPE:
+			case SK_FORINSTANCE:
+			case SK_FORITEM:
+			case SK_FOROBJ:
+			case SK_FORPLAYERS:
+			case SK_FORTIMERF:
+			case SK_DORAND:
+			case SK_DOSWITCH:
+			case SK_BEGIN:
+				{
+					int iSub = OnTriggerCompileSkip(vLines, i + 1, vSkipEnd, vSkipRet);
+					if ( iSub < 0 )
+					{
+						vSkipEnd[iStart] = -1;
+						return -1;
+					}
+					i = static_cast<size_t>(iSub) + 1;
+				}
+				break;
+			default:
+				++i;
+				break;
+		}
+	}
+
+	vSkipEnd[iStart] = iEnd;
+	vSkipRet[iStart] = static_cast<BYTE>(iRet);
+	return iEnd;
+}
+
+void CScriptObj::OnTriggerCompile( CScript & s )
+{
+	ADDTOCALLSTACK("CScriptObj::OnTriggerCompile");
+	// Compile the rest of the current section (called at resource load/resync).
+	// Each line gets its script keyword pre-resolved, and each line that opens a block
+	// (IF/ELIF/ELSE/WHILE/FOR.../BEGIN/DORAND/DOSWITCH) gets the line where that block
+	// ends when it is not executed, so OnTriggerRun can jump there instead of reading it.
+	// NOTE: the script is left at the end of the section, as ReadKeyParse() would.
+	if ( !s.InitCompiledLines() )
+		return;
+
+	std::vector<CScriptCompileLine> vLines;
+	for (;;)
+	{
+		CScriptCompileLine line;
+		line.m_dwLine = s.GetPosition();
+		if ( !s.ReadKeyParse() )
+		{
+			line.m_iKeyword = SCRIPTKEY_END;
+			vLines.push_back(line);
+			break;
+		}
+
+		line.m_dwLine = s.GetPosition() - 1;
+		if ( s.IsKeyHead("ON", 2) )
+			line.m_iKeyword = SCRIPTKEY_TRIGGER;
+		else
+			line.m_iKeyword = static_cast<short>(FindTableSorted(s.GetKey(), sm_szScriptKeys, COUNTOF(sm_szScriptKeys) - 1));
+		vLines.push_back(line);
+	}
+
+	std::vector<int> vSkipEnd(vLines.size(), -2);
+	std::vector<BYTE> vSkipRet(vLines.size(), TRIGRET_RET_DEFAULT);
+	for ( size_t i = 0; i + 1 < vLines.size(); ++i )
+	{
+		CScriptCompiledLine * pLine = s.GetCompiledLine(vLines[i].m_dwLine);
+		if ( pLine == NULL )
+			continue;
+
+		pLine->m_iKeyword = (vLines[i].m_iKeyword == SCRIPTKEY_TRIGGER) ? -1 : vLines[i].m_iKeyword;
+		pLine->m_dwSkipLine = SCRIPTLINE_NOSKIP;
+		switch ( vLines[i].m_iKeyword )
+		{
+			case SK_IF:
+			case SK_ELIF:
+			case SK_ELSEIF:
+			case SK_ELSE:
+			case SK_WHILE:
+			case SK_FOR:
+			case SK_FORCHARLAYER:
+			case SK_FORCHARMEMORYTYPE:
+			case SK_FORCHAR:
+			case SK_FORCLIENTS:
+			case SK_FORCONT:
+			case SK_FORCONTID:
+			case SK_FORCONTTYPE:
+			case SK_FORINSTANCE:
+			case SK_FORITEM:
+			case SK_FOROBJ:
+			case SK_FORPLAYERS:
+			case SK_FORTIMERF:
+			case SK_DORAND:
+			case SK_DOSWITCH:
+			case SK_BEGIN:
+				{
+					int iEnd = OnTriggerCompileSkip(vLines, i + 1, vSkipEnd, vSkipRet);
+					if ( iEnd < 0 )
+						break;
+					pLine->m_dwSkipLine = vLines[iEnd].m_dwLine;
+					pLine->m_bSkipRet = vSkipRet[i + 1];
+				}
+				break;
+			default:
+				break;
+		}
+	}
+}
+
 
 
 TRIGRET_TYPE CScriptObj::OnTriggerRun( CScript &s, TRIGRUN_TYPE trigrun, CTextConsole * pSrc, CScriptTriggerArgs * pArgs, CGString * pResult )
 {
 	ADDTOCALLSTACK("CScriptObj::OnTriggerRun");
+	CSectorTickLock lock;	// scripts share too much to run in parallel
 	// ARGS:
 	//	TRIGRUN_SECTION_SINGLE = just this 1 line.
 	// RETURN:
@@ -2147,8 +2356,31 @@ TRIGRET_TYPE CScriptObj::OnTriggerRun( CScript &s, TRIGRUN_TYPE trigrun, CTextCo
 	EXC_TRY("TriggerRun");
 
 	bool fSectionFalse = (trigrun == TRIGRUN_SECTION_FALSE || trigrun == TRIGRUN_SINGLE_FALSE);
+	const CScriptCompiledLine * pLine;
+	SK_TYPE iCmd;
 	if ( trigrun == TRIGRUN_SECTION_EXEC || trigrun == TRIGRUN_SINGLE_EXEC )	// header was already read in.
+	{
+		iCmd = static_cast<SK_TYPE>(FindTableSorted( s.GetKey(), sm_szScriptKeys, COUNTOF( sm_szScriptKeys )-1 ));
 		goto jump_in;
+	}
+
+	if ( trigrun == TRIGRUN_SECTION_FALSE )
+	{
+		// The compiler already knows where this block ends, skip straight to that line.
+		DWORD dwPos = s.GetPosition();
+		pLine = s.GetCompiledLine( dwPos - 1 );
+		if ( pLine && ( pLine->m_dwSkipLine != SCRIPTLINE_NOSKIP ))
+		{
+			EXC_SET("skip compiled block");
+			CScriptLineContext context;
+			context.m_lOffset = static_cast<long>(pLine->m_dwSkipLine);
+			context.m_iLineNum = s.m_iLineNum + static_cast<int>(pLine->m_dwSkipLine - dwPos);
+			TRIGRET_TYPE iSkipRet = static_cast<TRIGRET_TYPE>(pLine->m_bSkipRet);
+			s.SeekContext( context );
+			s.ReadKeyParse();	// the line ending the block is read, as if we got here line by line.
+			return( iSkipRet );
+		}
+	}
 
 	EXC_SET("parsing");
 	while ( s.ReadKeyParse())
@@ -2157,8 +2389,13 @@ TRIGRET_TYPE CScriptObj::OnTriggerRun( CScript &s, TRIGRUN_TYPE trigrun, CTextCo
 		if ( s.IsKeyHead( "ON", 2 ))	// done with this section.
 			break;
 
+		pLine = s.GetCompiledLine( s.GetPosition() - 1 );
+		if ( pLine && ( pLine->m_iKeyword != SCRIPTLINE_UNCOMPILED ))
+			iCmd = static_cast<SK_TYPE>(pLine->m_iKeyword);
+		else
+			iCmd = static_cast<SK_TYPE>(FindTableSorted( s.GetKey(), sm_szScriptKeys, COUNTOF( sm_szScriptKeys )-1 ));
+
 jump_in:
-		SK_TYPE iCmd = (SK_TYPE) FindTableSorted( s.GetKey(), sm_szScriptKeys, COUNTOF( sm_szScriptKeys )-1 );
 		TRIGRET_TYPE iRet = TRIGRET_RET_DEFAULT;
 
 		switch ( iCmd )
@@ -6,6 +6,7 @@
 	#include "../sphere/threads.h"
 
 	class CChar;
+	class CResourceLink;
 	class CScriptTriggerArgs;
 	class CScriptObj;
 
@@ -97,9 +98,11 @@
 
 	private:
 		TRIGRET_TYPE OnTriggerForLoop( CScript &s, int iType, CTextConsole * pSrc, CScriptTriggerArgs * pArgs, CGString * pResult );
+		TRIGRET_TYPE OnTriggerScriptRun( CScript &s, LPCTSTR pszTrigName, CTextConsole * pSrc, CScriptTriggerArgs * pArgs );
 	public:
 		static const char *m_sClassName;
 		TRIGRET_TYPE OnTriggerScript( CScript &s, LPCTSTR pszTrigName, CTextConsole * pSrc, CScriptTriggerArgs * pArgs = NULL );
+		TRIGRET_TYPE OnTriggerScript( CResourceLink * pLink, int iTrigger, LPCTSTR pszTrigName, CTextConsole * pSrc, CScriptTriggerArgs * pArgs = NULL );
 		virtual TRIGRET_TYPE OnTrigger( LPCTSTR pszTrigName, CTextConsole * pSrc, CScriptTriggerArgs * pArgs = NULL )
 		{
 			UNREFERENCED_PARAMETER(pszTrigName);
@@ -108,6 +111,7 @@
 			return( TRIGRET_RET_DEFAULT );
 		}
 		bool OnTriggerFind( CScript & s, LPCTSTR pszTrigName );
+		static void OnTriggerCompile( CScript & s );
 		TRIGRET_TYPE OnTriggerRun( CScript &s, TRIGRUN_TYPE trigger, CTextConsole * pSrc, CScriptTriggerArgs * pArgs, CGString * pReturn );
 		TRIGRET_TYPE OnTriggerRunVal( CScript &s, TRIGRUN_TYPE trigger, CTextConsole * pSrc, CScriptTriggerArgs * pArgs );
 
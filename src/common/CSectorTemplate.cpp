@@ -1,6 +1,142 @@
 #include "../graysvr/graysvr.h"
 #include <algorithm>
 
+////////////////////////////////////////////////////////////////////////
+// -CSectorIndexCell
+
+void CSectorIndexCell::Add( CObjBaseTemplate * pObj )
+{
+	ADDTOCALLSTACK("CSectorIndexCell::Add");
+	ASSERT( pObj->m_pIndexCell == NULL );
+	CSectorIndexPos pos;
+	pos.m_x = static_cast<WORD>(pObj->m_pt.m_x);
+	pos.m_y = static_cast<WORD>(pObj->m_pt.m_y);
+
+	size_t iSlot;
+	if ( !m_Free.empty() )
+	{
+		iSlot = m_Free.back();
+		m_Free.pop_back();
+		m_Pos[iSlot] = pos;
+		m_Obj[iSlot] = pObj;
+	}
+	else
+	{
+		iSlot = m_Obj.size();
+		m_Pos.push_back(pos);
+		m_Obj.push_back(pObj);
+	}
+	pObj->m_pIndexCell = this;
+	pObj->m_iIndexSlot = iSlot;
+}
+
+void CSectorIndexCell::Remove( CObjBaseTemplate * pObj )
+{
+	ADDTOCALLSTACK("CSectorIndexCell::Remove");
+	ASSERT( pObj->m_pIndexCell == this );
+	size_t iSlot = pObj->m_iIndexSlot;
+	pObj->m_pIndexCell = NULL;
+
+	if ( m_Free.size() + 1 >= m_Obj.size() )
+	{
+		// Last one out, scans of this cell just end here.
+		m_Pos.clear();
+		m_Obj.clear();
+		m_Free.clear();
+		return;
+	}
+	m_Pos[iSlot].m_x = m_Pos[iSlot].m_y = 0xFFFF;
+	m_Obj[iSlot] = NULL;
+	m_Free.push_back(iSlot);
+}
+
+void CSectorIndexCell::Update( CObjBaseTemplate * pObj )
+{
+	ADDTOCALLSTACK_INTENSIVE("CSectorIndexCell::Update");
+	// The top point of pObj changed.
+	ASSERT( pObj->m_pIndexCell == this );
+	CSectorIndexCell * pCell = m_pList->GetCellAt(pObj->m_pt);
+	if ( pCell != this )
+	{
+		Remove(pObj);
+		pCell->Add(pObj);
+		return;
+	}
+	CSectorIndexPos & pos = m_Pos[pObj->m_iIndexSlot];
+	pos.m_x = static_cast<WORD>(pObj->m_pt.m_x);
+	pos.m_y = static_cast<WORD>(pObj->m_pt.m_y);
+}
+
+////////////////////////////////////////////////////////////////////////
+// -CSectorObjList
+
+CSectorObjList::CSectorObjList()
+{
+	m_pSector = NULL;
+	m_pCells = NULL;
+	m_iBaseX = 0;
+	m_iBaseY = 0;
+	m_iCellCols = 1;
+}
+
+CSectorObjList::~CSectorObjList()
+{
+	// Objects still here are deleted by CGObList, don't let them point at the cells.
+	for ( CGObListRec * pRec = GetHead(); pRec != NULL; pRec = pRec->GetNext() )
+	{
+		CObjBaseTemplate * pObj = static_cast<CObjBaseTemplate *>(pRec);
+		if ( pObj->m_pIndexCell )
+			pObj->m_pIndexCell->Remove(pObj);
+	}
+	delete[] m_pCells;
+}
+
+void CSectorObjList::InitIndex( CSectorBase * pSector, const CPointBase & ptBase, int iSectorSize )
+{
+	ADDTOCALLSTACK("CSectorObjList::InitIndex");
+	m_pSector = pSector;
+	if ( m_pCells != NULL )
+		return;
+	m_iBaseX = ptBase.m_x;
+	m_iBaseY = ptBase.m_y;
+	m_iCellCols = maximum(1, (iSectorSize + (1 << SECTOR_INDEX_CELL_SHIFT) - 1) >> SECTOR_INDEX_CELL_SHIFT);
+}
+
+CSectorIndexCell * CSectorObjList::GetCellAt( const CPointBase & pt )
+{
+	ADDTOCALLSTACK("CSectorObjList::GetCellAt");
+	if ( m_pCells == NULL )
+	{
+		size_t iQty = static_cast<size_t>(m_iCellCols * m_iCellCols);
+		m_pCells = new CSectorIndexCell[iQty];
+		for ( size_t i = 0; i < iQty; ++i )
+			m_pCells[i].m_pList = this;
+	}
+	return &m_pCells[(GetCellRow(pt.m_y) * m_iCellCols) + GetCellCol(pt.m_x)];
+}
+
+void CSectorObjList::OnRemoveOb( CGObListRec * pObRec )
+{
+	ADDTOCALLSTACK("CSectorObjList::OnRemoveOb");
+	// Override this = called when removed from list.
+	CObjBaseTemplate * pObj = static_cast<CObjBaseTemplate *>(pObRec);
+	ASSERT(pObj);
+	if ( pObj->m_pIndexCell )
+		pObj->m_pIndexCell->Remove(pObj);
+	CGObList::OnRemoveOb(pObRec);
+}
+
+void CSectorObjList::InsertAfter( CGObListRec * pNewRec, CGObListRec * pPrev )
+{
+	ADDTOCALLSTACK("CSectorObjList::InsertAfter");
+	CGObList::InsertAfter(pNewRec, pPrev);	// removes it from the previous list (and cell) first
+	if ( g_Cfg.m_fSectorGrid )
+	{
+		CObjBaseTemplate * pObj = static_cast<CObjBaseTemplate *>(pNewRec);
+		GetCellAt(pObj->GetTopPoint())->Add(pObj);
+	}
+}
+
 ////////////////////////////////////////////////////////////////////////
 // -CCharsActiveList
 
@@ -18,10 +154,10 @@ void CCharsActiveList::OnRemoveOb( CGObListRec * pObRec )
 	ASSERT(pChar);
 	if ( pChar->m_pClient )
 	{
-		ClientDetach();
+		ClientDetach(pChar);
 		m_timeLastClient = CServTime::GetCurrentTime();	// mark time in case it's the last client
 	}
-	CGObList::OnRemoveOb(pObRec);
+	CSectorObjList::OnRemoveOb(pObRec);
 	pChar->SetContainerFlags(UID_O_DISCONNECT);
 }
 
@@ -31,58 +167,119 @@ void CCharsActiveList::AddCharToSector( CChar * pChar )
 	ASSERT( pChar );
 	// ASSERT( pChar->m_pt.IsValid());
 	if ( pChar->m_pClient )
-		ClientAttach();
+		ClientAttach(pChar);
 	CGObList::InsertHead(pChar);
 }
 
-void CCharsActiveList::ClientAttach()
+void CCharsActiveList::ClientAttach( CChar * pChar )
 {
 	ADDTOCALLSTACK("CCharsActiveList::ClientAttach");
 	m_iClients++;
+	m_ClientChars.push_back(pChar);
 }
 
-void CCharsActiveList::ClientDetach()
+void CCharsActiveList::ClientDetach( CChar * pChar )
 {
 	ADDTOCALLSTACK("CCharsActiveList::ClientDetach");
 	m_iClients--;
+	std::vector<CChar *>::iterator it = std::find(m_ClientChars.begin(), m_ClientChars.end(), pChar);
+	if ( it != m_ClientChars.end() )
+	{
+		*it = m_ClientChars.back();
+		m_ClientChars.pop_back();
+	}
 }
 
 //////////////////////////////////////////////////////////////
 // -CItemList
 
-bool CItemsList::sm_fNotAMove = false;
-
-void CItemsList::OnRemoveOb( CGObListRec * pObRec )
+void CItemsList::RemoveItem( CItem * pItem, bool fNotAMove )
 {
-	ADDTOCALLSTACK("CItemsList::OnRemoveOb");
+	ADDTOCALLSTACK("CItemsList::RemoveItem");
 	// Item is picked up off the ground. (may be put right back down though)
-	CItem *pItem = static_cast<CItem *>(pObRec);
+	// fNotAMove = only the timer changes, don't let items bounce around too much.
 	ASSERT(pItem);
 
-	if ( !sm_fNotAMove )
+	if ( !fNotAMove )
+	{
 		pItem->OnMoveFrom();	// IT_MULTI, IT_SHIP and IT_COMM_CRYSTAL
+		++m_dwChangeStamp;
+	}
 
-	CGObList::OnRemoveOb(pObRec);
+	CTimerWheel::Unlink(pItem);	// no longer ticked by the sector.
+
+	CSectorObjList::OnRemoveOb(pItem);
 	pItem->SetContainerFlags(UID_O_DISCONNECT);	// It is no place for the moment.
 }
 
-void CItemsList::AddItemToSector( CItem * pItem )
+void CItemsList::OnRemoveOb( CGObListRec * pObRec )
+{
+	ADDTOCALLSTACK("CItemsList::OnRemoveOb");
+	RemoveItem(static_cast<CItem *>(pObRec), false);
+}
+
+void CItemsList::AddItemToSector( CItem * pItem, bool fNotAMove )
 {
 	ADDTOCALLSTACK("CItemsList::AddItemToSector");
 	// Add to top level.
 	// Either MoveTo() or SetTimeout is being called.
 	ASSERT( pItem );
+	if ( fNotAMove )
+	{
+		// take it out of the old list here, RemoveSelf() would count it as a move.
+		CItemsList * pListPrev = dynamic_cast<CItemsList *>(pItem->GetParent());
+		if ( pListPrev )
+			pListPrev->RemoveItem(pItem, true);
+	}
+	else
+		++m_dwChangeStamp;
 	CGObList::InsertHead( pItem );
 }
 
+//////////////////////////////////////////////////////////////////
+// -CSectorWalkCache
+
+CSectorWalkCache::CSectorWalkCache( DWORD dwVersion, size_t iPoints )
+{
+	m_dwVersion = dwVersion;
+	m_dwGlobal = CSectorBase::sm_dwWalkGlobal;
+	m_dwGeneration = 1;
+	m_fHazards = false;
+	m_pHazards = new DWORD[(iPoints + 31) / 32];
+	memset(m_Recs, 0, sizeof(m_Recs));
+}
+
+CSectorWalkCache::~CSectorWalkCache()
+{
+	delete[] m_pHazards;
+}
+
+void CSectorWalkCache::Invalidate( DWORD dwVersion )
+{
+	ADDTOCALLSTACK("CSectorWalkCache::Invalidate");
+	// Something changed in the sector, drop all the records.
+	m_dwVersion = dwVersion;
+	m_dwGlobal = CSectorBase::sm_dwWalkGlobal;
+	m_fHazards = false;
+	if ( ++m_dwGeneration == 0 )
+	{
+		memset(m_Recs, 0, sizeof(m_Recs));
+		m_dwGeneration = 1;
+	}
+}
+
 //////////////////////////////////////////////////////////////////
 // -CSectorBase
 
+volatile DWORD CSectorBase::sm_dwWalkGlobal = 0;
+
 CSectorBase::CSectorBase()
 {
 	m_map = 0;
 	m_index = 0;
 	m_dwFlags = 0;
+	m_pWalkCache = NULL;
+	m_dwWalkStamp = 0;
 }
 
 CSectorBase::~CSectorBase()
@@ -107,12 +304,13 @@ void CSectorBase::Init(int index, int newmap)
 		m_index = index;
 		m_map = newmap;
 	}
-}
 
-bool CSectorBase::CheckMapBlockTime( const MapBlockCache::value_type& Elem ) //static
-{
-	ADDTOCALLSTACK("CSectorBase::CheckMapBlockTime");
-	return (Elem.second->m_CacheTime.GetCacheAge() > m_iMapBlockCacheTime);
+	CPointMap ptBase = GetBasePoint();
+	int iSectorSize = g_MapList.GetSectorSize(m_map);
+	m_Chars_Active.InitIndex(this, ptBase, iSectorSize);
+	m_Chars_Disconnect.InitIndex(this, ptBase, iSectorSize);
+	m_Items_Timer.InitIndex(this, ptBase, iSectorSize);
+	m_Items_Inert.InitIndex(this, ptBase, iSectorSize);
 }
 
 void CSectorBase::ClearMapBlockCache()
@@ -123,41 +321,52 @@ void CSectorBase::ClearMapBlockCache()
 		delete it->second;
 
 	m_MapBlockCache.clear();
+	ClearWalkCache();
 }
 
-void CSectorBase::CheckMapBlockCache()
+void CSectorBase::CheckMapBlockCache( int iTime )
 {
 	ADDTOCALLSTACK("CSectorBase::CheckMapBlockCache");
 	// Clean out the sectors map cache if it has not been used recently.
 	// iTime == 0 = delete all.
+	// iTime is passed in, the sector threads clean their sectors at the same time.
+	ManualThreadLock lock;
+	if ( CSectorTicker::sm_fParallel )
+	{
+		// a thread ticking a neighbour sector may be loading a block here
+		lock.setMutex(&m_MapBlockLock);
+		lock.doLock();
+	}
+
 	if ( m_MapBlockCache.empty() )
 		return;
 	//DEBUG_ERR(("CacheHit\n"));
-	MapBlockCache::iterator it;
-	for (;;)
+	MapBlockCache::iterator it = m_MapBlockCache.begin();
+	while ( it != m_MapBlockCache.end() )
 	{
-		EXC_TRY("CheckMapBlockCache_new");
-		it = find_if( m_MapBlockCache.begin(), m_MapBlockCache.end(), CheckMapBlockTime );
-		if ( it == m_MapBlockCache.end() )
-			break;
-		else
+		if ( it->second->m_CacheTime.GetCacheAge() <= iTime )
 		{
-			if ( m_iMapBlockCacheTime <= 0 || it->second->m_CacheTime.GetCacheAge() >= m_iMapBlockCacheTime )
-			{
-				//DEBUG_ERR(("removing...\n"));
-				EXC_SET("CacheTime up - Deleting");
-				delete it->second;
-				m_MapBlockCache.erase(it);
-			}
+			++it;
+			continue;
 		}
+
+		long lIndex = it->first;
+		EXC_TRY("CheckMapBlockCache_new");
+		//DEBUG_ERR(("removing...\n"));
+		EXC_SET("CacheTime up - Deleting");
+		delete it->second;
+		m_MapBlockCache.erase(it++);
 		EXC_CATCH;
 		EXC_DEBUG_START;
 		CPointMap pt = GetBasePoint();
-		g_Log.EventDebug("m_MapBlockCache.erase(%ld)\n", it->first); 
-		g_Log.EventDebug("check time %d, index %ld/%" FMTSIZE_T "\n", m_iMapBlockCacheTime, it->first, m_MapBlockCache.size());
+		g_Log.EventDebug("m_MapBlockCache.erase(%ld)\n", lIndex); 
+		g_Log.EventDebug("check time %d, index %ld/%" FMTSIZE_T "\n", iTime, lIndex, m_MapBlockCache.size());
 		g_Log.EventDebug("sector #%d [%d,%d,%d,%d]\n", GetIndex(), pt.m_x, pt.m_y, pt.m_z, pt.m_map);
 		EXC_DEBUG_END;
 	}
+
+	if ( m_MapBlockCache.empty() )
+		ClearWalkCache();	// nobody walks here anymore
 }
 
 
@@ -179,6 +388,14 @@ const CGrayMapBlock * CSectorBase::GetMapBlock( const CPointMap & pt )
 
 	CGrayMapBlock * pMapBlock;
 
+	ManualThreadLock lock;
+	if ( CSectorTicker::sm_fParallel )
+	{
+		// this may not be a sector of the calling thread's stripe
+		lock.setMutex(&m_MapBlockLock);
+		lock.doLock();
+	}
+
 	// Find it in cache.
 	long lBlock = pntBlock.GetPointSortIndex();
 	MapBlockCache::iterator it = m_MapBlockCache.find(lBlock);
@@ -212,6 +429,125 @@ const CGrayMapBlock * CSectorBase::GetMapBlock( const CPointMap & pt )
 	return( pMapBlock );
 }
 
+void CSectorBase::ClearWalkCache()
+{
+	ADDTOCALLSTACK("CSectorBase::ClearWalkCache");
+	if ( m_pWalkCache != NULL )
+	{
+		delete m_pWalkCache;
+		m_pWalkCache = NULL;
+	}
+}
+
+CSectorWalkCache * CSectorBase::GetWalkCacheCurrent( bool fCreate )
+{
+	ADDTOCALLSTACK("CSectorBase::GetWalkCacheCurrent");
+	// Get the walk cache, dropping the records if anything changed since they were stored.
+	// NOTE: While the sectors are ticked in parallel only the stripe next to ours can look here,
+	//  items moving in from other stripes are deferred. (SectorThreads)
+	DWORD dwVersion = GetWalkVersion();
+	if ( m_pWalkCache == NULL )
+	{
+		if ( !fCreate )
+			return NULL;
+		size_t iSize = static_cast<size_t>(g_MapList.GetSectorSize(m_map));
+		m_pWalkCache = new CSectorWalkCache(dwVersion, iSize * iSize);
+	}
+	else if (( m_pWalkCache->m_dwVersion != dwVersion ) || ( m_pWalkCache->m_dwGlobal != sm_dwWalkGlobal ))
+	{
+		m_pWalkCache->Invalidate(dwVersion);
+	}
+	return m_pWalkCache;
+}
+
+size_t CSectorBase::GetWalkCacheIndex( const CPointMap & pt, const CGrayMapBlockState & block ) // static
+{
+	DWORD dwHash = (static_cast<DWORD>(pt.m_x) * 73856093) ^ (static_cast<DWORD>(pt.m_y) * 19349663) ^
+		(static_cast<DWORD>(static_cast<BYTE>(block.m_z)) * 83492791) ^ block.m_dwBlockFlags ^
+		(static_cast<DWORD>(block.m_zHeight) << 8) ^ (static_cast<DWORD>(block.m_iHeight) << 16);
+	return ( dwHash ^ (dwHash >> 16)) & (SECTOR_WALKCACHE_QTY - 1);
+}
+
+bool CSectorBase::GetWalkCache( const CPointMap & pt, CGrayMapBlockState & block )
+{
+	ADDTOCALLSTACK("CSectorBase::GetWalkCache");
+	// Fill in the result of a previous CWorld::GetHeightPoint() asked with the same block state here.
+	// RETURN: false = not cached, block is untouched.
+	CSectorWalkCache * pCache = GetWalkCacheCurrent(false);
+	if ( pCache == NULL )
+		return false;
+
+	const CSectorWalkRec & rec = pCache->m_Recs[GetWalkCacheIndex(pt, block)];
+	if (( rec.m_dwGeneration != pCache->m_dwGeneration ) || ( rec.m_x != pt.m_x ) || ( rec.m_y != pt.m_y ) ||
+		( rec.m_z != block.m_z ) || ( rec.m_dwBlockFlags != block.m_dwBlockFlags ) || ( rec.m_iHeight != block.m_iHeight ) ||
+		( rec.m_zClimb != block.m_zClimb ) || ( rec.m_zHeight != block.m_zHeight ))
+		return false;
+
+	block.m_zClimbHeight = rec.m_zClimbHeight;
+	block.m_Top = rec.m_Top;
+	block.m_Bottom = rec.m_Bottom;
+	block.m_Lowest = rec.m_Lowest;
+	return true;
+}
+
+void CSectorBase::SetWalkCache( const CPointMap & pt, const CGrayMapBlockState & block )
+{
+	ADDTOCALLSTACK("CSectorBase::SetWalkCache");
+	CSectorWalkCache * pCache = GetWalkCacheCurrent(true);
+	CSectorWalkRec & rec = pCache->m_Recs[GetWalkCacheIndex(pt, block)];
+	rec.m_dwGeneration = pCache->m_dwGeneration;
+	rec.m_dwBlockFlags = block.m_dwBlockFlags;
+	rec.m_iHeight = block.m_iHeight;
+	rec.m_x = pt.m_x;
+	rec.m_y = pt.m_y;
+	rec.m_z = block.m_z;
+	rec.m_zClimb = block.m_zClimb;
+	rec.m_zHeight = block.m_zHeight;
+	rec.m_zClimbHeight = block.m_zClimbHeight;
+	rec.m_Top = block.m_Top;
+	rec.m_Bottom = block.m_Bottom;
+	rec.m_Lowest = block.m_Lowest;
+}
+
+bool CSectorBase::IsWalkHazard( const CPointBase & pt )
+{
+	ADDTOCALLSTACK("CSectorBase::IsWalkHazard");
+	// Could there be an item NPCs would rather not step on here ? (see CChar::NPC_CheckWalkHere)
+	// false = there is none, true = the items at pt have to be checked.
+	CSectorWalkCache * pCache = GetWalkCacheCurrent(true);
+	size_t iSize = static_cast<size_t>(g_MapList.GetSectorSize(m_map));
+	if ( !pCache->m_fHazards )
+	{
+		memset(pCache->m_pHazards, 0, ((iSize * iSize + 31) / 32) * sizeof(DWORD));
+		const CItemsList * ppLists[2] = { &m_Items_Timer, &m_Items_Inert };
+		for ( size_t i = 0; i < COUNTOF(ppLists); ++i )
+		{
+			for ( const CItem * pItem = static_cast<const CItem *>(ppLists[i]->GetHead()); pItem != NULL; pItem = pItem->GetNext() )
+			{
+				switch ( pItem->GetType() )
+				{
+					case IT_WEB:
+					case IT_FIRE:
+					case IT_TRAP:
+					case IT_TRAP_ACTIVE:
+					case IT_MOONGATE:
+					case IT_TELEPAD:
+						break;
+					default:
+						continue;
+				}
+				const CPointMap & ptItem = pItem->GetTopPoint();
+				size_t iBit = ((ptItem.m_y % iSize) * iSize) + (ptItem.m_x % iSize);
+				pCache->m_pHazards[iBit / 32] |= (1 << (iBit % 32));
+			}
+		}
+		pCache->m_fHazards = true;
+	}
+
+	size_t iBit = ((pt.m_y % iSize) * iSize) + (pt.m_x % iSize);
+	return (( pCache->m_pHazards[iBit / 32] & (1 << (iBit % 32))) != 0 );
+}
+
 bool CSectorBase::IsInDungeon() const
 {
 	ADDTOCALLSTACK("CSectorBase::IsInDungeon");
@@ -5,7 +5,93 @@
 #define _INC_CSECTOR_H
 #pragma once
 
-class CCharsDisconnectList : public CGObList
+#define SECTOR_INDEX_CELL_SHIFT	4	// (SectorGrid) cells of 16x16 points
+
+class CSectorObjList;
+class CSectorBase;
+
+struct CSectorIndexPos
+{
+	WORD m_x;
+	WORD m_y;
+};
+
+class CSectorIndexCell
+{
+	// Top points of the objects of one cell of a sector list. (SectorGrid)
+	// A removed object only clears its slot, so slots never shift under a running CWorldSearch.
+public:
+	CSectorObjList * m_pList;
+	std::vector<CSectorIndexPos> m_Pos;		// scanned by CWorldSearch, one pair per slot
+	std::vector<CObjBaseTemplate *> m_Obj;	// NULL for a free slot
+	std::vector<size_t> m_Free;				// free slots to reuse
+
+public:
+	CSectorIndexCell() : m_pList(NULL) { };
+
+private:
+	CSectorIndexCell(const CSectorIndexCell& copy);
+	CSectorIndexCell& operator=(const CSectorIndexCell& other);
+
+public:
+	void Add( CObjBaseTemplate * pObj );
+	void Remove( CObjBaseTemplate * pObj );
+	void Update( CObjBaseTemplate * pObj );
+};
+
+class CSectorObjList : public CGObList
+{
+	// Top level objects of a sector. Also indexed by cells when SectorGrid is on.
+private:
+	CSectorBase * m_pSector;		// owner
+	CSectorIndexCell * m_pCells;	// allocated on first use
+	int m_iBaseX;					// upper left point of the sector
+	int m_iBaseY;
+	int m_iCellCols;				// cells per side
+
+protected:
+	void OnRemoveOb( CGObListRec* pObRec );	// Override this = called when removed from list.
+
+public:
+	void InitIndex( CSectorBase * pSector, const CPointBase & ptBase, int iSectorSize );
+	virtual void InsertAfter( CGObListRec * pNewRec, CGObListRec * pPrev = NULL );
+
+	CSectorBase * GetSector() const
+	{
+		return m_pSector;
+	}
+
+	int GetCellCols() const
+	{
+		return m_iCellCols;
+	}
+	int GetCellCol( int x ) const
+	{
+		int iCol = (x - m_iBaseX) >> SECTOR_INDEX_CELL_SHIFT;
+		return (iCol < 0) ? 0 : ((iCol >= m_iCellCols) ? m_iCellCols - 1 : iCol);
+	}
+	int GetCellRow( int y ) const
+	{
+		int iRow = (y - m_iBaseY) >> SECTOR_INDEX_CELL_SHIFT;
+		return (iRow < 0) ? 0 : ((iRow >= m_iCellCols) ? m_iCellCols - 1 : iRow);
+	}
+	const CSectorIndexCell * GetCell( int iCol, int iRow ) const
+	{
+		// NULL if nothing was ever indexed here.
+		return m_pCells ? &m_pCells[(iRow * m_iCellCols) + iCol] : NULL;
+	}
+	CSectorIndexCell * GetCellAt( const CPointBase & pt );
+
+public:
+	CSectorObjList();
+	virtual ~CSectorObjList();
+
+private:
+	CSectorObjList(const CSectorObjList& copy);
+	CSectorObjList& operator=(const CSectorObjList& other);
+};
+
+class CCharsDisconnectList : public CSectorObjList
 {
 public:
 	static const char *m_sClassName;
@@ -18,10 +104,11 @@ private:
 	CCharsDisconnectList& operator=(const CCharsDisconnectList& other);
 };
 
-class CCharsActiveList : public CGObList
+class CCharsActiveList : public CSectorObjList
 {
 private:
 	size_t m_iClients; // How many clients in this sector now?
+	std::vector<CChar *> m_ClientChars;	// the chars with a client attached (AreaOfInterest)
 public:
 	static const char *m_sClassName;
 	CServTime m_timeLastClient;	// age the sector based on last client here.
@@ -31,8 +118,10 @@ protected:
 
 public:
 	size_t HasClients() const { return( m_iClients ); }
-	void ClientAttach();
-	void ClientDetach();
+	void ClientAttach( CChar * pChar );
+	void ClientDetach( CChar * pChar );
+	size_t GetClientCharCount() const { return m_ClientChars.size(); }
+	CChar * GetClientChar( size_t i ) const { return m_ClientChars[i]; }
 	void AddCharToSector( CChar * pChar );
 
 public:
@@ -43,21 +132,25 @@ private:
 	CCharsActiveList& operator=(const CCharsActiveList& other);
 };
 
-class CItemsList : public CGObList
+class CItemsList : public CSectorObjList
 {
 	// Top level list of items.
-public:
-	static bool sm_fNotAMove;	// hack flag to prevent items from bouncing around too much.
+private:
+	DWORD m_dwChangeStamp;	// items added or removed, timer changes (fNotAMove) excluded
+
+private:
+	void RemoveItem( CItem * pItem, bool fNotAMove );
 
 protected:
 	void OnRemoveOb( CGObListRec* pObRec );	// Override this = called when removed from list.
 
 public:
 	static const char *m_sClassName;
-	void AddItemToSector( CItem * pItem );
+	void AddItemToSector( CItem * pItem, bool fNotAMove = false );
+	DWORD GetChangeStamp() const { return m_dwChangeStamp; }
 
 public:
-	CItemsList() { };
+	CItemsList() : m_dwChangeStamp(0) { };
 
 private:
 	CItemsList(const CItemsList& copy);
@@ -85,6 +178,48 @@ private:
 	CObPointSortArray& operator=(const CObPointSortArray& other);
 };
 
+#define SECTOR_WALKCACHE_QTY	1024	// walk checks cached per sector, a power of 2
+
+struct CSectorWalkRec
+{
+	// A CWorld::GetHeightPoint() result, keyed on the point and the block state it was asked with.
+	DWORD m_dwGeneration;	// CSectorWalkCache::m_dwGeneration it was stored at (0 = empty)
+	DWORD m_dwBlockFlags;
+	int m_iHeight;
+	WORD m_x;
+	WORD m_y;
+	signed char m_z;
+	signed char m_zClimb;
+	height_t m_zHeight;
+	height_t m_zClimbHeight;
+	CGrayMapBlocker m_Top;
+	CGrayMapBlocker m_Bottom;
+	CGrayMapBlocker m_Lowest;
+};
+
+class CSectorWalkCache
+{
+	// Walk checks of one sector. (WalkCache)
+public:
+	DWORD m_dwVersion;			// CSectorBase::GetWalkVersion() the records are valid for
+	DWORD m_dwGlobal;			// CSectorBase::sm_dwWalkGlobal the records are valid for
+	DWORD m_dwGeneration;		// bumped to drop all the records
+	bool m_fHazards;			// m_pHazards is valid for m_dwVersion
+	DWORD * m_pHazards;			// one bit per point of the sector, set where an item NPCs avoid lies
+	CSectorWalkRec m_Recs[SECTOR_WALKCACHE_QTY];
+
+public:
+	CSectorWalkCache( DWORD dwVersion, size_t iPoints );
+	~CSectorWalkCache();
+
+private:
+	CSectorWalkCache(const CSectorWalkCache& copy);
+	CSectorWalkCache& operator=(const CSectorWalkCache& other);
+
+public:
+	void Invalidate( DWORD dwVersion );
+};
+
 class CSectorBase		// world sector
 {
 protected:
@@ -93,8 +228,12 @@ protected:
 private:
 	typedef std::map<long, CGrayMapBlock*>	MapBlockCache;
 	MapBlockCache							m_MapBlockCache;
+	SimpleMutex							m_MapBlockLock;		// m_MapBlockCache while the sectors are ticked in parallel
+	CSectorWalkCache *	m_pWalkCache;		// (WalkCache) allocated on first use, freed with the map blocks
+	DWORD				m_dwWalkStamp;		// an item on the ground changed its look, type or height
 public:
 	static const char *m_sClassName;
+	static volatile DWORD sm_dwWalkGlobal;	// a multi or the item definitions changed, drops all walk caches
 	CObPointSortArray	m_Teleports;		//	CTeleport array
 	CRegionLinks		m_RegionLinks;		//	CRegionBase(s) in this CSector
 	DWORD			m_dwFlags;
@@ -121,12 +260,32 @@ public:
 	CRectMap GetRect() const;
 	bool IsInDungeon() const;
 
-	bool static CheckMapBlockTime( const MapBlockCache::value_type& Elem );
 	void ClearMapBlockCache();
-	void CheckMapBlockCache();
-	static int m_iMapBlockCacheTime;
+	void CheckMapBlockCache( int iTime );
 	const CGrayMapBlock * GetMapBlock( const CPointMap & pt );
 
+	// Walk cache (WalkCache)
+	DWORD GetWalkVersion() const
+	{
+		return m_Items_Timer.GetChangeStamp() + m_Items_Inert.GetChangeStamp() + m_dwWalkStamp;
+	}
+	void InvalidateWalkCache()
+	{
+		++m_dwWalkStamp;
+	}
+	static void InvalidateWalkCaches()
+	{
+		++sm_dwWalkGlobal;
+	}
+	void ClearWalkCache();
+	bool GetWalkCache( const CPointMap & pt, CGrayMapBlockState & block );
+	void SetWalkCache( const CPointMap & pt, const CGrayMapBlockState & block );
+	bool IsWalkHazard( const CPointBase & pt );
+private:
+	CSectorWalkCache * GetWalkCacheCurrent( bool fCreate );
+	static size_t GetWalkCacheIndex( const CPointMap & pt, const CGrayMapBlockState & block );
+public:
+
 	// CRegionBase
 	CRegionBase * GetRegion( const CPointBase & pt, DWORD dwType ) const;
 	size_t GetRegions( const CPointBase & pt, DWORD dwType, CRegionLinks & rlist ) const;
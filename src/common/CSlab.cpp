@@ -0,0 +1,170 @@
+/**
+* @file CSlab.cpp
+*/
+
+#include "../graysvr/graysvr.h"
+
+#define SLAB_CHUNK_SIZE		0x10000		// bytes per chunk
+#define SLAB_CHUNK_MINQTY	16			// blocks per chunk at least
+#define SLAB_ALIGN			16
+
+CSlab * CSlab::sm_pHead = NULL;
+bool CSlab::sm_fEnabled = false;
+
+CSlab::CSlab( LPCTSTR pszName, size_t iSize )
+{
+	m_pszName = pszName;
+	m_iSize = iSize;
+	m_iBlock = ( maximum(iSize, sizeof(void *)) + SLAB_ALIGN - 1 ) &~ ( SLAB_ALIGN - 1 );
+	m_iChunkQty = maximum(SLAB_CHUNK_SIZE / m_iBlock, static_cast<size_t>(SLAB_CHUNK_MINQTY));
+	m_pMutex = new SimpleMutex;
+
+	m_pFree = NULL;
+	m_pBump = NULL;
+	m_pBumpEnd = NULL;
+	m_iLive = 0;
+	m_iFree = 0;
+	m_iPeak = 0;
+	m_iChunks = 0;
+
+	// Slabs are static members, constructed before main() on one thread.
+	m_pNext = sm_pHead;
+	sm_pHead = this;
+}
+
+void * CSlab::Alloc( size_t iSize )
+{
+	// Not constructed yet (static init of another file) or a derived class without its own slab.
+	if ( m_pMutex == NULL || iSize != m_iSize )
+		return ::operator new(iSize);
+
+	if ( !sm_fEnabled )
+	{
+		void * pData = ::operator new(iSize);
+		SimpleThreadLock lock(*m_pMutex);
+		if ( ++m_iLive > m_iPeak )
+			m_iPeak = m_iLive;
+		return pData;
+	}
+
+	SimpleThreadLock lock(*m_pMutex);
+	void * pData;
+	if ( m_pFree != NULL )
+	{
+		pData = m_pFree;
+		m_pFree = *static_cast<void **>(pData);
+		m_iFree--;
+	}
+	else
+	{
+		if ( m_pBump == m_pBumpEnd )
+		{
+			m_pBump = static_cast<BYTE *>(::operator new(m_iBlock * m_iChunkQty));
+			m_pBumpEnd = m_pBump + ( m_iBlock * m_iChunkQty );
+			m_iChunks++;
+		}
+		pData = m_pBump;
+		m_pBump += m_iBlock;
+	}
+
+	if ( ++m_iLive > m_iPeak )
+		m_iPeak = m_iLive;
+	return pData;
+}
+
+void CSlab::Free( void * pData, size_t iSize )
+{
+	if ( pData == NULL )
+		return;
+	if ( m_pMutex == NULL || iSize != m_iSize )
+	{
+		::operator delete(pData);
+		return;
+	}
+
+	SimpleThreadLock lock(*m_pMutex);
+	if ( m_iLive > 0 )
+		m_iLive--;
+
+	// Slabs can not be turned off again, so with them off no block comes from a chunk. With them on, the
+	// objects made before the ini was read join the free list as well.
+	if ( !sm_fEnabled )
+	{
+		::operator delete(pData);
+		return;
+	}
+
+	*static_cast<void **>(pData) = m_pFree;
+	m_pFree = pData;
+	m_iFree++;
+}
+
+void CSlab::Enable()
+{
+	// Blocks in the chunks must never go back to the heap, so there is no way back.
+	sm_fEnabled = true;
+}
+
+bool CSlab::IsEnabled()
+{
+	return sm_fEnabled;
+}
+
+bool CSlab::r_WriteVal( LPCTSTR pszKey, CGString & sVal )
+{
+	ADDTOCALLSTACK("CSlab::r_WriteVal");
+	// "SLAB.COUNT", "SLAB.n.NAME", "SLAB.CItem.LIVE" ...
+
+	if ( !strcmpi(pszKey, "COUNT") )
+	{
+		size_t iCount = 0;
+		for ( CSlab * pSlab = sm_pHead; pSlab != NULL; pSlab = pSlab->m_pNext )
+			iCount++;
+		sVal.FormatUVal(static_cast<unsigned long>(iCount));
+		return true;
+	}
+
+	TCHAR * pszTemp = Str_GetTemp();
+	strcpy(pszTemp, pszKey);
+	TCHAR * pszProp = strchr(pszTemp, '.');
+	if ( pszProp == NULL )
+		return false;
+	*pszProp++ = '\0';
+
+	CSlab * pSlab = sm_pHead;
+	if ( IsDigit(*pszTemp) )
+	{
+		for ( size_t i = ATOI(pszTemp); pSlab != NULL && i > 0; i-- )
+			pSlab = pSlab->m_pNext;
+	}
+	else
+	{
+		while ( pSlab != NULL && strcmpi(pSlab->m_pszName, pszTemp) )
+			pSlab = pSlab->m_pNext;
+	}
+	if ( pSlab == NULL )
+		return false;
+
+	if ( !strcmpi(pszProp, "NAME") )
+	{
+		sVal = pSlab->m_pszName;
+		return true;
+	}
+
+	SimpleThreadLock lock(*pSlab->m_pMutex);
+	if ( !strcmpi(pszProp, "LIVE") )
+		sVal.FormatUVal(static_cast<unsigned long>(pSlab->m_iLive));
+	else if ( !strcmpi(pszProp, "FREE") )
+		sVal.FormatUVal(static_cast<unsigned long>(pSlab->m_iFree));
+	else if ( !strcmpi(pszProp, "PEAK") )
+		sVal.FormatUVal(static_cast<unsigned long>(pSlab->m_iPeak));
+	else if ( !strcmpi(pszProp, "CHUNKS") )
+		sVal.FormatUVal(static_cast<unsigned long>(pSlab->m_iChunks));
+	else if ( !strcmpi(pszProp, "SIZE") )
+		sVal.FormatUVal(static_cast<unsigned long>(pSlab->m_iBlock));
+	else if ( !strcmpi(pszProp, "MEM") )
+		sVal.FormatUVal(static_cast<unsigned long>(pSlab->m_iChunks * pSlab->m_iChunkQty * pSlab->m_iBlock));
+	else
+		return false;
+	return true;
+}
@@ -0,0 +1,65 @@
+/**
+* @file CSlab.h
+*/
+
+#ifndef _INC_CSLAB_H
+#define _INC_CSLAB_H
+#pragma once
+
+class SimpleMutex;
+class CGString;
+
+/**
+* @brief Pool of fixed size blocks for the objects of one class.
+*
+* With SlabAlloc on, blocks are carved from 64KB chunks with a pointer bump, and the blocks of
+* deleted objects are kept in a free list for the next object of the class. Chunks are never given
+* back to the system. The live/peak counts are kept either way.
+*/
+class CSlab
+{
+private:
+	static CSlab * sm_pHead;	///< All the slabs, for SERV.SLAB.
+	static bool sm_fEnabled;	///< SlabAlloc, can only be turned on.
+	CSlab * m_pNext;
+
+	LPCTSTR m_pszName;
+	size_t m_iSize;			///< sizeof the class, other sizes (derived classes without a slab) go to the heap.
+	size_t m_iBlock;		///< m_iSize rounded up for alignment.
+	size_t m_iChunkQty;		///< Blocks per chunk.
+	SimpleMutex * m_pMutex;	///< Never deleted, objects can still be deleted during the static destruction.
+
+	void * m_pFree;			///< Free blocks, linked through their first bytes.
+	BYTE * m_pBump;			///< Next unused block of the current chunk.
+	BYTE * m_pBumpEnd;
+
+	size_t m_iLive;
+	size_t m_iFree;
+	size_t m_iPeak;
+	size_t m_iChunks;
+
+public:
+	CSlab( LPCTSTR pszName, size_t iSize );
+
+private:
+	CSlab(const CSlab& copy);
+	CSlab& operator=(const CSlab& other);
+
+public:
+	void * Alloc( size_t iSize );
+	void Free( void * pData, size_t iSize );
+
+	static void Enable();
+	static bool IsEnabled();
+	static bool r_WriteVal( LPCTSTR pszKey, CGString & sVal );
+};
+
+// Give a class its own slab. SLAB_IMPLEMENT goes in one .cpp file.
+#define SLAB_DECLARE \
+	static CSlab sm_Slab; \
+	static void * operator new( size_t iSize ) { return sm_Slab.Alloc( iSize ); } \
+	static void operator delete( void * pData, size_t iSize ) { sm_Slab.Free( pData, iSize ); }
+
+#define SLAB_IMPLEMENT(_class)	CSlab _class::sm_Slab( #_class, sizeof(_class) )
+
+#endif	// _INC_CSLAB_H
@@ -689,6 +689,186 @@ int FindTable(LPCTSTR pszFind, LPCTSTR const * ppszTable, int iCount, int iElemS
 	return(-1);
 }
 
+//***************************************************************************
+// -CTableHash
+
+CTableHash::CTableHash(LPCTSTR const * ppTable, int iCount, int iElemSize) :
+	m_ppTable(ppTable), m_iCount(iCount), m_iElemSize(iElemSize), m_dwSeed(0), m_dwSlotMask(0), m_dwBuckets(0),
+	m_pDisplace(NULL), m_pSlots(NULL), m_pLength(NULL)
+{
+	// Hash and displace: the keys are spread over buckets, then each bucket (biggest first)
+	// gets the displacement that puts all its keys in free slots.
+	if (iCount <= 0)
+		return;
+
+	m_dwSlotMask = 1;
+	while (m_dwSlotMask < static_cast<DWORD>(iCount) * 2)
+		m_dwSlotMask <<= 1;
+	m_dwSlotMask--;
+	m_dwBuckets = static_cast<DWORD>(iCount / 2) + 1;
+
+	m_pLength = new size_t[iCount];
+	for (int i = 0; i < iCount; i++)
+	{
+		LPCTSTR pszKey = GetKey(i);
+		m_pLength[i] = strlen(pszKey);
+
+		// a header ends on the first other character, so these keys can't be hashed
+		for (size_t j = 0; j < m_pLength[i]; j++)
+		{
+			if (!isalnum(static_cast<BYTE>(pszKey[j])) && (pszKey[j] != '_'))
+				return;
+		}
+	}
+
+	m_pDisplace = new WORD[m_dwBuckets];
+	m_pSlots = new int[m_dwSlotMask + 1];
+	for (DWORD dwSeed = 0; dwSeed < 32; dwSeed++)
+	{
+		if (Build(dwSeed))
+			return;
+	}
+
+	// no perfect hash, keep using the binary search
+	delete[] m_pSlots;
+	m_pSlots = NULL;
+}
+
+CTableHash::~CTableHash()
+{
+	delete[] m_pDisplace;
+	delete[] m_pSlots;
+	delete[] m_pLength;
+	m_pSlots = NULL;
+}
+
+LPCTSTR CTableHash::GetKey(int i) const
+{
+	return *((LPCTSTR const *)(((const BYTE*)m_ppTable) + (i*m_iElemSize)));
+}
+
+size_t CTableHash::Hash(LPCTSTR pszFind, bool fHead, DWORD dwSeed, DWORD & dwHash1, DWORD & dwHash2)
+{
+	// Case insensitive, a header ends where Str_CmpHeadI would accept the end of a table keyword.
+	// RETURN: length of the hashed string
+	dwHash1 = 2166136261u ^ dwSeed;
+	dwHash2 = 0x9E3779B9u + dwSeed;
+	size_t i = 0;
+	for (;; i++)
+	{
+		TCHAR ch = pszFind[i];
+		if (ch == '\0')
+			break;
+		if (fHead && !isalnum(static_cast<BYTE>(ch)) && (ch != '_'))
+			break;
+		if (ch >= 'A' && ch <= 'Z')
+			ch += 'a' - 'A';
+		dwHash1 = (dwHash1 ^ static_cast<BYTE>(ch)) * 16777619u;
+		dwHash2 = ((dwHash2 << 5) + dwHash2) ^ static_cast<BYTE>(ch);
+	}
+	dwHash2 ^= dwHash2 >> 15;
+	dwHash2 *= 0x2C1B3C6Du;
+	dwHash2 ^= dwHash2 >> 12;
+	return i;
+}
+
+bool CTableHash::Build(DWORD dwSeed)
+{
+	DWORD * pHash1 = new DWORD[m_iCount];
+	DWORD * pStep = new DWORD[m_iCount];
+	DWORD * pBucket = new DWORD[m_iCount];
+	DWORD * pBucketSize = new DWORD[m_dwBuckets];
+	memset(pBucketSize, 0, sizeof(DWORD) * m_dwBuckets);
+
+	DWORD dwMaxSize = 0;
+	for (int i = 0; i < m_iCount; i++)
+	{
+		DWORD dwHash2;
+		Hash(GetKey(i), false, dwSeed, pHash1[i], dwHash2);
+		pBucket[i] = dwHash2 % m_dwBuckets;
+		pStep[i] = (dwHash2 >> 16) | 1;
+		if (++pBucketSize[pBucket[i]] > dwMaxSize)
+			dwMaxSize = pBucketSize[pBucket[i]];
+	}
+
+	for (DWORD s = 0; s <= m_dwSlotMask; s++)
+		m_pSlots[s] = -1;
+	memset(m_pDisplace, 0, sizeof(WORD) * m_dwBuckets);
+
+	bool fOk = true;
+	for (DWORD dwSize = dwMaxSize; fOk && dwSize > 0; dwSize--)
+	{
+		for (DWORD b = 0; fOk && b < m_dwBuckets; b++)
+		{
+			if (pBucketSize[b] != dwSize)
+				continue;
+
+			// find a displacement moving every key of the bucket to a free slot
+			fOk = false;
+			for (DWORD d = 0; !fOk && d <= 0xFFFF; d++)
+			{
+				int i = 0;
+				for ( ; i < m_iCount; i++)
+				{
+					if (pBucket[i] != b)
+						continue;
+					DWORD s = (pHash1[i] + d * pStep[i]) & m_dwSlotMask;
+					if (m_pSlots[s] >= 0)
+						break;
+					m_pSlots[s] = i;
+				}
+				fOk = (i >= m_iCount);
+
+				// undo a partial placement
+				for (int j = 0; !fOk && j < i; j++)
+				{
+					if (pBucket[j] == b)
+						m_pSlots[(pHash1[j] + d * pStep[j]) & m_dwSlotMask] = -1;
+				}
+				if (fOk)
+					m_pDisplace[b] = static_cast<WORD>(d);
+			}
+		}
+	}
+
+	delete[] pHash1;
+	delete[] pStep;
+	delete[] pBucket;
+	delete[] pBucketSize;
+
+	m_dwSeed = dwSeed;
+	return fOk;
+}
+
+int CTableHash::FindHashed(LPCTSTR pszFind, bool fHead) const
+{
+	DWORD dwHash1, dwHash2;
+	size_t iLen = Hash(pszFind, fHead, m_dwSeed, dwHash1, dwHash2);
+	DWORD dwStep = (dwHash2 >> 16) | 1;
+	DWORD dwDisplace = m_pDisplace[dwHash2 % m_dwBuckets];
+
+	int i = m_pSlots[(dwHash1 + dwDisplace * dwStep) & m_dwSlotMask];
+	if (i < 0 || m_pLength[i] != iLen)
+		return -1;
+	if (strnicmp(pszFind, GetKey(i), iLen))
+		return -1;
+	return i;
+}
+
+int CTableHash::Find(LPCTSTR pszFind) const
+{
+	if (m_pSlots == NULL)
+		return FindTableSorted(pszFind, m_ppTable, m_iCount, m_iElemSize);
+	return FindHashed(pszFind, false);
+}
+
+int CTableHash::FindHead(LPCTSTR pszFind) const
+{
+	if (m_pSlots == NULL)
+		return FindTableHeadSorted(pszFind, m_ppTable, m_iCount, m_iElemSize);
+	return FindHashed(pszFind, true);
+}
+
 size_t Str_GetBare(TCHAR * pszOut, LPCTSTR pszInp, size_t iMaxOutSize, LPCTSTR pszStrip)
 {
 	// That the client can deal with. Basic punctuation and alpha and numbers.
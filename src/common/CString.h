@@ -530,6 +530,60 @@ int FindTableHead(LPCTSTR pFind, LPCTSTR const * ppTable, int iCount, int iElemS
 */
 int FindTableHeadSorted(LPCTSTR pFind, LPCTSTR const * ppTable, int iCount, int iElemSize = sizeof(LPCTSTR));
 
+/**
+* @brief Perfect hash over a keyword table, built once from the table itself.
+*
+* Finds the same index as FindTableSorted / FindTableHeadSorted with one hash and
+* one string compare instead of a binary search. Falls back to the binary search
+* if no perfect hash could be found for the table.
+*/
+class CTableHash
+{
+private:
+	LPCTSTR const * m_ppTable;	///< keyword table.
+	int m_iCount;				///< count of keywords.
+	int m_iElemSize;			///< size of elements of the table.
+	DWORD m_dwSeed;				///< seed of the hash function.
+	DWORD m_dwSlotMask;			///< count of slots - 1 (power of 2).
+	DWORD m_dwBuckets;			///< count of displacement buckets.
+	WORD * m_pDisplace;			///< displacement of each bucket.
+	int * m_pSlots;				///< keyword index of each slot, -1 if empty.
+	size_t * m_pLength;			///< length of each keyword.
+
+public:
+	/**
+	* @param ppTable table of keywords (case insensitive, no duplicates).
+	* @param iCount count of keywords.
+	* @param iElemSize size of elements of the table.
+	*/
+	CTableHash(LPCTSTR const * ppTable, int iCount, int iElemSize = sizeof(LPCTSTR));
+	~CTableHash();
+
+private:
+	CTableHash(const CTableHash & copy);
+	CTableHash & operator=(const CTableHash & other);
+
+public:
+	/**
+	* @brief Look for a string in the table (same as FindTableSorted).
+	* @param pFind string we are looking for.
+	* @return the index of string if success, -1 otherwise.
+	*/
+	int Find(LPCTSTR pFind) const;
+	/**
+	* @brief Look for a string header in the table (same as FindTableHeadSorted).
+	* @param pFind string we are looking for.
+	* @return the index of string if success, -1 otherwise.
+	*/
+	int FindHead(LPCTSTR pFind) const;
+
+private:
+	LPCTSTR GetKey(int i) const;
+	static size_t Hash(LPCTSTR pFind, bool fHead, DWORD dwSeed, DWORD & dwHash1, DWORD & dwHash2);
+	bool Build(DWORD dwSeed);
+	int FindHashed(LPCTSTR pFind, bool fHead) const;
+};
+
 void CharToMultiByteNonNull(BYTE*, const char* , size_t);
 
 // extern TCHAR * Str_GetTemporary(int amount = 1);
@@ -1,4 +1,5 @@
 #include "../graysvr/graysvr.h"
+#include <algorithm>
 
 static size_t GetIdentifierString( TCHAR * szTag, LPCTSTR pszArgs )
 {
@@ -17,6 +18,140 @@ static size_t GetIdentifierString( TCHAR * szTag, LPCTSTR pszArgs )
 	return i;
 }
 
+/***************************************************************************
+*
+*
+*	class CVarDefKeys		Interned keys of the variables
+*
+*
+***************************************************************************/
+
+SimpleMutex * CVarDefKeys::sm_pLock = NULL;
+CVarDefKeys::CKeyRec ** CVarDefKeys::sm_ppBuckets = NULL;
+size_t CVarDefKeys::sm_iBuckets = 0;
+size_t CVarDefKeys::sm_iCount = 0;
+
+DWORD CVarDefKeys::GetHash( LPCTSTR pszKey ) // static
+{
+	// FNV-1a on the lower case chars.
+	DWORD dwHash = 2166136261U;
+	for ( ; *pszKey; ++pszKey )
+	{
+		dwHash ^= static_cast<BYTE>(tolower(*pszKey));
+		dwHash *= 16777619U;
+	}
+	return dwHash;
+}
+
+CVarDefKeys::CKeyRec * CVarDefKeys::GetRec( LPCTSTR pszKey ) // static
+{
+	return reinterpret_cast<CKeyRec *>(const_cast<TCHAR *>(pszKey) - offsetof(CKeyRec, m_szKey));
+}
+
+void CVarDefKeys::Grow() // static
+{
+	size_t iBuckets = sm_iBuckets ? sm_iBuckets * 2 : 1024;
+	CKeyRec ** ppBuckets = new CKeyRec * [iBuckets];
+	memset(ppBuckets, 0, sizeof(CKeyRec *) * iBuckets);
+
+	for ( size_t i = 0; i < sm_iBuckets; ++i )
+	{
+		CKeyRec * pRec = sm_ppBuckets[i];
+		while ( pRec != NULL )
+		{
+			CKeyRec * pNext = pRec->m_pNext;
+			CKeyRec *& pHead = ppBuckets[pRec->m_dwHash & (iBuckets - 1)];
+			pRec->m_pNext = pHead;
+			pHead = pRec;
+			pRec = pNext;
+		}
+	}
+
+	delete[] sm_ppBuckets;
+	sm_ppBuckets = ppBuckets;
+	sm_iBuckets = iBuckets;
+}
+
+LPCTSTR CVarDefKeys::Intern( LPCTSTR pszKey, DWORD dwHash ) // static
+{
+	// RETURN: the pooled lower case copy of pszKey, to Release() when done.
+	if ( sm_pLock == NULL )
+		sm_pLock = new SimpleMutex;	// first use is while loading the scripts
+	SimpleThreadLock lock(*sm_pLock);
+
+	if ( sm_iBuckets > 0 )
+	{
+		for ( CKeyRec * pRec = sm_ppBuckets[dwHash & (sm_iBuckets - 1)]; pRec != NULL; pRec = pRec->m_pNext )
+		{
+			if (( pRec->m_dwHash == dwHash ) && !strcmpi(pRec->m_szKey, pszKey))
+			{
+				++pRec->m_iRefs;
+				return pRec->m_szKey;
+			}
+		}
+	}
+
+	if ( sm_iCount >= sm_iBuckets )
+		Grow();
+
+	size_t iLen = strlen(pszKey);
+	CKeyRec * pRec = static_cast<CKeyRec *>(malloc(offsetof(CKeyRec, m_szKey) + iLen + 1));
+	if ( pRec == NULL )
+		throw CGrayError(LOGL_CRIT, 0, "CVarDefKeys: out of memory");
+	pRec->m_iRefs = 1;
+	pRec->m_dwHash = dwHash;
+	for ( size_t i = 0; i <= iLen; ++i )
+		pRec->m_szKey[i] = static_cast<TCHAR>(tolower(pszKey[i]));
+
+	CKeyRec *& pHead = sm_ppBuckets[dwHash & (sm_iBuckets - 1)];
+	pRec->m_pNext = pHead;
+	pHead = pRec;
+	++sm_iCount;
+	return pRec->m_szKey;
+}
+
+void CVarDefKeys::Release( LPCTSTR pszKey ) // static
+{
+	if ( pszKey == NULL )
+		return;
+
+	ASSERT(sm_pLock != NULL);
+	SimpleThreadLock lock(*sm_pLock);
+
+	CKeyRec * pRec = GetRec(pszKey);
+	ASSERT(pRec->m_iRefs > 0);
+	if ( --pRec->m_iRefs > 0 )
+		return;
+
+	CKeyRec ** ppLink = &sm_ppBuckets[pRec->m_dwHash & (sm_iBuckets - 1)];
+	while ( *ppLink != pRec )
+	{
+		ASSERT(*ppLink != NULL);
+		ppLink = &(*ppLink)->m_pNext;
+	}
+	*ppLink = pRec->m_pNext;
+	--sm_iCount;
+	free(pRec);
+}
+
+size_t CVarDefKeys::GetCount() // static
+{
+	return sm_iCount;
+}
+
+#ifndef _WIN32
+void CVarDefKeys::LockFork( bool fLock ) // static
+{
+	// Held while forking, so no other thread has the pool locked in the child.
+	if ( sm_pLock == NULL )
+		return;
+	if ( fLock )
+		sm_pLock->lock();
+	else
+		sm_pLock->unlock();
+}
+#endif
+
 /***************************************************************************
 *
 *
@@ -24,24 +159,29 @@ static size_t GetIdentifierString( TCHAR * szTag, LPCTSTR pszArgs )
 *
 *
 ***************************************************************************/
-CVarDefCont::CVarDefCont( LPCTSTR pszKey ) : m_Key( pszKey ) 
+CVarDefCont::CVarDefCont( LPCTSTR pszKey )
 { 
-	m_Key.MakeLower(); 
+	m_dwHash = CVarDefKeys::GetHash(pszKey);
+	m_pszKey = CVarDefKeys::Intern(pszKey, m_dwHash);
 }
 
 CVarDefCont::~CVarDefCont()
 {
+	CVarDefKeys::Release(m_pszKey);
 }
 
 LPCTSTR CVarDefCont::GetKey() const 
 { 
-	return( m_Key.GetPtr() ); 
+	return( m_pszKey ); 
 }
 
 void CVarDefCont::SetKey( LPCTSTR pszKey )
 { 
-	m_Key = pszKey;
-	m_Key.MakeLower(); 
+	// NOTE: don't do this while in a CVarDefMap, it is hashed on the key.
+	LPCTSTR pszOld = m_pszKey;
+	m_dwHash = CVarDefKeys::GetHash(pszKey);
+	m_pszKey = CVarDefKeys::Intern(pszKey, m_dwHash);
+	CVarDefKeys::Release(pszOld);
 }
 
 /***************************************************************************
@@ -52,6 +192,8 @@ void CVarDefCont::SetKey( LPCTSTR pszKey )
 *
 ***************************************************************************/
 
+SLAB_IMPLEMENT(CVarDefContNum);
+
 CVarDefContNum::CVarDefContNum( LPCTSTR pszKey, INT64 iVal ) : CVarDefCont( pszKey ), m_iVal( iVal )
 {
 }
@@ -108,6 +250,8 @@ CVarDefCont * CVarDefContNum::CopySelf() const
 *
 ***************************************************************************/
 
+SLAB_IMPLEMENT(CVarDefContStr);
+
 CVarDefContStr::CVarDefContStr( LPCTSTR pszKey, LPCTSTR pszVal ) : CVarDefCont( pszKey ), m_sVal( pszVal ) 
 {
 }
@@ -162,43 +306,12 @@ CVarDefCont * CVarDefContStr::CopySelf() const
 /***************************************************************************
 *
 *
-*	class CVarDefMap::CVarDefContTest	Variable implementation (search-only internal useage)
+*	class CVarDefMap::ltstr			KEY part sorting for the ordered view
 *
 *
 ***************************************************************************/
 
-CVarDefMap::CVarDefContTest::CVarDefContTest( LPCTSTR pszKey ) : CVarDefCont( pszKey )
-{
-}
-
-CVarDefMap::CVarDefContTest::~CVarDefContTest()
-{
-}
-
-LPCTSTR CVarDefMap::CVarDefContTest::GetValStr() const 
-{ 
-	return NULL; 
-}
-	
-INT64 CVarDefMap::CVarDefContTest::GetValNum() const 
-{ 
-	return -1; 
-}
-
-CVarDefCont * CVarDefMap::CVarDefContTest::CopySelf() const 
-{ 
-	return new CVarDefContTest( GetKey() ); 
-}
-
-/***************************************************************************
-*
-*
-*	class CVarDefMap::ltstr			KEY part sorting wrapper over std::set
-*
-*
-***************************************************************************/
-
-bool CVarDefMap::ltstr::operator()(CVarDefCont * s1, CVarDefCont * s2) const
+bool CVarDefMap::ltstr::operator()(const CVarDefCont * s1, const CVarDefCont * s2) const
 {
 	return( strcmpi(s1->GetKey(), s2->GetKey()) < 0 );
 }
@@ -220,12 +333,119 @@ CVarDefMap & CVarDefMap::operator = ( const CVarDefMap & array )
 CVarDefMap::~CVarDefMap()
 {
 	Empty();
+	delete[] m_pSlots;
+	delete m_pSorted;
+}
+
+bool CVarDefMap::FindSlot( LPCTSTR pszKey, DWORD dwHash, DWORD & dwSlot ) const
+{
+	// RETURN: true = found, dwSlot = where it is. false = dwSlot is the free slot to put it in.
+	if ( m_pSlots == NULL )
+		return( false );
+
+	for ( dwSlot = dwHash & m_dwSlotMask; m_pSlots[dwSlot].m_pVar != NULL; dwSlot = (dwSlot + 1) & m_dwSlotMask )
+	{
+		if (( m_pSlots[dwSlot].m_dwHash == dwHash ) && !strcmpi( m_pSlots[dwSlot].m_pVar->GetKey(), pszKey ))
+			return( true );
+	}
+	return( false );
+}
+
+void CVarDefMap::Grow()
+{
+	ADDTOCALLSTACK("CVarDefMap::Grow");
+	// Keep it at most 3/4 full.
+	DWORD dwSlots = m_pSlots ? (m_dwSlotMask + 1) * 2 : 4;
+	CVarDefSlot * pOld = m_pSlots;
+	DWORD dwOldSlots = m_pSlots ? m_dwSlotMask + 1 : 0;
+
+	m_pSlots = new CVarDefSlot[dwSlots];
+	memset(m_pSlots, 0, sizeof(CVarDefSlot) * dwSlots);
+	m_dwSlotMask = dwSlots - 1;
+
+	for ( DWORD i = 0; i < dwOldSlots; ++i )
+	{
+		if ( pOld[i].m_pVar == NULL )
+			continue;
+		DWORD dwSlot = pOld[i].m_dwHash & m_dwSlotMask;
+		while ( m_pSlots[dwSlot].m_pVar != NULL )
+			dwSlot = (dwSlot + 1) & m_dwSlotMask;
+		m_pSlots[dwSlot] = pOld[i];
+	}
+	delete[] pOld;
+}
+
+void CVarDefMap::InsertSlot( CVarDefCont * pVar )
+{
+	ADDTOCALLSTACK("CVarDefMap::InsertSlot");
+	// ASSUME: the key is not here yet.
+	ASSERT(pVar);
+	if ( m_pSlots == NULL || (m_dwCount + 1) * 4 > (m_dwSlotMask + 1) * 3 )
+		Grow();
+
+	DWORD dwSlot = pVar->GetKeyHash() & m_dwSlotMask;
+	while ( m_pSlots[dwSlot].m_pVar != NULL )
+		dwSlot = (dwSlot + 1) & m_dwSlotMask;
+
+	m_pSlots[dwSlot].m_dwHash = pVar->GetKeyHash();
+	m_pSlots[dwSlot].m_pVar = pVar;
+	++m_dwCount;
+	m_fSorted = false;
+}
+
+void CVarDefMap::RemoveSlot( DWORD dwSlot )
+{
+	ADDTOCALLSTACK("CVarDefMap::RemoveSlot");
+	// Take the var out (not deleted), and pull back the ones that probed past it.
+	ASSERT(m_pSlots && m_pSlots[dwSlot].m_pVar);
+	m_pSlots[dwSlot].m_pVar = NULL;
+	--m_dwCount;
+	m_fSorted = false;
+
+	DWORD dwHole = dwSlot;
+	for ( DWORD i = (dwSlot + 1) & m_dwSlotMask; m_pSlots[i].m_pVar != NULL; i = (i + 1) & m_dwSlotMask )
+	{
+		DWORD dwHome = m_pSlots[i].m_dwHash & m_dwSlotMask;
+		// Can it move to the hole ? (is the hole between its home and where it is now)
+		if ((( i - dwHome ) & m_dwSlotMask ) >= (( i - dwHole ) & m_dwSlotMask ))
+		{
+			m_pSlots[dwHole] = m_pSlots[i];
+			m_pSlots[i].m_pVar = NULL;
+			dwHole = i;
+		}
+	}
+}
+
+const std::vector<CVarDefCont *> & CVarDefMap::GetSorted() const
+{
+	ADDTOCALLSTACK("CVarDefMap::GetSorted");
+	// The keys in order, for what shows or saves them. Built again after a change.
+	if ( m_pSorted == NULL )
+		m_pSorted = new std::vector<CVarDefCont *>;
+
+	if ( !m_fSorted )
+	{
+		m_pSorted->clear();
+		m_pSorted->reserve(m_dwCount);
+		if ( m_pSlots != NULL )
+		{
+			for ( DWORD i = 0; i <= m_dwSlotMask; ++i )
+			{
+				if ( m_pSlots[i].m_pVar != NULL )
+					m_pSorted->push_back(m_pSlots[i].m_pVar);
+			}
+		}
+		std::sort(m_pSorted->begin(), m_pSorted->end(), ltstr());
+		m_fSorted = true;
+	}
+	return( *m_pSorted );
 }
 
 LPCTSTR CVarDefMap::FindValStr( LPCTSTR pVal ) const
 {
 	ADDTOCALLSTACK("CVarDefMap::FindValStr");
-	for ( DefSet::const_iterator i = m_Container.begin(); i != m_Container.end(); ++i )
+	const std::vector<CVarDefCont *> & sorted = GetSorted();
+	for ( std::vector<CVarDefCont *>::const_iterator i = sorted.begin(); i != sorted.end(); ++i )
 	{
 		const CVarDefCont * pVarBase = (*i);
 		ASSERT( pVarBase );
@@ -244,7 +464,8 @@ LPCTSTR CVarDefMap::FindValStr( LPCTSTR pVal ) const
 LPCTSTR CVarDefMap::FindValNum( INT64 iVal ) const
 {
 	ADDTOCALLSTACK("CVarDefMap::FindValNum");
-	for ( DefSet::const_iterator i = m_Container.begin(); i != m_Container.end(); ++i )
+	const std::vector<CVarDefCont *> & sorted = GetSorted();
+	for ( std::vector<CVarDefCont *>::const_iterator i = sorted.begin(); i != sorted.end(); ++i )
 	{
 		const CVarDefCont * pVarBase = (*i);
 		ASSERT( pVarBase );
@@ -263,28 +484,19 @@ LPCTSTR CVarDefMap::FindValNum( INT64 iVal ) const
 CVarDefCont * CVarDefMap::GetAt( size_t at ) const
 {
 	ADDTOCALLSTACK("CVarDefMap::GetAt");
-	if ( at > m_Container.size() )
+	// In key order.
+	if ( at >= m_dwCount )
 		return( NULL );
 
-	DefSet::iterator i = m_Container.begin();
-	while ( at-- )
-		++i;
-
-	if ( i != m_Container.end() )
-		return( (*i) );
-	else
-		return( NULL );
+	return( GetSorted()[at] );
 }
 
 CVarDefCont * CVarDefMap::GetAtKey( LPCTSTR at ) const
 {
 	ADDTOCALLSTACK("CVarDefMap::GetAtKey");
-	CVarDefContTest * pVarBase = new CVarDefContTest(at);
-	DefSet::iterator i = m_Container.find(pVarBase);
-	delete pVarBase;
-
-	if ( i != m_Container.end() )
-		return( (*i) );
+	DWORD dwSlot;
+	if ( FindSlot(at, CVarDefKeys::GetHash(at), dwSlot) )
+		return( m_pSlots[dwSlot].m_pVar );
 	else
 		return( NULL );
 }
@@ -292,49 +504,23 @@ CVarDefCont * CVarDefMap::GetAtKey( LPCTSTR at ) const
 void CVarDefMap::DeleteAt( size_t at )
 {
 	ADDTOCALLSTACK("CVarDefMap::DeleteAt");
-	if ( at > m_Container.size() )
+	CVarDefCont * pVarBase = GetAt(at);
+	if ( pVarBase == NULL )
 		return;
 
-	DefSet::iterator i = m_Container.begin();
-	while ( at-- ) 
-		++i;
-
-	DeleteAtIterator(i);
+	DeleteAtKey(pVarBase->GetKey());
 }
 
 void CVarDefMap::DeleteAtKey( LPCTSTR at )
 {
 	ADDTOCALLSTACK("CVarDefMap::DeleteAtKey");
-	CVarDefContStr * pVarBased = new CVarDefContStr(at);
-	DefSet::iterator i = m_Container.find(pVarBased);
-	delete pVarBased;
-
-	DeleteAtIterator(i);
-}
-
-void CVarDefMap::DeleteAtIterator( DefSet::iterator it )
-{
-	ADDTOCALLSTACK("CVarDefMap::DeleteAtIterator");
-	if ( it != m_Container.end() )
-	{
-		CVarDefCont *pVarBase = (*it);
-		m_Container.erase(it);
+	DWORD dwSlot;
+	if ( !FindSlot(at, CVarDefKeys::GetHash(at), dwSlot) )
+		return;
 
-		if ( pVarBase )
-		{
-			CVarDefContNum *pVarNum = dynamic_cast<CVarDefContNum *>(pVarBase);
-			if ( pVarNum )
-			{
-				delete pVarNum;
-			}
-			else
-			{
-				CVarDefContStr *pVarStr = dynamic_cast<CVarDefContStr *>(pVarBase);
-				if ( pVarStr )
-					delete pVarStr;
-			}
-		}
-	}
+	CVarDefCont * pVarBase = m_pSlots[dwSlot].m_pVar;
+	RemoveSlot(dwSlot);
+	delete pVarBase;
 }
 
 void CVarDefMap::DeleteKey( LPCTSTR key )
@@ -349,34 +535,33 @@ void CVarDefMap::DeleteKey( LPCTSTR key )
 void CVarDefMap::Empty()
 {
 	ADDTOCALLSTACK("CVarDefMap::Empty");
-	DefSet::iterator i = m_Container.begin();
-	CVarDefCont * pVarBase = NULL;
-	CVarDefContNum * pVarNum = NULL;
-	CVarDefContStr * pVarStr = NULL;
-
-	while ( i != m_Container.end() )
+	if ( m_pSlots != NULL )
 	{
-		pVarBase = (*i);
-		m_Container.erase(i); // This don't free all the resource
-		i = m_Container.begin();
+		for ( DWORD i = 0; i <= m_dwSlotMask; ++i )
+		{
+			CVarDefCont * pVarBase = m_pSlots[i].m_pVar;
+			if ( pVarBase == NULL )
+				continue;
+			m_pSlots[i].m_pVar = NULL;
+			delete pVarBase;
+		}
 
-		if ( pVarBase )
+		// Objects keep few keys, don't hold a big table for nothing.
+		if ( m_dwSlotMask >= 16 )
 		{
-			pVarNum = dynamic_cast<CVarDefContNum *>(pVarBase);
-			if (pVarNum)
-			{
-				delete pVarNum;
-			}
-			else
-			{
-				pVarStr = dynamic_cast<CVarDefContStr *>(pVarBase);
-				if ( pVarStr )
-					delete pVarStr;
-			}
+			delete[] m_pSlots;
+			m_pSlots = NULL;
+			m_dwSlotMask = 0;
 		}
 	}
 
-	m_Container.clear();
+	m_dwCount = 0;
+	m_fSorted = false;
+	if ( m_pSorted != NULL )
+	{
+		delete m_pSorted;
+		m_pSorted = NULL;
+	}
 }
 
 void CVarDefMap::Copy( const CVarDefMap * pArray )
@@ -389,9 +574,10 @@ void CVarDefMap::Copy( const CVarDefMap * pArray )
 	if ( pArray->GetCount() <= 0 )
 		return;
 
-	for ( DefSet::const_iterator i = pArray->m_Container.begin(); i != pArray->m_Container.end(); ++i )
+	for ( DWORD i = 0; i <= pArray->m_dwSlotMask; ++i )
 	{
-		m_Container.insert( (*i)->CopySelf() );
+		if ( pArray->m_pSlots[i].m_pVar != NULL )
+			InsertSlot( pArray->m_pSlots[i].m_pVar->CopySelf() );
 	}
 }
 
@@ -407,9 +593,12 @@ bool CVarDefMap::Compare( const CVarDefMap * pArray )
 
 	if (pArray->GetCount())
 	{
-		for ( DefSet::const_iterator i = pArray->m_Container.begin(); i != pArray->m_Container.end(); ++i )
+		for ( DWORD i = 0; i <= pArray->m_dwSlotMask; ++i )
 		{
-			const CVarDefCont * pVar = (*i);
+			const CVarDefCont * pVar = pArray->m_pSlots[i].m_pVar;
+			if ( pVar == NULL )
+				continue;
+
 			LPCTSTR sKey = pVar->GetKey();
 			if (!GetKey(sKey))
 				return false;
@@ -431,22 +620,26 @@ bool CVarDefMap::CompareAll( const CVarDefMap * pArray )
 
 	if (pArray->GetCount())
 	{
-		for ( DefSet::const_iterator i = pArray->m_Container.begin(); i != pArray->m_Container.end(); ++i )
+		for ( DWORD i = 0; i <= pArray->m_dwSlotMask; ++i )
 		{
-			const CVarDefCont * pVar = (*i);
-			LPCTSTR sKey = pVar->GetKey();
+			const CVarDefCont * pVar = pArray->m_pSlots[i].m_pVar;
+			if ( pVar == NULL )
+				continue;
 
+			LPCTSTR sKey = pVar->GetKey();
 			if (strcmpi(GetKeyStr(sKey, true),pVar->GetValStr()))
 				return false;
 		}
 	}
 	if (GetCount())
 	{
-		for ( DefSet::const_iterator i = m_Container.begin(); i != m_Container.end(); ++i )
+		for ( DWORD i = 0; i <= m_dwSlotMask; ++i )
 		{
-			const CVarDefCont * pVar = (*i);
-			LPCTSTR sKey = pVar->GetKey();
+			const CVarDefCont * pVar = m_pSlots[i].m_pVar;
+			if ( pVar == NULL )
+				continue;
 
+			LPCTSTR sKey = pVar->GetKey();
 			if (strcmpi(pArray->GetKeyStr(sKey, true),pVar->GetValStr()))
 				return false;
 		}
@@ -457,21 +650,22 @@ bool CVarDefMap::CompareAll( const CVarDefMap * pArray )
 size_t CVarDefMap::GetCount() const
 {
 	ADDTOCALLSTACK("CVarDefMap::GetCount");
-	return m_Container.size();
+	return m_dwCount;
 }
 
 int CVarDefMap::SetNumNew( LPCTSTR pszName, INT64 iVal )
 {
 	ADDTOCALLSTACK("CVarDefMap::SetNumNew");
+	DWORD dwSlot;
+	if ( FindSlot(pszName, CVarDefKeys::GetHash(pszName), dwSlot) )
+		return -1;
+
 	CVarDefCont * pVarNum = new CVarDefContNum( pszName, iVal );
 	if ( !pVarNum )
 		return( -1 );
 
-	DefPairResult res = m_Container.insert(pVarNum);
-	if ( res.second )
-		return static_cast<int>(std::distance(m_Container.begin(), res.first));
-	else
-		return -1;
+	InsertSlot(pVarNum);
+	return static_cast<int>(m_dwCount - 1);
 }
 
 int CVarDefMap::SetNumOverride( LPCTSTR pszKey, INT64 iVal )
@@ -484,6 +678,7 @@ int CVarDefMap::SetNumOverride( LPCTSTR pszKey, INT64 iVal )
 int CVarDefMap::SetNum( LPCTSTR pszName, INT64 iVal, bool fZero )
 {
 	ADDTOCALLSTACK("CVarDefMap::SetNum");
+	// RETURN: >= 0 = set, use GetKey() to get it. (not an index for GetAt())
 	ASSERT(pszName);
 
 	if ( pszName[0] == '\0' )
@@ -495,19 +690,13 @@ int CVarDefMap::SetNum( LPCTSTR pszName, INT64 iVal, bool fZero )
 		return( -1 );
 	}
 
-	CVarDefContTest * pVarSearch = new CVarDefContTest(pszName);
-	DefSet::iterator iResult = m_Container.find(pVarSearch);
-	delete pVarSearch;
-
-	CVarDefCont * pVarBase = NULL;
-	if ( iResult != m_Container.end() )
-		pVarBase = (*iResult);
-
-	if ( !pVarBase )
+	DWORD dwSlot;
+	if ( !FindSlot(pszName, CVarDefKeys::GetHash(pszName), dwSlot) )
 	{
 		return SetNumNew( pszName, iVal );
 	}
 
+	CVarDefCont * pVarBase = m_pSlots[dwSlot].m_pVar;
 	CVarDefContNum * pVarNum = dynamic_cast <CVarDefContNum *>( pVarBase );
 	if ( pVarNum )
 	{
@@ -522,21 +711,22 @@ int CVarDefMap::SetNum( LPCTSTR pszName, INT64 iVal, bool fZero )
 		return SetNumOverride( pszName, iVal );
 	}
 
-	return static_cast<int>(std::distance(m_Container.begin(), iResult));
+	return static_cast<int>(dwSlot);
 }
 
 int CVarDefMap::SetStrNew( LPCTSTR pszName, LPCTSTR pszVal )
 {
 	ADDTOCALLSTACK("CVarDefMap::SetStrNew");
+	DWORD dwSlot;
+	if ( FindSlot(pszName, CVarDefKeys::GetHash(pszName), dwSlot) )
+		return -1;
+
 	CVarDefCont * pVarStr = new CVarDefContStr( pszName, pszVal );
 	if ( !pVarStr )
 		return( -1 );
 
-	DefPairResult res = m_Container.insert(pVarStr);
-	if ( res.second )
-		return static_cast<int>(std::distance(m_Container.begin(), res.first));
-	else
-		return -1;
+	InsertSlot(pVarStr);
+	return static_cast<int>(m_dwCount - 1);
 }
 
 int CVarDefMap::SetStrOverride( LPCTSTR pszKey, LPCTSTR pszVal )
@@ -550,6 +740,7 @@ int CVarDefMap::SetStr( LPCTSTR pszName, bool fQuoted, LPCTSTR pszVal, bool fZer
 {
 	ADDTOCALLSTACK("CVarDefMap::SetStr");
 	// ASSUME: This has been clipped of unwanted beginning and trailing spaces.
+	// RETURN: >= 0 = set, use GetKey() to get it. (not an index for GetAt())
 	if ( !pszName || !pszName[0] )
 		return -1;
 
@@ -565,19 +756,13 @@ int CVarDefMap::SetStr( LPCTSTR pszName, bool fQuoted, LPCTSTR pszVal, bool fZer
 		return SetNum( pszName, Exp_GetLLVal( pszVal ), fZero);
 	}
 
-	CVarDefContTest * pVarSearch = new CVarDefContTest(pszName);
-	DefSet::iterator iResult = m_Container.find(pVarSearch);
-	delete pVarSearch;
-
-	CVarDefCont * pVarBase = NULL;
-	if ( iResult != m_Container.end() )
-		pVarBase = (*iResult);
-
-	if ( !pVarBase )
+	DWORD dwSlot;
+	if ( !FindSlot(pszName, CVarDefKeys::GetHash(pszName), dwSlot) )
 	{
 		return SetStrNew( pszName, pszVal );
 	}
 
+	CVarDefCont * pVarBase = m_pSlots[dwSlot].m_pVar;
 	CVarDefContStr * pVarStr = dynamic_cast <CVarDefContStr *>( pVarBase );
 	if ( pVarStr )
 	{
@@ -591,25 +776,16 @@ int CVarDefMap::SetStr( LPCTSTR pszName, bool fQuoted, LPCTSTR pszVal, bool fZer
 		}
 		return SetStrOverride( pszName, pszVal );
 	}
-	return static_cast<int>(std::distance(m_Container.begin(), iResult) );
+	return static_cast<int>(dwSlot);
 }
 
 CVarDefCont * CVarDefMap::GetKey( LPCTSTR pszKey ) const
 {
 	ADDTOCALLSTACK("CVarDefMap::GetKey");
-	CVarDefCont * pReturn = NULL;
-
-	if ( pszKey )
-	{
-		CVarDefContTest * pVarBase = new CVarDefContTest(pszKey);
-		DefSet::const_iterator i = m_Container.find(pVarBase);
-		delete pVarBase;
-		
-		if ( i != m_Container.end() )
-			pReturn = (*i);
-	}
+	if ( pszKey == NULL )
+		return( NULL );
 
-	return( pReturn );
+	return( GetAtKey( pszKey ));
 }
 
 INT64 CVarDefMap::GetKeyNum( LPCTSTR pszKey ) const
@@ -676,7 +852,8 @@ void CVarDefMap::DumpKeys( CTextConsole * pSrc, LPCTSTR pszPrefix ) const
 	if ( pszPrefix == NULL )
 		pszPrefix = "";
 
-	for ( DefSet::const_iterator i = m_Container.begin(); i != m_Container.end(); ++i )
+	const std::vector<CVarDefCont *> & sorted = GetSorted();
+	for ( std::vector<CVarDefCont *>::const_iterator i = sorted.begin(); i != sorted.end(); ++i )
 	{
 		const CVarDefCont * pVar = (*i);
 		pSrc->SysMessagef(pSrc->GetChar()? "%s%s=%s" : "%s%s=%s\n", static_cast<LPCTSTR>(pszPrefix), static_cast<LPCTSTR>(pVar->GetKey()), static_cast<LPCTSTR>(pVar->GetValStr()));
@@ -688,23 +865,20 @@ void CVarDefMap::ClearKeys(LPCTSTR mask)
 	ADDTOCALLSTACK("CVarDefMap::ClearKeys");
 	if ( mask && *mask )
 	{
-		if ( !m_Container.size() )
+		if ( !m_dwCount )
 			return;
 
 		CGString sMask(mask);
 		sMask.MakeLower();
 
-		DefSet::iterator i = m_Container.begin();
-		CVarDefCont * pVarBase = NULL;
-
-		while ( i != m_Container.end() )
+		DWORD i = 0;
+		while ( i <= m_dwSlotMask )
 		{
-			pVarBase = (*i);
-
+			CVarDefCont * pVarBase = m_pSlots[i].m_pVar;
 			if ( pVarBase && ( strstr(pVarBase->GetKey(), sMask.GetPtr()) ) )
 			{
-				DeleteAtIterator(i);
-				i = m_Container.begin();
+				RemoveSlot(i);	// may pull a later one back here, so look at this slot again
+				delete pVarBase;
 			}
 			else
 			{
@@ -733,8 +907,9 @@ void CVarDefMap::r_WritePrefix( CScript & s, LPCTSTR pszPrefix, LPCTSTR pszKeyEx
 	bool bHasPrefix = (pszPrefix && *pszPrefix);
 	bool bHasExclude = (pszKeyExclude && *pszKeyExclude);
 
-	// Write with any prefix.
-	for ( DefSet::const_iterator i = m_Container.begin(); i != m_Container.end(); ++i )
+	// Write with any prefix. (in key order, so saves don't move around)
+	const std::vector<CVarDefCont *> & sorted = GetSorted();
+	for ( std::vector<CVarDefCont *>::const_iterator i = sorted.begin(); i != sorted.end(); ++i )
 	{
 		const CVarDefCont * pVar = (*i);
 		if ( !pVar )
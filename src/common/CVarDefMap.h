@@ -2,12 +2,45 @@
 #define _INC_CVARDEFMAP_H
 #pragma once
 
-#include <set>
+#include <vector>
+
+class CVarDefKeys
+{
+	// Pool of the (lower case) keys of all the TAG/VAR/LOCAL/DEF values, each stored once.
+	// The keys are counted and freed when the last value using them goes.
+public:
+	static const char *m_sClassName;
+
+	static DWORD GetHash( LPCTSTR pszKey );	// case insensitive
+	static LPCTSTR Intern( LPCTSTR pszKey, DWORD dwHash );
+	static void Release( LPCTSTR pszKey );
+	static size_t GetCount();
+#ifndef _WIN32
+	static void LockFork( bool fLock );	// around fork() (SaveFork)
+#endif
+
+private:
+	struct CKeyRec
+	{
+		CKeyRec * m_pNext;		// in the same bucket
+		size_t m_iRefs;
+		DWORD m_dwHash;
+		TCHAR m_szKey[1];		// allocated to fit
+	};
+	static CKeyRec * GetRec( LPCTSTR pszKey );
+	static void Grow();
+
+	static SimpleMutex * sm_pLock;	// allocated on first use and never freed, values may go at exit
+	static CKeyRec ** sm_ppBuckets;
+	static size_t sm_iBuckets;
+	static size_t sm_iCount;
+};
 
 class CVarDefCont
 {
 private:
-	CGString m_Key;	// reference to map key
+	LPCTSTR m_pszKey;	// interned in CVarDefKeys
+	DWORD m_dwHash;		// CVarDefKeys::GetHash(m_pszKey)
 
 public:
 	static const char *m_sClassName;
@@ -21,6 +54,7 @@ private:
 
 public:
 	LPCTSTR GetKey() const;
+	DWORD GetKeyHash() const { return m_dwHash; }
 	void SetKey( LPCTSTR pszKey );
 
 	virtual LPCTSTR GetValStr() const = 0;
@@ -35,6 +69,7 @@ private:
 
 public:
 	static const char *m_sClassName;
+	SLAB_DECLARE
 
 	CVarDefContNum( LPCTSTR pszKey, INT64 iVal );
 	CVarDefContNum( LPCTSTR pszKey );
@@ -62,6 +97,7 @@ private:
 
 public:
 	static const char *m_sClassName;
+	SLAB_DECLARE
 
 	CVarDefContStr( LPCTSTR pszKey, LPCTSTR pszVal );
 	explicit CVarDefContStr( LPCTSTR pszKey );
@@ -88,41 +124,36 @@ class CVarDefMap
 private:
 	struct ltstr
 	{
-		bool operator()(CVarDefCont * s1, CVarDefCont * s2) const;
+		bool operator()(const CVarDefCont * s1, const CVarDefCont * s2) const;
 	};
 
-	typedef std::set<CVarDefCont *, ltstr> DefSet;
-	typedef std::pair<DefSet::iterator, bool> DefPairResult;
-
-	class CVarDefContTest : public CVarDefCont // This is to alloc CVarDefCont without allocing any other things
+	struct CVarDefSlot
 	{
-		public:
-			static const char *m_sClassName;
-
-			CVarDefContTest( LPCTSTR pszKey );
-			~CVarDefContTest();
-
-		private:
-			CVarDefContTest(const CVarDefContTest& copy);
-			CVarDefContTest& operator=(const CVarDefContTest& other);
-
-		public:
-			LPCTSTR GetValStr() const;
-			INT64 GetValNum() const;
-			virtual CVarDefCont * CopySelf() const;
+		DWORD m_dwHash;
+		CVarDefCont * m_pVar;	// NULL = free
 	};
 
 private:
-	DefSet m_Container;
+	// Open addressing (linear probing) on the key hash.
+	CVarDefSlot * m_pSlots;		// NULL until the first key is set
+	DWORD m_dwSlotMask;			// slot count - 1 (power of 2)
+	DWORD m_dwCount;
+	mutable std::vector<CVarDefCont *> * m_pSorted;	// keys in order, built for GetAt() and saves
+	mutable bool m_fSorted;
 
 public:
 	static const char *m_sClassName;
 
 private:
+	bool FindSlot( LPCTSTR pszKey, DWORD dwHash, DWORD & dwSlot ) const;
+	void InsertSlot( CVarDefCont * pVar );
+	void RemoveSlot( DWORD dwSlot );
+	void Grow();
+	const std::vector<CVarDefCont *> & GetSorted() const;
+
 	CVarDefCont * GetAtKey( LPCTSTR at ) const;
 	void DeleteAt( size_t at );
 	void DeleteAtKey( LPCTSTR at );
-	void DeleteAtIterator( DefSet::iterator it );
 
 	int SetNumOverride( LPCTSTR pszKey, INT64 iVal );
 	int SetStrOverride( LPCTSTR pszKey, LPCTSTR pszVal );
@@ -135,7 +166,14 @@ public:
 	size_t GetCount() const;
 
 public:
-	CVarDefMap() { };
+	CVarDefMap()
+	{
+		m_pSlots = NULL;
+		m_dwSlotMask = 0;
+		m_dwCount = 0;
+		m_pSorted = NULL;
+		m_fSorted = false;
+	};
 	~CVarDefMap();
 	CVarDefMap & operator = ( const CVarDefMap & array );
 
@@ -707,9 +707,9 @@ RealType CVarFloat::GetRandVal( RealType dQty )
 		return( 0 );
 	if ( dQty >= INT_MAX )
 	{
-		return( static_cast<RealType>(IMULDIV( g_World.m_Rand.randDblExc(), dQty, INT_MAX)) );
+		return( static_cast<RealType>(IMULDIV( CSectorTicker::GetRand().randDblExc(), dQty, INT_MAX)) );
 	}
-	return g_World.m_Rand.randDblExc(dQty);
+	return CSectorTicker::GetRand().randDblExc(dQty);
 }
 
 RealType CVarFloat::GetRandVal2( RealType dMin, RealType dMax )
@@ -722,7 +722,7 @@ RealType CVarFloat::GetRandVal2( RealType dMin, RealType dMax )
 		dMax = tmp;
 	}
 	//DEBUG_ERR(("GetRandVal2\n"));
-	return ( dMin + g_World.m_Rand.randDblExc(dMax) ); //These weird numbers are taken from mtrand.cpp (cause calling that function from here spits out some weird external errors)
+	return ( dMin + CSectorTicker::GetRand().randDblExc(dMax) ); //These weird numbers are taken from mtrand.cpp (cause calling that function from here spits out some weird external errors)
 }
 
 //Does not work as it should, would be too slow, and nobody needs that
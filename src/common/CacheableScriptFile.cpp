@@ -7,6 +7,7 @@ CacheableScriptFile::CacheableScriptFile()
 	m_realFile = false;
 	m_currentLine = 0;
 	m_fileContent = NULL;
+	m_fileCompiled = NULL;
 }
 
 CacheableScriptFile::~CacheableScriptFile() 
@@ -82,9 +83,14 @@ void CacheableScriptFile::CloseBase()
 				m_fileContent->clear();
 				delete m_fileContent;
 			}
+			if ( m_fileCompiled != NULL )
+			{
+				delete m_fileCompiled;
+			}
 		}
 
 		m_fileContent = NULL;
+		m_fileCompiled = NULL;
 		m_currentLine = 0;
 		m_closed = true;
 	}
@@ -180,6 +186,33 @@ void CacheableScriptFile::dupeFrom(CacheableScriptFile *other)
 	m_closed = other->m_closed;
 	m_realFile = false;
 	m_fileContent = other->m_fileContent;
+	m_fileCompiled = other->m_fileCompiled;
+}
+
+bool CacheableScriptFile::InitCompiledLines()
+{
+	// Make sure there is a compiled line slot for each line of the file
+	if( useDefaultFile() || !m_realFile || m_fileContent == NULL )
+	{
+		return false;
+	}
+
+	ADDTOCALLSTACK("CacheableScriptFile::InitCompiledLines");
+	if ( m_fileCompiled == NULL )
+	{
+		m_fileCompiled = new std::vector<CScriptCompiledLine>(m_fileContent->size());
+	}
+	return true;
+}
+
+CScriptCompiledLine * CacheableScriptFile::GetCompiledLine( DWORD dwLine ) const
+{
+	if( useDefaultFile() || m_fileCompiled == NULL || dwLine >= m_fileCompiled->size() )
+	{
+		return NULL;
+	}
+
+	return &(m_fileCompiled->at(dwLine));
 }
 
 bool CacheableScriptFile::useDefaultFile() const 
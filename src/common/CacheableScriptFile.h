@@ -4,6 +4,22 @@
 #include "CFile.h"
 #include <string>
 
+#define SCRIPTLINE_UNCOMPILED	-2		// line has not been through the trigger compiler
+#define SCRIPTLINE_NOSKIP		0xFFFFFFFF	// no known end for a block skipped after this line
+
+struct CScriptCompiledLine
+{
+	// Pre-resolved form of a single cached script line.
+	// Filled by CScriptObj::OnTriggerCompile() at resource load, used by OnTriggerRun().
+	short m_iKeyword;		// index in CScriptObj::sm_szScriptKeys (-1 = not a script keyword)
+	BYTE m_bSkipRet;		// TRIGRET_TYPE returned when the block following this line is skipped
+	DWORD m_dwSkipLine;		// line that ends the block following this line when it is skipped
+
+	CScriptCompiledLine() : m_iKeyword(SCRIPTLINE_UNCOMPILED), m_bSkipRet(0), m_dwSkipLine(SCRIPTLINE_NOSKIP)
+	{
+	}
+};
+
 class CacheableScriptFile : public CFileText
 {
 protected:
@@ -25,6 +41,9 @@ public:
 	virtual DWORD Seek(LONG offset = 0, UINT origin = SEEK_SET);
 	virtual DWORD GetPosition() const;
 
+	bool InitCompiledLines();
+	CScriptCompiledLine * GetCompiledLine( DWORD dwLine ) const;
+
 private:
 	bool m_closed;
 	bool m_realFile;
@@ -32,6 +51,7 @@ private:
 
 protected:
 	std::vector<std::string> * m_fileContent;
+	std::vector<CScriptCompiledLine> * m_fileCompiled;	// shared like m_fileContent, allocated on first compile
 
 private:
 	bool useDefaultFile() const;
@@ -48,6 +48,7 @@ typedef THREAD_ENTRY_RET ( _cdecl * PTHREAD_ENTRY_PROC )(void *);
 #define SPHERE_FILE			"sphere"	// file name prefix
 #define SPHERE_TITLE		"Sphere"
 #define SPHERE_SCRIPT		".scp"
+#define SPHERE_SCRIPT_BIN	".bin"	// binary world saves (SaveBinary)
 
 #define SCRIPT_MAX_LINE_LEN 4096	// default size.
 
@@ -151,6 +151,7 @@
 
 #include "CArray.h"
 #include "CString.h"
+#include "CSlab.h"
 #include "CFile.h"
 #include "CScript.h"
 
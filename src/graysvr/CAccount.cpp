@@ -113,12 +113,13 @@ bool CAccounts::Account_LoadAll( bool fChanges, bool fClearChanges )
 }
 
 
-bool CAccounts::Account_SaveAll()
+bool CAccounts::Account_SaveAll( bool fLoadChanges )
 {
 	ADDTOCALLSTACK("CAccounts::Account_SaveAll");
 	EXC_TRY("SaveAll");
 	// Look for changes FIRST.
-	Account_LoadAll(true);
+	if ( fLoadChanges )
+		Account_LoadAll(true);
 
 	LPCTSTR pszBaseDir;
 
@@ -141,7 +142,8 @@ bool CAccounts::Account_SaveAll()
 			pAccount->r_Write(s);
 	}
 
-	Account_LoadAll(true, true);	// clear the change file now.
+	if ( fLoadChanges )
+		Account_LoadAll(true, true);	// clear the change file now.
 	return true;
 	EXC_CATCH;
 	return false;
@@ -391,9 +391,10 @@ private:
 public:
 	/**
 	* @brief Save the accounts file.
+	* @param fLoadChanges false if the acct changes file was already merged and cleared. (SaveFork)
 	* @return true if successfully saved, false otherwise.
 	*/
-	bool Account_SaveAll();
+	bool Account_SaveAll( bool fLoadChanges = true );
 	/**
 	* @brief Load a single account. 
 	* @see Account_LoadAll()
@@ -212,6 +212,8 @@ CChar * CChar::CreateNPC( CREID_TYPE baseID )	// static
 	return pChar;
 }
 
+SLAB_IMPLEMENT(CChar);
+
 CChar::CChar( CREID_TYPE baseID ) : CObjBase( false )
 {
 	g_Serv.StatInc( SERV_STAT_CHARS );	// Count created CChars.
@@ -399,7 +401,7 @@ void CChar::SetDisconnected()
 
 	RemoveFromView();
 	MoveToRegion(NULL, false);
-	GetTopSector()->m_Chars_Disconnect.InsertHead(this);
+	GetTopSector()->MoveDisconnectedCharToSector(this);
 }
 
 // Called before Delete()
@@ -1079,10 +1081,7 @@ void CChar::NPC_CreateTrigger()
 		CResourceLink * pLink = pCharDef->m_TEvents[i];
 		if (!pLink || !pLink->HasTrigger(iAction))
 			continue;
-		CResourceLock s;
-		if (!pLink->ResourceLock(s))
-			continue;
-		iRet = CScriptObj::OnTriggerScript(s, pszTrigName, this, 0);
+		iRet = CScriptObj::OnTriggerScript(pLink, iAction, pszTrigName, this, 0);
 		if (iRet != TRIGRET_RET_FALSE && iRet != TRIGRET_RET_DEFAULT)
 			return;
 	}
@@ -1093,10 +1092,7 @@ void CChar::NPC_CreateTrigger()
 		CResourceLink * pLink = g_Cfg.m_pEventsPetLink[i];
 		if (!pLink || !pLink->HasTrigger(iAction))
 			continue;
-		CResourceLock s;
-		if (!pLink->ResourceLock(s))
-			continue;
-		iRet = CScriptObj::OnTriggerScript(s, pszTrigName, this, 0);
+		iRet = CScriptObj::OnTriggerScript(pLink, iAction, pszTrigName, this, 0);
 		if (iRet != TRIGRET_RET_FALSE && iRet != TRIGRET_RET_DEFAULT)
 			return;
 	}
@@ -1299,6 +1295,8 @@ LPCTSTR const CChar::sm_szLoadKeys[CHC_QTY+1] =
 	NULL
 };
 
+const CTableHash CChar::sm_LoadKeysHash(CChar::sm_szLoadKeys, CHC_QTY);
+
 bool CChar::r_WriteVal( LPCTSTR pszKey, CGString & sVal, CTextConsole * pSrc )
 {
 	ADDTOCALLSTACK("CChar::r_WriteVal");
@@ -1312,7 +1310,7 @@ bool CChar::r_WriteVal( LPCTSTR pszKey, CGString & sVal, CTextConsole * pSrc )
 	ASSERT(pCharDef);
 	CChar * pCharSrc = pSrc->GetChar();
 
-	CHC_TYPE iKeyNum = (CHC_TYPE) FindTableHeadSorted( pszKey, sm_szLoadKeys, COUNTOF( sm_szLoadKeys )-1 );
+	CHC_TYPE iKeyNum = (CHC_TYPE) sm_LoadKeysHash.FindHead( pszKey );
 	if ( iKeyNum < 0 )
 	{
 do_default:
@@ -2178,7 +2176,7 @@ bool CChar::r_LoadVal( CScript & s )
 	ADDTOCALLSTACK("CChar::r_LoadVal");
 	EXC_TRY("LoadVal");
 	LPCTSTR	pszKey	=  s.GetKey();
-	CHC_TYPE iKeyNum = (CHC_TYPE) FindTableHeadSorted( pszKey, sm_szLoadKeys, COUNTOF( sm_szLoadKeys )-1 );
+	CHC_TYPE iKeyNum = (CHC_TYPE) sm_LoadKeysHash.FindHead( pszKey );
 	if ( iKeyNum < 0 )
 	{
 do_default:
@@ -2855,6 +2853,8 @@ LPCTSTR const CChar::sm_szVerbKeys[CHV_QTY+1] =
 	NULL
 };
 
+const CTableHash CChar::sm_VerbKeysHash(CChar::sm_szVerbKeys, CHV_QTY);
+
 bool CChar::r_Verb( CScript &s, CTextConsole * pSrc ) // Execute command from script
 {
 	ADDTOCALLSTACK("CChar::r_Verb");
@@ -2865,7 +2865,7 @@ bool CChar::r_Verb( CScript &s, CTextConsole * pSrc ) // Execute command from sc
 
 	EXC_TRY("Verb");
 
-	int index = FindTableSorted( s.GetKey(), sm_szVerbKeys, COUNTOF(sm_szVerbKeys)-1 );
+	int index = sm_VerbKeysHash.Find( s.GetKey() );
 	if ( index < 0 )
 		return ((m_pNPC && NPC_OnVerb(s, pSrc)) || (m_pPlayer && Player_OnVerb(s, pSrc)) || CObjBase::r_Verb(s, pSrc));
 
@@ -133,6 +133,8 @@ LPCTSTR const CCharPlayer::sm_szLoadKeys[CPC_QTY+1] =
 	NULL
 };
 
+SLAB_IMPLEMENT(CCharPlayer);
+
 CCharPlayer::CCharPlayer(CChar *pChar, CAccount *pAccount) : m_pAccount(pAccount)
 {
 	m_wDeaths = m_wMurders = 0;
@@ -684,6 +686,8 @@ bool CChar::Player_OnVerb( CScript &s, CTextConsole * pSrc )
 //////////////////////////
 // -CCharNPC
 
+SLAB_IMPLEMENT(CCharNPC);
+
 CCharNPC::CCharNPC( CChar * pChar, NPCBRAIN_TYPE NPCBrain )
 {
 	UNREFERENCED_PARAMETER(pChar);
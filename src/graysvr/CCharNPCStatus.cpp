@@ -318,6 +318,13 @@ bool CChar::NPC_CheckWalkHere(const CPointBase &pt, const CRegionBase *pArea, WO
 	}
 
 	// Is there a nasty object here that will hurt us ?
+	if ( g_Cfg.m_fWalkCache )
+	{
+		CSector *pSector = pt.GetSector();
+		if ( pSector && !pSector->IsWalkHazard(pt) )
+			return true;
+	}
+
 	CWorldSearch AreaItems(pt);
 	for (;;)
 	{
@@ -328,7 +335,7 @@ bool CChar::NPC_CheckWalkHere(const CPointBase &pt, const CRegionBase *pArea, WO
 		if ( abs(pItem->GetTopZ() - pt.m_z) > 5 )
 			continue;
 
-		switch ( pItem->GetType() )
+		switch ( pItem->GetType() )	// keep in sync with CSectorBase::IsWalkHazard()
 		{
 			case IT_WEB:
 				return (GetDispID() == CREID_GIANT_SPIDER) ? true : false;
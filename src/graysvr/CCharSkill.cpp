@@ -3722,9 +3722,7 @@ TRIGRET_TYPE CChar::Skill_OnTrigger( SKILL_TYPE skill, SKTRIG_TYPE stage, CScrip
 	if ( pSkillDef && pSkillDef->HasTrigger(stage) )
 	{
 		// RES_SKILL
-		CResourceLock s;
-		if ( pSkillDef->ResourceLock(s) )
-			iRet = CScriptObj::OnTriggerScript(s, CSkillDef::sm_szTrigName[stage], this, pArgs);
+		iRet = CScriptObj::OnTriggerScript(pSkillDef, stage, CSkillDef::sm_szTrigName[stage], this, pArgs);
 	}
 
 	return iRet;
@@ -431,7 +431,7 @@ bool CChar::Spell_Resurrection(CItemCorpse *pCorpse, CChar *pCharSrc, bool bNoFa
 	if ( m_pNPC && m_pNPC->m_bonded )
 		m_Can &= ~CAN_C_GHOST;
 
-	ClientIterator it;
+	ClientAreaIterator it(this);
 	for ( CClient* pClient = it.next(); pClient != NULL; pClient = it.next() )
 	{
 		if ( !pClient->CanSee(this) )
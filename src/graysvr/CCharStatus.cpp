@@ -1102,11 +1102,116 @@ blocked:
 }
 
 // a - gradient < x < b + gradient
-#define BETWEENPOINT(coord, coordt, coords) ( (coord > ((double)minimum(coordt, coords) - 0.5)) && (coord < ((double)maximum(coordt, coords) + 0.5)) )
-#define APPROX(num) ((double)((num - floor(num)) > 0.5)? ceil(num) : floor(num))
 //#define CALCITEMHEIGHT(num) num + ((pItemDef->GetTFlags() & 0x400)? pItemDef->GetHeight() / 2 : pItemDef->GetHeight())
 #define WARNLOS(_x_)		if ( g_Cfg.m_wDebugFlags & DEBUGF_LOS ) { g_pLog->EventWarn _x_; }
 
+class CCharLOSPath
+{
+	// Points of a line of sight from ptSrc (at eye height) to ptDst, one at a time.
+	// The ray is walked with an integer DDA along its longest axis. When x and y step together
+	// the two tiles beside the diagonal are visited first, and the step only blocks when both of them
+	// do: the ray can't slip through a wall joint, but isn't stopped by a single wall corner either.
+public:
+	CCharLOSPath( const CPointMap &ptSrc, const CPointMap &ptDst ) : m_pt(ptSrc), m_iStep(0), m_iQueued(0)
+	{
+		int dx = ptDst.m_x - ptSrc.m_x;
+		int dy = ptDst.m_y - ptSrc.m_y;
+		int dz = ptDst.m_z - ptSrc.m_z;
+		m_ax = abs(dx);
+		m_ay = abs(dy);
+		m_az = abs(dz);
+		m_sx = (dx > 0) ? 1 : ((dx < 0) ? -1 : 0);
+		m_sy = (dy > 0) ? 1 : ((dy < 0) ? -1 : 0);
+		m_sz = (dz > 0) ? 1 : ((dz < 0) ? -1 : 0);
+		m_iSteps = maximum(maximum(m_ax, m_ay), m_az);
+		m_ex = m_ey = m_ez = m_iSteps / 2;
+	}
+
+private:
+	CCharLOSPath(const CCharLOSPath& copy);
+	CCharLOSPath& operator=(const CCharLOSPath& other);
+
+public:
+	bool IsFirstSide() const
+	{
+		// last point was the x neighbour of a diagonal step
+		return (m_iQueued == 2);
+	}
+	void SkipSide()
+	{
+		// the first side is open, go on with the diagonal
+		if ( m_iQueued == 2 )
+			m_iQueued = 1;
+	}
+
+	bool Next( CPointMap &pt )
+	{
+		if ( m_iQueued > 0 )
+		{
+			pt = m_ptQueue[--m_iQueued];
+			return true;
+		}
+		if ( m_iStep > m_iSteps )
+			return false;
+		if ( m_iStep++ == 0 )
+		{
+			pt = m_pt;
+			return true;
+		}
+
+		bool fStepX = false, fStepY = false;
+		m_ex += m_ax;
+		if ( m_ex >= m_iSteps )
+		{
+			m_ex -= m_iSteps;
+			fStepX = true;
+		}
+		m_ey += m_ay;
+		if ( m_ey >= m_iSteps )
+		{
+			m_ey -= m_iSteps;
+			fStepY = true;
+		}
+		m_ez += m_az;
+		if ( m_ez >= m_iSteps )
+		{
+			m_ez -= m_iSteps;
+			m_pt.m_z = static_cast<signed char>(m_pt.m_z + m_sz);
+		}
+
+		if ( fStepX && fStepY )
+		{
+			// the queue is read backwards: x neighbour, y neighbour, then the diagonal
+			m_ptQueue[1] = m_pt;
+			m_ptQueue[1].m_y = static_cast<short>(m_pt.m_y + m_sy);
+			m_ptQueue[0] = m_pt;
+			m_ptQueue[0].m_x = static_cast<short>(m_pt.m_x + m_sx);
+			m_ptQueue[0].m_y = static_cast<short>(m_pt.m_y + m_sy);
+			m_iQueued = 2;
+			pt = m_pt;
+			pt.m_x = static_cast<short>(m_pt.m_x + m_sx);
+			m_pt = m_ptQueue[0];
+			return true;
+		}
+
+		if ( fStepX )
+			m_pt.m_x = static_cast<short>(m_pt.m_x + m_sx);
+		if ( fStepY )
+			m_pt.m_y = static_cast<short>(m_pt.m_y + m_sy);
+		pt = m_pt;
+		return true;
+	}
+
+private:
+	CPointMap m_pt;				// last point reached by the DDA
+	int m_ax, m_ay, m_az;
+	int m_sx, m_sy, m_sz;
+	int m_ex, m_ey, m_ez;
+	int m_iStep, m_iSteps;
+	CPointMap m_ptQueue[2];		// points of a diagonal step still to visit
+	int m_iQueued;
+};
+
 bool inline CChar::CanSeeLOS_New_Failed( CPointMap *pptBlock, CPointMap &ptNow ) const
 {
 	ADDTOCALLSTACK("CChar::CanSeeLOS_New_Failed");
@@ -1135,76 +1240,19 @@ bool CChar::CanSeeLOS_New( const CPointMap &ptDst, CPointMap *pptBlock, int iMax
 	ptSrc.m_z = minimum(ptSrc.m_z + GetHeightMount(true), UO_SIZE_Z);	//true - substract one from the height because of eyes height
 	WARNLOS(("Total Z: %d\n", ptSrc.m_z));
 
-	int dx, dy, dz;
-	dx = ptDst.m_x - ptSrc.m_x;
-	dy = ptDst.m_y - ptSrc.m_y;
-	dz = ptDst.m_z - ptSrc.m_z;
+	int dx = ptDst.m_x - ptSrc.m_x;
+	int dy = ptDst.m_y - ptSrc.m_y;
 
-	double dist2d, dist3d;
-	dist2d = sqrt(static_cast<double>(dx*dx + dy*dy));
-	if ( dz )
-		dist3d = sqrt(static_cast<double>(dist2d*dist2d + dz*dz));
-	else
-		dist3d = dist2d;
-	
-	if ( APPROX(dist2d) > static_cast<double>(iMaxDist) )
+	// round(dist2d) > iMaxDist, rounding .5 down
+	if ( 4 * (dx*dx + dy*dy) > (2*iMaxDist + 1) * (2*iMaxDist + 1) )
 	{
-		WARNLOS(("( APPROX(dist2d)(%f) > ((double)iMaxDist)(%f) ) --> NOLOS\n", APPROX(dist2d), (double)iMaxDist));
+		WARNLOS(("( dist2d(%d,%d) > iMaxDist(%d) ) --> NOLOS\n", dx, dy, iMaxDist));
 		return CanSeeLOS_New_Failed(pptBlock, ptNow);
 	}
-	
-	double dFactorX, dFactorY, dFactorZ;
-	dFactorX = dx / dist3d;
-	dFactorY = dy / dist3d;
-	dFactorZ = dz / dist3d;
-	
-	double nPx, nPy, nPz;
-	nPx = ptSrc.m_x;
-	nPy = ptSrc.m_y;
-	nPz = ptSrc.m_z;
-	
-	std::vector<CPointMap> path;
-	for (;;)
-	{
-		if ( BETWEENPOINT(nPx, ptDst.m_x, ptSrc.m_x) && BETWEENPOINT(nPy, ptDst.m_y, ptSrc.m_y) && BETWEENPOINT(nPz, ptDst.m_z, ptSrc.m_z) )
-		{
-			dx = (int)APPROX(nPx);
-			dy = (int)APPROX(nPy);
-			dz = (int)APPROX(nPz);
 
-			// Add point to vector
-			if ( path.size() )
-			{
-				CPointMap ptEnd = path.at(path.size() - 1);
-				if ( ptEnd.m_x != dx || ptEnd.m_y != dy || ptEnd.m_z != dz )
-					path.push_back(CPointMap(static_cast<WORD>(dx), static_cast<WORD>(dy), static_cast<signed char>(dz), ptSrc.m_map));
-			}
-			else
-			{
-				path.push_back(CPointMap(static_cast<WORD>(dx), static_cast<WORD>(dy), static_cast<signed char>(dz), ptSrc.m_map));
-			}
-			WARNLOS(("PATH X:%d Y:%d Z:%d\n", dx, dy, dz));
+	// Each point of the path is checked as soon as it is reached.
+	CCharLOSPath path(ptSrc, ptDst);
 
-			nPx += dFactorX;
-			nPy += dFactorY;
-			nPz += dFactorZ;
-		}
-		else
-			break;
-	}
-	
-	if ( path.size() )
-	{
-		if ( path.at(path.size() - 1) != ptDst )
-			path.push_back(CPointMap(ptDst.m_x, ptDst.m_y, ptDst.m_z, ptDst.m_map));
-	}
-	else
-	{
-		path.clear();
-		return CanSeeLOS_New_Failed(pptBlock, ptNow);
-	}
-	
-	WARNLOS(("Path calculated %" FMTSIZE_T "\n", path.size()));
 	// Ok now we should loop through all the points and checking for maptile, staticx, items, multis.
 	// If something is in the way and it has the wrong flags LOS return false
 	
@@ -1227,42 +1275,42 @@ bool CChar::CanSeeLOS_New( const CPointMap &ptDst, CPointMap *pptBlock, int iMax
 	CRegionBase *pSrcRegion = ptSrc.GetRegion(REGION_TYPE_AREA|REGION_TYPE_ROOM|REGION_TYPE_MULTI);
 	CRegionBase *pNowRegion = NULL;
 	
-	int lp_x = 0, lp_y = 0; 
+	int lp_x = -1, lp_y = -1;
 	signed char min_z = 0, max_z = 0;
 	
-	for (size_t i = 0; i < path.size(); lp_x = ptNow.m_x, lp_y = ptNow.m_y, pItemDef = NULL, pStatic = NULL, pMulti = NULL, pMultiItem = NULL, min_z = 0, max_z = 0, ++i )
+	for ( ; path.Next(ptNow); lp_x = ptNow.m_x, lp_y = ptNow.m_y, pItemDef = NULL, pStatic = NULL, pMulti = NULL, pMultiItem = NULL, min_z = 0, max_z = 0 )
 	{
-		ptNow = path.at(i);
 		WARNLOS(("---------------------------------------------\n"));
 		WARNLOS(("Point %d,%d,%d \n", ptNow.m_x, ptNow.m_y, ptNow.m_z));
 
-		pNowRegion = ptNow.GetRegion(REGION_TYPE_AREA|REGION_TYPE_ROOM|REGION_TYPE_MULTI);
-
-		if ( (flags & LOS_NO_OTHER_REGION) && (pSrcRegion != pNowRegion) )
+		// load the block first, lp_x/lp_y are set even when this point blocks
+		if ( UO_BLOCK_ALIGN(lp_x) != UO_BLOCK_ALIGN(ptNow.m_x) || UO_BLOCK_ALIGN(lp_y) != UO_BLOCK_ALIGN(ptNow.m_y) || !pBlock )
 		{
-			WARNLOS(("flags & 0200 and path is leaving my region - BLOCK\n"));
-			bPath = false;
-			break;
+			WARNLOS(("\tLoading new map block.\n"));
+			pBlock = g_World.GetMapBlock(ptNow);
 		}
 
-		if ( (flags & LOS_NC_MULTI) && ptNow.GetRegion(REGION_TYPE_MULTI) && (ptNow.GetRegion(REGION_TYPE_MULTI) != ptSrc.GetRegion(REGION_TYPE_MULTI)) )
+		if ( !pBlock ) // something is wrong
 		{
-			WARNLOS(("flags & 0400 and path is crossing another multi - BLOCK\n"));
+			WARNLOS(("GetMapBlock Failed\n"));
 			bPath = false;
-			break;
+			goto pointchecked;
 		}
 
-		if ( lp_x != ptNow.m_x || lp_y != ptNow.m_y )
+		pNowRegion = ptNow.GetRegion(REGION_TYPE_AREA|REGION_TYPE_ROOM|REGION_TYPE_MULTI);
+
+		if ( (flags & LOS_NO_OTHER_REGION) && (pSrcRegion != pNowRegion) )
 		{
-			WARNLOS(("\tLoading new map block.\n"));
-			pBlock = g_World.GetMapBlock(ptNow);
+			WARNLOS(("flags & 0200 and path is leaving my region - BLOCK\n"));
+			bPath = false;
+			goto pointchecked;
 		}
 
-		if ( !pBlock ) // something is wrong
+		if ( (flags & LOS_NC_MULTI) && ptNow.GetRegion(REGION_TYPE_MULTI) && (ptNow.GetRegion(REGION_TYPE_MULTI) != ptSrc.GetRegion(REGION_TYPE_MULTI)) )
 		{
-			WARNLOS(("GetMapBlock Failed\n"));
+			WARNLOS(("flags & 0400 and path is crossing another multi - BLOCK\n"));
 			bPath = false;
-			break;
+			goto pointchecked;
 		}
 
 		if ( !(flags & LOS_NB_TERRAIN) )
@@ -1278,7 +1326,7 @@ bool CChar::CanSeeLOS_New( const CPointMap &ptDst, CPointMap *pptBlock, int iMax
 					WARNLOS(("Terrain %d blocked - flags & LOS_FISHING, distance >= 2 and type of pItemDef is not IT_WATER\n", terrainid));
 					WARNLOS(("ptSrc: %d,%d,%d; ptNow: %d,%d,%d; terrainid: %d; terrainid type: %d\n", ptSrc.m_x, ptSrc.m_y, ptSrc.m_z, ptNow.m_x, ptNow.m_y, ptNow.m_z, terrainid, g_World.GetTerrainItemType(terrainid)));
 					bPath = false;
-					break;
+					goto pointchecked;
 				}
 
 				//#define MAPTILEMIN minimum(minimum(minimum(pBlock->GetTerrain(0,0)->m_z, pBlock->GetTerrain(0,1)->m_z), pBlock->GetTerrain(1,0)->m_z), pBlock->GetTerrain(1,1)->m_z)
@@ -1315,7 +1363,7 @@ bool CChar::CanSeeLOS_New( const CPointMap &ptDst, CPointMap *pptBlock, int iMax
 						{
 							WARNLOS(("Terrain %d - m:%d M:%d - block\n", terrainid, min_z, max_z));
 							bPath = false;
-							break;
+							goto pointchecked;
 						}
 						CGrayTerrainInfo land(terrainid);
 						if ( (land.m_flags & UFLAG1_WATER) && (flags & LOS_NC_WATER) )
@@ -1333,14 +1381,30 @@ bool CChar::CanSeeLOS_New( const CPointMap &ptDst, CPointMap *pptBlock, int iMax
 		{
 			if ( !((flags & LOS_NB_LOCAL_STATIC) && (pSrcRegion == pNowRegion)) )
 			{
-				for ( size_t s = 0; s < pBlock->m_Statics.GetStaticQty(); pStatic = NULL, pItemDef = NULL, ++s )
+				// Most points can be passed from the summary of their statics alone, the point
+				// of the target and fishing need to look at each of them.
+				const CGrayStaticsLOS &los = pBlock->GetStaticsLOS(UO_BLOCK_OFFSET(ptNow.m_x), UO_BLOCK_OFFSET(ptNow.m_y));
+				size_t iStatics = pBlock->m_Statics.GetStaticQty();
+				if ( !(los.m_bFlags & LOSSTATIC_ANY) )
+				{
+					iStatics = 0;
+				}
+				else if ( !(flags & LOS_FISHING) && (ptNow.m_x != ptDst.m_x || ptNow.m_y != ptDst.m_y) &&
+					(!(los.m_bFlags & LOSSTATIC_BLOCK) || (ptNow.m_z < los.m_zBottom) || (ptNow.m_z > los.m_zTop)) )
+				{
+					WARNLOS(("Statics pass - m:%d M:%d\n", los.m_zBottom, los.m_zTop));
+					bNullTerrain = false;
+					iStatics = 0;
+				}
+
+				for ( size_t s = 0; s < iStatics; pStatic = NULL, pItemDef = NULL, ++s )
 				{
 					pStatic = pBlock->m_Statics.GetStatic(s);
 					if ( pStatic->m_x + pBlock->m_x != ptNow.m_x || pStatic->m_y + pBlock->m_y != ptNow.m_y )
 						continue;
 
 					//Fix for Stacked items blocking view
-					if ( (pStatic->m_x == ptDst.m_x) && (pStatic->m_y == ptDst.m_y) && (pStatic->m_z >= GetTopZ()) && (pStatic->m_z <= ptSrc.m_z) )
+					if ( (pStatic->m_x + pBlock->m_x == ptDst.m_x) && (pStatic->m_y + pBlock->m_y == ptDst.m_y) && (pStatic->m_z >= GetTopZ()) && (pStatic->m_z <= ptSrc.m_z) )
 						continue;
 
 					pItemDef = CItemBase::FindItemBase(pStatic->GetDispID());
@@ -1411,7 +1475,7 @@ bool CChar::CanSeeLOS_New( const CPointMap &ptDst, CPointMap *pptBlock, int iMax
 		}
 		
 		if ( !bPath )
-			break;
+			goto pointchecked;
 		
 		// --------- In game items ----------
 		if ( !(flags & LOS_NB_DYNAMIC) )
@@ -1502,7 +1566,7 @@ bool CChar::CanSeeLOS_New( const CPointMap &ptDst, CPointMap *pptBlock, int iMax
 		}
 
 		if ( !bPath )
-			break;
+			goto pointchecked;
 		
 		// ----------- Multis ---------------
 		
@@ -1612,12 +1676,21 @@ bool CChar::CanSeeLOS_New( const CPointMap &ptDst, CPointMap *pptBlock, int iMax
 		if ( bNullTerrain )
 			bPath = false;
 
+	pointchecked:
+		if ( path.IsFirstSide() )
+		{
+			// a diagonal step is only blocked if the tiles on both sides of it are
+			if ( bPath )
+				path.SkipSide();
+			bPath = true;
+			bNullTerrain = false;
+			continue;
+		}
+
 		if ( !bPath )
 			break;
 	}
 
-	path.clear();
-
 	if ( !bPath )
 		return CanSeeLOS_New_Failed(pptBlock, ptNow);
 
@@ -1625,8 +1698,6 @@ bool CChar::CanSeeLOS_New( const CPointMap &ptDst, CPointMap *pptBlock, int iMax
 }
 
 #undef WARNLOS
-#undef APPROX
-#undef BETWEENPOINT
 //#undef CALCITEMHEIGHT
 
 bool CChar::CanSeeLOS( const CObjBaseTemplate *pObj, WORD wFlags ) const
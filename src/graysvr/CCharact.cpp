@@ -33,7 +33,7 @@ bool CChar::TeleportToObj( int iType, TCHAR * pszArgs )
 		{
 			dwUID = 1;
 		}
-		CObjBase * pObj = g_World.FindUID(dwUID);
+		CObjBase * pObj = g_World.FindUIDSlot(dwUID);
 		if ( pObj == NULL )
 			continue;
 
@@ -214,6 +214,8 @@ void CChar::LayerAdd( CItem * pItem, LAYER_TYPE layer )
 	{
 		return;
 	}
+	if ( CSectorTicker::DeferContent(TICKMOVE_LAYER, this, pItem, CPointMap(), layer) )
+		return;	// another stripe is ticking the item's sector
 
 	if ( layer == LAYER_DRAGGING )
 	{
@@ -1152,7 +1154,7 @@ bool CChar::UpdateAnimate(ANIM_TYPE action, bool fTranslate, bool fBackward , BY
 	PacketAction *cmd = new PacketAction(this, action, 1, fBackward, iFrameDelay, iAnimLen);
 	PacketActionNew *cmdnew = new PacketActionNew(this, action1, subaction, variation);
 
-	ClientIterator it;
+	ClientAreaIterator it(this);
 	for ( CClient *pClient = it.next(); pClient != NULL; pClient = it.next() )
 	{
 		if ( !pClient->CanSee(this) )
@@ -1177,7 +1179,7 @@ void CChar::UpdateMode( CClient * pExcludeClient, bool fFull )
 	if ( pExcludeClient == NULL )
 		m_fStatusUpdate &= ~SU_UPDATE_MODE;
 
-	ClientIterator it;
+	ClientAreaIterator it(this);
 	for ( CClient* pClient = it.next(); pClient != NULL; pClient = it.next() )
 	{
 		if ( pExcludeClient == pClient )
@@ -1237,7 +1239,7 @@ void CChar::UpdateMove( const CPointMap & ptOld, CClient * pExcludeClient, bool
 
 	EXC_TRY("UpdateMove");
 	EXC_SET("FOR LOOP");
-	ClientIterator it;
+	ClientAreaIterator it(this, UO_MAP_VIEW_RADAR, &ptOld);
 	for ( CClient* pClient = it.next(); pClient != NULL; pClient = it.next() )
 	{
 		if ( pClient == pExcludeClient )
@@ -1323,7 +1325,7 @@ void CChar::Update(const CClient * pClientExclude )
 	if ( pClientExclude == NULL)
 		m_fStatusUpdate &= ~SU_UPDATE_MODE;
 
-	ClientIterator it;
+	ClientAreaIterator it(this);
 	for ( CClient* pClient = it.next(); pClient != NULL; pClient = it.next() )
 	{
 		if ( pClient == pClientExclude )
@@ -1862,6 +1864,8 @@ bool CChar::ItemEquip( CItem * pItem, CChar * pCharMsg, bool fFromDClick )
 		return false;
 	if ( (pItem->GetParent() == this) && (pItem->GetEquipLayer() != LAYER_DRAGGING) )	// item is already equipped
 		return true;
+	if ( CSectorTicker::DeferContent(TICKMOVE_EQUIP, this, pItem, CPointMap(), 0) )
+		return false;	// another stripe is ticking the item's sector, not equipped before the end of the phase
 
 	if ( IsTrigUsed(TRIGGER_EQUIPTEST) || IsTrigUsed(TRIGGER_ITEMEQUIPTEST) )
 	{
@@ -2950,7 +2954,7 @@ void CChar::ToggleFlying()
 	// NANIM_TAKEOFF and NANIM_LANDING animations are only available on the new animation packet (PacketAnimationBasic),
 	// so we must use it instead the old PacketAnimation which will translate these values into an wrong animation
 	PacketActionNew *cmd = new PacketActionNew(this, IsStatFlag(STATF_Hovering) ? NANIM_TAKEOFF : NANIM_LANDING, static_cast<ANIM_TYPE_NEW>(0), static_cast<BYTE>(0));
-	ClientIterator it;
+	ClientAreaIterator it(this);
 	for ( CClient *pClient = it.next(); pClient != NULL; pClient = it.next() )
 	{
 		if ( !PacketActionNew::CanSendTo(pClient->m_NetState) || !pClient->CanSee(this) )
@@ -3713,11 +3717,7 @@ TRIGRET_TYPE CChar::OnTrigger( LPCTSTR pszTrigName, CTextConsole * pSrc, CScript
 			CResourceLink * pLink = m_OEvents[i];
 			if ( !pLink || !pLink->HasTrigger(iAction) )
 				continue;
-			CResourceLock s;
-			if ( !pLink->ResourceLock(s) )
-				continue;
-
-			iRet = CScriptObj::OnTriggerScript(s, pszTrigName, pSrc, pArgs);
+			iRet = CScriptObj::OnTriggerScript(pLink, iAction, pszTrigName, pSrc, pArgs);
 			if ( iRet != TRIGRET_RET_FALSE && iRet != TRIGRET_RET_DEFAULT )
 				goto stopandret;//return iRet;
 
@@ -3738,10 +3738,7 @@ TRIGRET_TYPE CChar::OnTrigger( LPCTSTR pszTrigName, CTextConsole * pSrc, CScript
 				CResourceLink * pLink = pCharDef->m_TEvents[i];
 				if ( !pLink || !pLink->HasTrigger(iAction) )
 					continue;
-				CResourceLock s;
-				if ( !pLink->ResourceLock(s) )
-					continue;
-				iRet = CScriptObj::OnTriggerScript(s, pszTrigName, pSrc, pArgs);
+				iRet = CScriptObj::OnTriggerScript(pLink, iAction, pszTrigName, pSrc, pArgs);
 				if ( iRet != TRIGRET_RET_FALSE && iRet != TRIGRET_RET_DEFAULT )
 					goto stopandret;//return iRet;
 			}
@@ -3753,13 +3750,9 @@ TRIGRET_TYPE CChar::OnTrigger( LPCTSTR pszTrigName, CTextConsole * pSrc, CScript
 			EXC_SET("chardef triggers");
 			if ( pCharDef->HasTrigger(iAction) )
 			{
-				CResourceLock s;
-				if ( pCharDef->ResourceLock(s) )
-				{
-					iRet = CScriptObj::OnTriggerScript(s, pszTrigName, pSrc, pArgs);
-					if (( iRet != TRIGRET_RET_FALSE ) && ( iRet != TRIGRET_RET_DEFAULT ))
-						goto stopandret;//return iRet;
-				}
+				iRet = CScriptObj::OnTriggerScript(pCharDef, iAction, pszTrigName, pSrc, pArgs);
+				if (( iRet != TRIGRET_RET_FALSE ) && ( iRet != TRIGRET_RET_DEFAULT ))
+					goto stopandret;//return iRet;
 			}
 		}
 
@@ -3773,10 +3766,7 @@ TRIGRET_TYPE CChar::OnTrigger( LPCTSTR pszTrigName, CTextConsole * pSrc, CScript
 				CResourceLink * pLink = g_Cfg.m_pEventsPetLink[i];
 				if (!pLink || !pLink->HasTrigger(iAction))
 					continue;
-				CResourceLock s;
-				if (!pLink->ResourceLock(s))
-					continue;
-				iRet = CScriptObj::OnTriggerScript(s, pszTrigName, pSrc, pArgs);
+				iRet = CScriptObj::OnTriggerScript(pLink, iAction, pszTrigName, pSrc, pArgs);
 				if (iRet != TRIGRET_RET_FALSE && iRet != TRIGRET_RET_DEFAULT)
 					goto stopandret;//return iRet;
 			}
@@ -3791,10 +3781,7 @@ TRIGRET_TYPE CChar::OnTrigger( LPCTSTR pszTrigName, CTextConsole * pSrc, CScript
 				CResourceLink	*pLink = g_Cfg.m_pEventsPlayerLink[i];
 				if ( !pLink || !pLink->HasTrigger(iAction) )
 					continue;
-				CResourceLock s;
-				if ( !pLink->ResourceLock(s) )
-					continue;
-				iRet = CScriptObj::OnTriggerScript(s, pszTrigName, pSrc, pArgs);
+				iRet = CScriptObj::OnTriggerScript(pLink, iAction, pszTrigName, pSrc, pArgs);
 				if ( iRet != TRIGRET_RET_FALSE && iRet != TRIGRET_RET_DEFAULT )
 					goto stopandret;//return iRet;
 			}
@@ -3982,6 +3969,7 @@ bool CChar::OnTick()
 		if ( m_pNPC )	// do some AI action
 		{
 			ProfileTask aiTask(PROFILE_NPC_AI);
+			ProfileScope aiScope("npc ai");
 			EXC_SET("NPC action");
 			if ( !IsStatFlag(STATF_Freeze) )
 			{
@@ -673,6 +673,11 @@ LPCTSTR const CClient::sm_szVerbKeys[CV_QTY+1] =	// static
 	NULL,
 };
 
+const CTableHash CClient::sm_LoadKeysHash(CClient::sm_szLoadKeys, CC_QTY);
+const CTableHash CClient::sm_VerbKeysHash(CClient::sm_szVerbKeys, CV_QTY);
+
+SLAB_IMPLEMENT(CClientTooltip);
+
 bool CClient::r_WriteVal( LPCTSTR pszKey, CGString & sVal, CTextConsole * pSrc )
 {
 	ADDTOCALLSTACK("CClient::r_WriteVal");
@@ -706,7 +711,7 @@ bool CClient::r_WriteVal( LPCTSTR pszKey, CGString & sVal, CTextConsole * pSrc )
 	else if ( !strnicmp("REPORTEDCLIVER", pszKey, 14) && ((pszKey[14] == '\0') || (pszKey[14] == '.')) )
 		index = CC_REPORTEDCLIVER;
 	else
-		index = FindTableSorted(pszKey, sm_szLoadKeys, COUNTOF(sm_szLoadKeys) - 1);
+		index = sm_LoadKeysHash.Find(pszKey);
 
 	switch ( index )
 	{
@@ -836,7 +841,7 @@ bool CClient::r_LoadVal( CScript & s )
 		return true;
 	}
 
-	switch ( FindTableSorted(pszKey, sm_szLoadKeys, COUNTOF(sm_szLoadKeys) - 1) )
+	switch ( sm_LoadKeysHash.Find(pszKey) )
 	{
 		case CC_ALLMOVE:
 		{
@@ -970,7 +975,7 @@ bool CClient::r_Verb( CScript & s, CTextConsole * pSrc ) // Execute command from
 		return true;
 	}
 
-	int index = FindTableSorted(s.GetKey(), sm_szVerbKeys, COUNTOF(sm_szVerbKeys) - 1);
+	int index = sm_VerbKeysHash.Find(s.GetKey());
 	switch ( index )
 	{
 		case CV_ADD:
@@ -937,6 +937,8 @@ void CItemContainer::ContentAdd( CItem *pItem, CPointMap pt, BYTE gridIndex )
 		return;
 	if ( pItem == this )
 		return;	// infinite loop.
+	if ( CSectorTicker::DeferContent(TICKMOVE_CONT, this, pItem, pt, gridIndex) )
+		return;	// another stripe is ticking the item's sector
 
 	if ( !g_Serv.IsLoading() )
 	{
@@ -1022,8 +1024,8 @@ void CItemContainer::ContentAdd( CItem *pItem, CPointMap pt, BYTE gridIndex )
 	// if an item needs OnTickStatusUpdate called on the next tick, it needs
 	// to be added to a separate list since it won't receive ticks whilst in
 	// this container
-	if ( pItem->m_fStatusUpdate && !g_World.m_ObjStatusUpdates.ContainsPtr(pItem) )
-		g_World.m_ObjStatusUpdates.Add(pItem);
+	if ( pItem->m_fStatusUpdate )
+		CSectorTicker::ObjStatusUpdate(pItem);
 
 	switch ( GetType() )
 	{
@@ -47,6 +47,22 @@ LPCTSTR const CItem::sm_szTrigName[ITRIG_QTY+1] =	// static
 	NULL,
 };
 
+// Slabs of all the item classes (SlabAlloc)
+SLAB_IMPLEMENT(CItem);
+SLAB_IMPLEMENT(CItemSpawn);
+SLAB_IMPLEMENT(CItemVendable);
+SLAB_IMPLEMENT(CItemContainer);
+SLAB_IMPLEMENT(CItemScript);
+SLAB_IMPLEMENT(CItemCorpse);
+SLAB_IMPLEMENT(CItemMulti);
+SLAB_IMPLEMENT(CItemMultiCustom);
+SLAB_IMPLEMENT(CItemShip);
+SLAB_IMPLEMENT(CItemMemory);
+SLAB_IMPLEMENT(CItemMap);
+SLAB_IMPLEMENT(CItemCommCrystal);
+SLAB_IMPLEMENT(CItemStone);
+SLAB_IMPLEMENT(CItemMessage);
+
 /////////////////////////////////////////////////////////////////
 // -CItem
 
@@ -60,6 +76,8 @@ CItem::CItem( ITEMID_TYPE id, CItemBase * pItemDef ) : CObjBase( true )
 	m_amount = 1;
 	m_containedGridIndex = 0;
 	m_dwDispIndex = ITEMID_NOTHING;
+	m_pTimerNext = NULL;
+	m_ppTimerPrev = NULL;
 
 	m_itNormal.m_more1 = 0;
 	m_itNormal.m_more2 = 0;
@@ -103,6 +121,7 @@ void CItem::Delete(bool bforce)
 CItem::~CItem()
 {
 	DeletePrepare();	// Must remove early because virtuals will fail in child destructor.
+	CTimerWheel::Unlink(this);
 	if ( ! g_Serv.IsLoading())
 	switch ( m_type )
 	{
@@ -634,9 +653,25 @@ CItem * CItem::SetType(IT_TYPE type)
 {
 	ADDTOCALLSTACK("CItem::SetType");
 	m_type = type;
+	OnWalkChange();
 	return this;
 }
 
+void CItem::OnWalkChange()
+{
+	ADDTOCALLSTACK("CItem::OnWalkChange");
+	// The way we block or hurt walkers may have changed, drop the cached walk checks here. (WalkCache)
+	if ( !IsTopLevel() || !GetTopPoint().IsValidPoint() )
+		return;
+
+	if ( IsTypeMulti() )
+		CSectorBase::InvalidateWalkCaches();
+
+	CSector *pSector = GetTopSector();
+	if ( pSector )
+		pSector->InvalidateWalkCache();
+}
+
 int CItem::FixWeirdness()
 {
 	ADDTOCALLSTACK("CItem::FixWeirdness");
@@ -1146,9 +1181,7 @@ void CItem::SetTimeout( INT64 iDelay )
 	if ( !pSector )
 		return;
 
-	CItemsList::sm_fNotAMove = true;
-	pSector->MoveItemToSector( this, iDelay >= 0 );
-	CItemsList::sm_fNotAMove = false;
+	pSector->MoveItemToSector( this, iDelay >= 0, true );
 	SetContainerFlags(0);
 }
 
@@ -1650,6 +1683,7 @@ bool CItem::SetBase( CItemBase * pItemDef )
 
 	m_type = pItemDef->GetType();	// might change the type.
 	m_Can = pItemDef->m_Can;
+	OnWalkChange();
 	return( true );
 }
 
@@ -1701,6 +1735,7 @@ bool CItem::SetDispID( ITEMID_TYPE id )
 		m_dwDispIndex = pItemDef->GetDispID();
 		ASSERT( CItemBase::IsValidDispID(static_cast<ITEMID_TYPE>(m_dwDispIndex)));
 	}
+	OnWalkChange();
 	return( true );
 }
 
@@ -2061,6 +2096,8 @@ LPCTSTR const CItem::sm_szLoadKeys[IC_QTY+1] =
 	NULL
 };
 
+const CTableHash CItem::sm_LoadKeysHash(CItem::sm_szLoadKeys, IC_QTY);
+
 
 bool CItem::r_WriteVal( LPCTSTR pszKey, CGString & sVal, CTextConsole * pSrc )
 {
@@ -2070,7 +2107,7 @@ bool CItem::r_WriteVal( LPCTSTR pszKey, CGString & sVal, CTextConsole * pSrc )
 	if ( !strnicmp( CItem::sm_szLoadKeys[IC_ADDSPELL], pszKey, 8 ) )
 		index	= IC_ADDSPELL;
 	else
-		index	= FindTableSorted( pszKey, sm_szLoadKeys, COUNTOF( sm_szLoadKeys )-1 );
+		index	= sm_LoadKeysHash.Find( pszKey );
 
 	bool fDoDefault = false;
 
@@ -2343,7 +2380,7 @@ bool CItem::r_LoadVal( CScript & s ) // Load an item Script
 {
 	ADDTOCALLSTACK("CItem::r_LoadVal");
 	EXC_TRY("LoadVal");
-	switch ( FindTableSorted( s.GetKey(), sm_szLoadKeys, COUNTOF( sm_szLoadKeys )-1 ))
+	switch ( sm_LoadKeysHash.Find( s.GetKey() ))
 	{
 		//Set as Strings
 		case IC_CRAFTEDBY:
@@ -2724,13 +2761,15 @@ LPCTSTR const CItem::sm_szVerbKeys[CIV_QTY+1] =
 	NULL
 };
 
+const CTableHash CItem::sm_VerbKeysHash(CItem::sm_szVerbKeys, CIV_QTY);
+
 bool CItem::r_Verb( CScript & s, CTextConsole * pSrc ) // Execute command from script
 {
 	ADDTOCALLSTACK("CItem::r_Verb");
 	EXC_TRY("Verb");
 	ASSERT(pSrc);
 
-	int index = FindTableSorted( s.GetKey(), sm_szVerbKeys, COUNTOF( sm_szVerbKeys )-1 );
+	int index = sm_VerbKeysHash.Find( s.GetKey() );
 	if ( index < 0 )
 	{
 		return( CObjBase::r_Verb( s, pSrc ));
@@ -2795,7 +2834,8 @@ bool CItem::r_Verb( CScript & s, CTextConsole * pSrc ) // Execute command from s
 		case CIV_UNEQUIP:
 			if ( ! pCharSrc )
 				return( false );
-			RemoveSelf();
+			if ( ! CSectorTicker::IsDeferred(this) )
+				RemoveSelf();
 			pCharSrc->ItemBounce(this);
 			break;
 		case CIV_USE:
@@ -2893,11 +2933,7 @@ TRIGRET_TYPE CItem::OnTrigger( LPCTSTR pszTrigName, CTextConsole * pSrc, CScript
 			CResourceLink * pLink = m_OEvents[i];
 			if ( !pLink || !pLink->HasTrigger(iAction) )
 				continue;
-			CResourceLock s;
-			if ( !pLink->ResourceLock(s) )
-				continue;
-
-			iRet = CScriptObj::OnTriggerScript(s, pszTrigName, pSrc, pArgs);
+			iRet = CScriptObj::OnTriggerScript(pLink, iAction, pszTrigName, pSrc, pArgs);
 			if ( iRet != TRIGRET_RET_FALSE && iRet != TRIGRET_RET_DEFAULT )
 				goto stopandret;//return iRet;
 
@@ -2917,10 +2953,7 @@ TRIGRET_TYPE CItem::OnTrigger( LPCTSTR pszTrigName, CTextConsole * pSrc, CScript
 			ASSERT(pLink);
 			if ( !pLink->HasTrigger(iAction) )
 				continue;
-			CResourceLock s;
-			if ( !pLink->ResourceLock(s) )
-				continue;
-			iRet = CScriptObj::OnTriggerScript(s, pszTrigName, pSrc, pArgs);
+			iRet = CScriptObj::OnTriggerScript(pLink, iAction, pszTrigName, pSrc, pArgs);
 			if ( iRet != TRIGRET_RET_FALSE && iRet != TRIGRET_RET_DEFAULT )
 				goto stopandret;//return iRet;
 		}
@@ -2932,10 +2965,7 @@ TRIGRET_TYPE CItem::OnTrigger( LPCTSTR pszTrigName, CTextConsole * pSrc, CScript
 			CResourceLink * pLink = g_Cfg.m_iEventsItemLink[i];
 			if ( !pLink || !pLink->HasTrigger(iAction) )
 				continue;
-			CResourceLock s;
-			if ( !pLink->ResourceLock(s) )
-				continue;
-			iRet = CScriptObj::OnTriggerScript(s, pszTrigName, pSrc, pArgs);
+			iRet = CScriptObj::OnTriggerScript(pLink, iAction, pszTrigName, pSrc, pArgs);
 			if ( iRet != TRIGRET_RET_FALSE && iRet != TRIGRET_RET_DEFAULT )
 				goto stopandret;//return iRet;
 		}
@@ -2960,14 +2990,10 @@ TRIGRET_TYPE CItem::OnTrigger( LPCTSTR pszTrigName, CTextConsole * pSrc, CScript
 
 			if ( pResourceLink->HasTrigger( iAction ))
 			{
-				CResourceLock s;
-				if ( pResourceLink->ResourceLock(s))
+				iRet = CScriptObj::OnTriggerScript( pResourceLink, iAction, pszTrigName, pSrc, pArgs );
+				if ( iRet == TRIGRET_RET_TRUE )
 				{
-					iRet = CScriptObj::OnTriggerScript( s, pszTrigName, pSrc, pArgs );
-					if ( iRet == TRIGRET_RET_TRUE )
-					{
-						goto stopandret;// return(iRet);	// Block further action.
-					}
+					goto stopandret;// return(iRet);	// Block further action.
 				}
 			}
 		}
@@ -2979,11 +3005,7 @@ TRIGRET_TYPE CItem::OnTrigger( LPCTSTR pszTrigName, CTextConsole * pSrc, CScript
 		ASSERT(pResourceLink);
 		if ( pResourceLink->HasTrigger( iAction ))
 		{
-			CResourceLock s;
-			if ( pResourceLink->ResourceLock(s))
-			{
-				iRet = CScriptObj::OnTriggerScript( s, pszTrigName, pSrc, pArgs );
-			}
+			iRet = CScriptObj::OnTriggerScript( pResourceLink, iAction, pszTrigName, pSrc, pArgs );
 		}
 	}
 stopandret:
@@ -3040,11 +3062,7 @@ TRIGRET_TYPE CItem::OnTriggerCreate( CTextConsole * pSrc, CScriptTriggerArgs * p
 	ASSERT(pResourceBase);
 	if ( pResourceBase->HasTrigger( iAction ))
 	{
-		CResourceLock s;
-		if ( pResourceBase->ResourceLock(s))
-		{
-			iRet = CScriptObj::OnTriggerScript( s, pszTrigName, pSrc, pArgs );
-		}
+		iRet = CScriptObj::OnTriggerScript( pResourceBase, iAction, pszTrigName, pSrc, pArgs );
 	}
 
 	// 2) Triggers installed on character, sensitive to actions on all items
@@ -3072,10 +3090,7 @@ TRIGRET_TYPE CItem::OnTriggerCreate( CTextConsole * pSrc, CScriptTriggerArgs * p
 			ASSERT(pLink);
 			if ( !pLink->HasTrigger(iAction) )
 				continue;
-			CResourceLock s;
-			if ( !pLink->ResourceLock(s) )
-				continue;
-			iRet = CScriptObj::OnTriggerScript(s, pszTrigName, pSrc, pArgs);
+			iRet = CScriptObj::OnTriggerScript(pLink, iAction, pszTrigName, pSrc, pArgs);
 			if ( iRet != TRIGRET_RET_FALSE && iRet != TRIGRET_RET_DEFAULT )
 				return iRet;
 		}
@@ -3087,10 +3102,7 @@ TRIGRET_TYPE CItem::OnTriggerCreate( CTextConsole * pSrc, CScriptTriggerArgs * p
 			CResourceLink * pLink = g_Cfg.m_iEventsItemLink[i];
 			if ( !pLink || !pLink->HasTrigger(iAction) )
 				continue;
-			CResourceLock s;
-			if ( !pLink->ResourceLock(s) )
-				continue;
-			iRet = CScriptObj::OnTriggerScript(s, pszTrigName, pSrc, pArgs);
+			iRet = CScriptObj::OnTriggerScript(pLink, iAction, pszTrigName, pSrc, pArgs);
 			if ( iRet != TRIGRET_RET_FALSE && iRet != TRIGRET_RET_DEFAULT )
 				return iRet;
 		}
@@ -3114,14 +3126,10 @@ TRIGRET_TYPE CItem::OnTriggerCreate( CTextConsole * pSrc, CScriptTriggerArgs * p
 
 			if ( pResourceLink->HasTrigger( iAction ))
 			{
-				CResourceLock s;
-				if ( pResourceLink->ResourceLock(s))
+				iRet = CScriptObj::OnTriggerScript( pResourceLink, iAction, pszTrigName, pSrc, pArgs );
+				if ( iRet == TRIGRET_RET_TRUE )
 				{
-					iRet = CScriptObj::OnTriggerScript( s, pszTrigName, pSrc, pArgs );
-					if ( iRet == TRIGRET_RET_TRUE )
-					{
-						return( iRet );	// Block further action.
-					}
+					return( iRet );	// Block further action.
 				}
 			}
 		}
@@ -3184,7 +3192,7 @@ void CItem::Update(const CClient * pClientExclude)
 	ADDTOCALLSTACK("CItem::Update");
 	// Send this new item to all that can see it.
 
-	ClientIterator it;
+	ClientAreaIterator it(this);
 	for (CClient* pClient = it.next(); pClient != NULL; pClient = it.next())
 	{
 		if ( pClient == pClientExclude )
@@ -3445,7 +3453,7 @@ int CItem::AddSpellbookSpell( SPELL_TYPE spell, bool fUpdate )
 	{
 		PacketItemContainer cmd(this, pSpellDef);
 
-		ClientIterator it;
+		ClientAreaIterator it(this);
 		for ( CClient *pClient = it.next(); pClient != NULL; pClient = it.next() )
 		{
 			if ( !pClient->CanSee(this) )
@@ -103,6 +103,7 @@ bool CItemMulti::MultiRealizeRegion()
 	sprintf(pszTemp, "%s (%s)", pRegionBack->GetName(), GetName());
 	m_pRegion->SetName(pszTemp);
 
+	CSectorBase::InvalidateWalkCaches();
 	return m_pRegion->RealizeRegion();
 }
 
@@ -113,6 +114,7 @@ void CItemMulti::MultiUnRealizeRegion()
 		return;
 
 	m_pRegion->UnRealizeRegion();
+	CSectorBase::InvalidateWalkCaches();
 
 	// Find all creatures in the region and remove this from them
 	CWorldSearch Area(m_pRegion->m_pt, Multi_GetMaxDist());
@@ -346,6 +346,7 @@ void CItemMultiCustom::CommitChanges(CClient * pClientSrc)
 
 	m_designMain.m_iRevision++;
 	m_designWorking.m_iRevision = m_designMain.m_iRevision;
+	CSectorBase::InvalidateWalkCaches();
 
 	if ( m_pGrayMulti )
 	{
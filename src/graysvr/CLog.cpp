@@ -1,6 +1,51 @@
 #include "graysvr.h"	// predef header.
 #include "UnixTerminal.h"
 
+///////////////////////////////////////////////////////////////
+// -CLogWriter
+
+CLogWriter g_LogWriter;
+
+CLogWriter::CLogWriter() : AbstractSphereThread("LogWriter", IThread::Normal)
+{
+}
+
+void CLogWriter::onStart()
+{
+	AbstractSphereThread::onStart();
+
+	// Reopen the log file buffered, it stays open while the thread runs.
+	SimpleThreadLock lock(g_Log.m_mutex);
+	if ( g_Log.IsFileOpen() && !g_Log.m_fLockOpen )
+	{
+		g_Log.Close();
+		g_Log.OpenLog();
+	}
+}
+
+void CLogWriter::tick()
+{
+	// Drain the queue, the file is flushed once per tick.
+	SimpleThreadLock lock(g_Log.m_mutex);
+	g_Log.FlushQueue();
+}
+
+void CLogWriter::waitForClose()
+{
+	AbstractSphereThread::waitForClose();
+
+	// Write what is left and go back to unbuffered writes.
+	SimpleThreadLock lock(g_Log.m_mutex);
+	g_Log.FlushQueue();
+	if ( g_Log.IsFileOpen() && !g_Log.m_fLockOpen )
+	{
+		g_Log.Close();
+#ifdef _WIN32
+		g_Log.OpenLog();
+#endif
+	}
+}
+
 ///////////////////////////////////////////////////////////////
 // -CLog
 
@@ -36,7 +81,11 @@ bool CLog::OpenLog( LPCTSTR pszBaseDirName )	// name set previously.
 	// Use the OF_READWRITE to append to an existing file.
 	if ( CFileText::Open(sFileName, OF_SHARE_DENY_NONE|OF_READWRITE|OF_TEXT) )
 	{
-		setvbuf(m_pStream, NULL, _IONBF, 0);
+		// The log writer thread flushes the file itself.
+		if ( g_LogWriter.isActive() )
+			setvbuf(m_pStream, NULL, _IOFBF, LOG_QUEUE_BUFFER);
+		else
+			setvbuf(m_pStream, NULL, _IONBF, 0);
 		return true;
 	}
 	return false;
@@ -80,6 +129,141 @@ void CLog::SetColor( Color color )
 	}
 }
 
+bool CLog::IsQueued( DWORD wMask ) const
+{
+	// Can this message go through the log writer thread ?
+	if ( !g_Cfg.m_fLogAsync || !g_LogWriter.isActive() || g_LogWriter.isCurrentThread() )
+		return false;
+
+	// fatal and critical errors go straight to the disk, the server may be going down.
+	switch ( wMask & 0x07 )
+	{
+		case LOGL_FATAL:
+		case LOGL_CRIT:
+			return false;
+	}
+	return true;
+}
+
+void CLog::WriteEvent( DWORD wMask, const CGTime & datetime, LPCTSTR pszScriptContext, LPCTSTR pszMsg, bool fKeepOpen )
+{
+	// m_mutex must be locked.
+	if ( datetime.GetDay() != m_dateStamp.GetDay() )	// it's a new day, open with new day name.
+	{
+		Close();	// LINUX should alrady be closed.
+		OpenLog();
+		Printf("%s", datetime.Format(NULL));
+	}
+#ifndef _WIN32
+	else
+	{
+		Open(NULL, OF_READWRITE|OF_TEXT|OF_SHARE_DENY_WRITE);	// LINUX needs to close and re-open for each log line ! (unless the log writer thread runs)
+	}
+#endif
+
+	TCHAR szTime[32];
+	sprintf(szTime, "%02d:%02d:", datetime.GetHour(), datetime.GetMinute());
+	m_dateStamp = datetime;
+
+	LPCTSTR pszLabel = NULL;
+	switch ( wMask & 0x07 )
+	{
+		case LOGL_FATAL:
+			pszLabel = "FATAL:";
+			break;
+		case LOGL_CRIT:
+			pszLabel = "CRITICAL:";
+			break;
+		case LOGL_ERROR:
+			pszLabel = "ERROR:";
+			break;
+		case LOGL_WARN:
+			pszLabel = "WARNING:";
+			break;
+	}
+	if ( !pszLabel && (wMask & LOGM_DEBUG) && !(wMask & LOGM_INIT) )
+		pszLabel = "DEBUG:";
+
+	// Print to screen.
+	if ( !(wMask & LOGM_INIT) && !g_Serv.IsLoading() )
+	{
+		SetColor(YELLOW);
+		g_Serv.PrintStr(szTime);
+		SetColor(DEFAULT);
+	}
+
+	if ( pszLabel )	// some sort of error
+	{
+		SetColor(RED);
+		g_Serv.PrintStr(pszLabel);
+		SetColor(WHITE);
+	}
+
+	if ( pszScriptContext[0] )
+	{
+		SetColor(CYAN);
+		g_Serv.PrintStr(pszScriptContext);
+		SetColor(DEFAULT);
+	}
+	g_Serv.PrintStr(pszMsg);
+
+	// Back to normal color.
+	SetColor(DEFAULT);
+
+	// Print to log file.
+	WriteString(szTime);
+	if ( pszLabel )
+		WriteString(pszLabel);
+	if ( pszScriptContext[0] )
+		WriteString(pszScriptContext);
+	WriteString(pszMsg);
+
+#ifndef _WIN32
+	if ( !fKeepOpen )
+		Close();
+#endif
+}
+
+void CLog::FlushQueue()
+{
+	// Write out the records queued for the log writer thread, in order.
+	// m_mutex must be locked. (so there is only one reader)
+	if ( m_Queue.empty() )
+		return;
+
+	while ( !m_Queue.empty() )
+	{
+		const CLogRecord record = m_Queue.front();
+		m_Queue.pop();
+		WriteEvent(record.m_wMask, record.m_datetime, record.m_szContext, record.m_szMsg, true);
+	}
+	Flush();
+}
+
+#ifndef _WIN32
+void CLog::OnForkPrepare()
+{
+	// No log line half written while forking, the child would write it again.
+	m_mutex.lock();
+	Flush();
+}
+
+void CLog::OnForkParent()
+{
+	m_mutex.unlock();
+}
+
+void CLog::OnForkChild()
+{
+	// In a forked child (SaveFork) the log writer thread is gone and the lines still queued
+	// are the parent's to write, so drop them and write directly from now on.
+	while ( !m_Queue.empty() )
+		m_Queue.pop();
+	g_Cfg.m_fLogAsync = false;
+	m_mutex.unlock();
+}
+#endif
+
 int CLog::EventStr( DWORD wMask, LPCTSTR pszMsg )
 {
 	// NOTE: This could be called in odd interrupt context so don't use dynamic stuff
@@ -89,46 +273,9 @@ int CLog::EventStr( DWORD wMask, LPCTSTR pszMsg )
 		return 0;
 
 	int iRet = 0;
-	m_mutex.lock();
-
 	try
 	{
 		CGTime datetime = CGTime::GetCurrentTime();
-		if ( datetime.GetDay() != m_dateStamp.GetDay() )	// it's a new day, open with new day name.
-		{
-			Close();	// LINUX should alrady be closed.
-			OpenLog();
-			Printf("%s", datetime.Format(NULL));
-		}
-#ifndef _WIN32
-		else
-		{
-			Open(NULL, OF_READWRITE|OF_TEXT|OF_SHARE_DENY_WRITE);	// LINUX needs to close and re-open for each log line !
-		}
-#endif
-
-		TCHAR szTime[32];
-		sprintf(szTime, "%02d:%02d:", datetime.GetHour(), datetime.GetMinute());
-		m_dateStamp = datetime;
-
-		LPCTSTR pszLabel = NULL;
-		switch ( wMask & 0x07 )
-		{
-			case LOGL_FATAL:
-				pszLabel = "FATAL:";
-				break;
-			case LOGL_CRIT:
-				pszLabel = "CRITICAL:";
-				break;
-			case LOGL_ERROR:
-				pszLabel = "ERROR:";
-				break;
-			case LOGL_WARN:
-				pszLabel = "WARNING:";
-				break;
-		}
-		if ( !pszLabel && (wMask & LOGM_DEBUG) && !(wMask & LOGM_INIT) )
-			pszLabel = "DEBUG:";
 
 		// Get the script context. (if there is one)
 		TCHAR szScriptContext[_MAX_PATH + 16];
@@ -142,45 +289,33 @@ int CLog::EventStr( DWORD wMask, LPCTSTR pszMsg )
 			szScriptContext[0] = '\0';
 		}
 
-		// Print to screen.
-		if ( !(wMask & LOGM_INIT) && !g_Serv.IsLoading() )
-		{
-			SetColor(YELLOW);
-			g_Serv.PrintStr(szTime);
-			SetColor(DEFAULT);
-		}
-
-		if ( pszLabel )	// some sort of error
-		{
-			SetColor(RED);
-			g_Serv.PrintStr(pszLabel);
-			SetColor(WHITE);
-		}
-
-		if ( szScriptContext[0] )
+		if ( IsQueued(wMask) )
 		{
-			SetColor(CYAN);
-			g_Serv.PrintStr(szScriptContext);
-			SetColor(DEFAULT);
+			// Hand it over to the log writer thread, unless it is too long or the queue is full.
+			size_t iLen = strlen(pszMsg);
+			if ( iLen < LOG_QUEUE_TEXT )
+			{
+				CLogRecord record;
+				record.m_wMask = wMask;
+				record.m_datetime = datetime;
+				strcpylen(record.m_szContext, szScriptContext, COUNTOF(record.m_szContext));
+				memcpy(record.m_szMsg, pszMsg, (iLen + 1) * sizeof(TCHAR));
+				if ( m_Queue.push(record) )
+				{
+					if ( m_Queue.size() >= LOG_QUEUE_SIZE / 4 )
+						g_LogWriter.awaken();
+					return 1;
+				}
+			}
 		}
-		g_Serv.PrintStr(pszMsg);
-
-		// Back to normal color.
-		SetColor(DEFAULT);
-
-		// Print to log file.
-		WriteString(szTime);
-		if ( pszLabel )
-			WriteString(pszLabel);
-		if ( szScriptContext[0] )
-			WriteString(szScriptContext);
-		WriteString(pszMsg);
 
+		SimpleThreadLock lock(m_mutex);
+		FlushQueue();	// keep the order of the queued lines.
+		bool fKeepOpen = g_LogWriter.isActive();
+		WriteEvent(wMask, datetime, szScriptContext, pszMsg, fKeepOpen);
+		if ( fKeepOpen )
+			Flush();	// the log writer thread keeps the file buffered.
 		iRet = 1;
-
-#ifndef _WIN32
-		Close();
-#endif
 	}
 	catch ( ... )
 	{
@@ -189,7 +324,6 @@ int CLog::EventStr( DWORD wMask, LPCTSTR pszMsg )
 		CurrentProfileData.Count(PROFILE_STAT_FAULTS, 1);
 	}
 
-	m_mutex.unlock();
 	return iRet;
 }
 
@@ -6,7 +6,13 @@
 bool CObjBaseTemplate::IsDeleted() const
 {
 	ADDTOCALLSTACK("CObjBaseTemplate::IsDeleted");
-	return (!m_UID.IsValidUID() || (GetParent() == &g_World.m_ObjDelete));
+	return (!m_UID.IsValidUID() || m_fDeletePending || (GetParent() == &g_World.m_ObjDelete));
+}
+
+void CObjBaseTemplate::UpdateSectorIndex()
+{
+	ADDTOCALLSTACK_INTENSIVE("CObjBaseTemplate::UpdateSectorIndex");
+	m_pIndexCell->Update(this);
 }
 
 int CObjBaseTemplate::IsWeird() const
@@ -82,7 +88,7 @@ CObjBase::CObjBase(bool fItem)
 	}
 
 	// Put in the idle list by default. (til placed in the world)
-	g_World.m_ObjNew.InsertHead(this);
+	CSectorTicker::ObjNew(this);
 }
 
 CObjBase::~CObjBase()
@@ -320,7 +326,7 @@ void CObjBase::Sound(SOUND_TYPE id, BYTE iRepeat) const
 	if ( !g_Cfg.m_fGenericSounds || (id <= SOUND_NONE) )
 		return;
 
-	ClientIterator it;
+	ClientAreaIterator it(this);
 	for ( CClient *pClient = it.next(); pClient != NULL; pClient = it.next() )
 	{
 		if ( !pClient->CanHear(this, TALKMODE_OBJ) )
@@ -338,7 +344,7 @@ void CObjBase::Effect(EFFECT_TYPE motion, ITEMID_TYPE id, const CObjBase *pSourc
 	// bLoop
 	// fExplode
 
-	ClientIterator it;
+	ClientAreaIterator it(this);
 	for ( CClient *pClient = it.next(); pClient != NULL; pClient = it.next() )
 	{
 		if ( !pClient->CanSee(this) )
@@ -496,7 +502,7 @@ void CObjBase::UpdateObjMessage(LPCTSTR pTextThem, LPCTSTR pTextYou, CClient *pC
 	ADDTOCALLSTACK("CObjBase::UpdateObjMessage");
 	// Show everyone a msg coming from this object.
 
-	ClientIterator it;
+	ClientAreaIterator it(this);
 	for ( CClient *pClient = it.next(); pClient != NULL; pClient = it.next() )
 	{
 		if ( pClient == pClientExclude )
@@ -514,7 +520,7 @@ void CObjBase::UpdateCanSee(PacketSend *packet, CClient *exclude) const
 	// Send this update message to everyone who can see this.
 	// NOTE: Need not be a top level object. CanSee() will calc that.
 
-	ClientIterator it;
+	ClientAreaIterator it(this);
 	for ( CClient *pClient = it.next(); pClient != NULL; pClient = it.next() )
 	{
 		if ( pClient == exclude )
@@ -638,12 +644,14 @@ LPCTSTR const CObjBase::sm_szLoadKeys[OC_QTY+1] =
 	NULL
 };
 
+const CTableHash CObjBase::sm_LoadKeysHash(CObjBase::sm_szLoadKeys, OC_QTY);
+
 bool CObjBase::r_WriteVal(LPCTSTR pszKey, CGString &sVal, CTextConsole *pSrc)
 {
 	ADDTOCALLSTACK("CObjBase::r_WriteVal");
 	EXC_TRY("WriteVal");
 
-	int index = FindTableHeadSorted(pszKey, sm_szLoadKeys, COUNTOF(sm_szLoadKeys) - 1);
+	int index = sm_LoadKeysHash.FindHead(pszKey);
 	if ( index < 0 )
 	{
 		// RES_FUNCTION call
@@ -1460,7 +1468,7 @@ bool CObjBase::r_LoadVal(CScript &s)
 		return true;
 	}
 
-	int index = FindTableSorted(s.GetKey(), sm_szLoadKeys, COUNTOF(sm_szLoadKeys) - 1);
+	int index = sm_LoadKeysHash.Find(s.GetKey());
 	if ( index < 0 )
 		return CScriptObj::r_LoadVal(s);
 
@@ -1796,6 +1804,8 @@ LPCTSTR const CObjBase::sm_szVerbKeys[OV_QTY+1] =
 	NULL
 };
 
+const CTableHash CObjBase::sm_VerbKeysHash(CObjBase::sm_szVerbKeys, OV_QTY);
+
 // Execute command from script
 bool CObjBase::r_Verb(CScript &s, CTextConsole *pSrc)
 {
@@ -1821,7 +1831,7 @@ bool CObjBase::r_Verb(CScript &s, CTextConsole *pSrc)
 	if ( !strnicmp(pszKey, "TARGET", 6) )
 		index = OV_TARGET;
 	else
-		index = FindTableSorted(pszKey, sm_szVerbKeys, COUNTOF(sm_szVerbKeys) - 1);
+		index = sm_VerbKeysHash.Find(pszKey);
 	if ( index < 0 )
 		return CScriptObj::r_Verb(s, pSrc);
 
@@ -2507,7 +2517,7 @@ void CObjBase::RemoveFromView(CClient *pClientExclude, bool fHardcoded)
 	CItem *pItem = fHardcoded ? (dynamic_cast<CItem *>(this)) : NULL;
 	CChar *pChar = NULL;
 
-	ClientIterator it;
+	ClientAreaIterator it(this);
 	for ( CClient *pClient = it.next(); pClient != NULL; pClient = it.next() )
 	{
 		if ( pClientExclude == pClient )
@@ -2543,7 +2553,7 @@ void CObjBase::ResendOnEquip(bool fAllClients)
 	CItem *pItem = dynamic_cast<CItem *>(this);
 	CChar *pChar = NULL;
 
-	ClientIterator it;
+	ClientAreaIterator it(this);
 	for ( CClient *pClient = it.next(); pClient != NULL; pClient = it.next() )
 	{
 		if ( !fAllClients && !pClient->m_NetState->isClientEnhanced() )
@@ -2619,9 +2629,9 @@ void CObjBase::UpdatePropertyFlag(int mask)
 
 	m_fStatusUpdate |= SU_UPDATE_TOOLTIP;
 
-	// Items equipped or inside containers doesn't receive ticks and need to be added to a list of items to be processed separately
-	if ( !IsTopLevel() && !g_World.m_ObjStatusUpdates.ContainsPtr(this) )
-		g_World.m_ObjStatusUpdates.Add(this);
+	// Items (on ground, equipped or inside containers) and disconnected chars doesn't receive a status tick and need to be added to a list of objects to be processed separately
+	if ( IsItem() || !IsTopLevel() )
+		CSectorTicker::ObjStatusUpdate(this);
 }
 
 void CObjBase::OnTickStatusUpdate()
@@ -2646,7 +2656,7 @@ void CObjBase::ResendTooltip(bool bSendFull, bool bUseCache)
 		FreePropertyList();
 
 	CChar *pChar = NULL;
-	ClientIterator it;
+	ClientAreaIterator it(this);
 	for ( CClient *pClient = it.next(); pClient != NULL; pClient = it.next() )
 	{
 		if ( !pClient->m_TooltipEnabled )
@@ -2697,9 +2707,19 @@ void CObjBase::Delete(bool bforce)
 	if ( m_uidSpawnItem.ItemFind() )
 		static_cast<CItemSpawn *>(m_uidSpawnItem.ItemFind())->DelObj(GetUID());
 
-	DeletePrepare();
-	g_World.m_TimedFunctions.Erase(GetUID());
-	g_World.m_ObjDelete.InsertHead(this);
+	// Another stripe may be walking our sector list, then we only leave it at the end of the phase.
+	bool fDeferred = CSectorTicker::DeferDelete(this);
+	if ( fDeferred )
+		RemoveFromView();
+	else
+		DeletePrepare();
+	{
+		CSectorTickLock lock;
+		g_World.m_TimedFunctions.Erase(GetUID());
+	}
+	SetDeletePending();
+	if ( !fDeferred )
+		CSectorTicker::ObjDelete(this);
 }
 
 TRIGRET_TYPE CObjBase::Spell_OnTrigger(SPELL_TYPE spell, SPTRIG_TYPE stage, CChar *pSrc, CScriptTriggerArgs *pArgs)
@@ -2712,9 +2732,7 @@ TRIGRET_TYPE CObjBase::Spell_OnTrigger(SPELL_TYPE spell, SPTRIG_TYPE stage, CCha
 	if ( pSpellDef->HasTrigger(stage) )
 	{
 		// RES_SKILL
-		CResourceLock s;
-		if ( pSpellDef->ResourceLock(s) )
-			return CScriptObj::OnTriggerScript(s, CSpellDef::sm_szTrigName[stage], pSrc, pArgs);
+		return CScriptObj::OnTriggerScript(pSpellDef, stage, CSpellDef::sm_szTrigName[stage], pSrc, pArgs);
 	}
 	return TRIGRET_RET_DEFAULT;
 }
@@ -46,6 +46,8 @@ class CObjBase : public CObjBaseTemplate, public CScriptObj
 	// All Instances of CItem or CChar have these base attributes.
 	static LPCTSTR const sm_szLoadKeys[];
 	static LPCTSTR const sm_szVerbKeys[];
+	static const CTableHash sm_LoadKeysHash;
+	static const CTableHash sm_VerbKeysHash;
 	static LPCTSTR const sm_szRefKeys[];
 
 private:
@@ -441,8 +443,11 @@ class CItem : public CObjBase
 	// RES_WORLDITEM
 public:
 	static const char *m_sClassName;
+	SLAB_DECLARE
 	static LPCTSTR const sm_szLoadKeys[];
 	static LPCTSTR const sm_szVerbKeys[];
+	static const CTableHash sm_LoadKeysHash;
+	static const CTableHash sm_VerbKeysHash;
 	static LPCTSTR const sm_szRefKeys[];
 	static LPCTSTR const sm_szTrigName[ITRIG_QTY+1];
 	static LPCTSTR const sm_szTemplateTable[ITC_QTY+1];
@@ -455,6 +460,10 @@ private:
 	DWORD	m_CanUse;		// Base attribute flags. can_u_all/male/female..
 	WORD	m_weight;
 
+	friend class CTimerWheel;
+	CItem * m_pTimerNext;	// Links in a CTimerWheel bucket or a CSector due list.
+	CItem ** m_ppTimerPrev;
+
 public:
 	BYTE	m_speed;
 	// Attribute flags.
@@ -1044,6 +1053,12 @@ public:
 		Update();
 		return bReturn;
 	}
+	virtual void SetTopZ( signed char z )
+	{
+		CObjBaseTemplate::SetTopZ( z );
+		OnWalkChange();
+	}
+	void OnWalkChange();
 	bool MoveToDecay(const CPointMap & pt, INT64 iDecayTime, bool bForceFix = false)
 	{
 		SetDecayTime( iDecayTime );
@@ -1316,6 +1331,7 @@ private:
 
 public:
 	static const char *m_sClassName;
+	SLAB_DECLARE
 
 	/* I don't want to inherit SetAmount, GetAmount and m_iAmount from the parent CItem class. I need to redefine them for CItemSpawn class
 	*	so that when i set AMOUNT to the spawn item, i don't really set the "item amount/quantity" property, but the "spawn item AMOUNT" property.
@@ -1428,6 +1444,7 @@ private:
 
 public:
 	static const char *m_sClassName;
+	SLAB_DECLARE
 	CItemVendable( ITEMID_TYPE id, CItemBase * pItemDef );
 	virtual ~CItemVendable();
 
@@ -1534,6 +1551,7 @@ class CItemContainer : public CItemVendable, public CContainer
 	static LPCTSTR const sm_szVerbKeys[];
 public:
 	static const char *m_sClassName;
+	SLAB_DECLARE
 	// bool m_fTinkerTrapped;	// magic trap is diff.
 	bool NotifyDelete();
 	void DeletePrepare()
@@ -1624,6 +1642,7 @@ class CItemScript : public CItemVendable	// A message for a bboard or book text.
 	// IT_SCRIPT, IT_EQ_SCRIPT
 public:
 	static const char *m_sClassName;
+	SLAB_DECLARE
 	static LPCTSTR const sm_szLoadKeys[];
 	static LPCTSTR const sm_szVerbKeys[];
 public:
@@ -1653,6 +1672,7 @@ class CItemCorpse : public CItemContainer
 	// A corpse is a special type of item.
 public:
 	static const char *m_sClassName;
+	SLAB_DECLARE
 	CItemCorpse( ITEMID_TYPE id, CItemBase * pItemDef ) :
 		CItemContainer( id, pItemDef )
 	{
@@ -1722,6 +1742,7 @@ protected:
 
 public:
 	static const char *m_sClassName;
+	SLAB_DECLARE
 	CItemMulti( ITEMID_TYPE id, CItemBase * pItemDef );
 	virtual ~CItemMulti();
 
@@ -1812,6 +1833,7 @@ private:
 
 public:
 	static const char *m_sClassName;
+	SLAB_DECLARE
 	CItemMultiCustom( ITEMID_TYPE id, CItemBase * pItemDef );
 	virtual ~CItemMultiCustom();
 
@@ -1886,6 +1908,7 @@ public:
 	bool Ship_Face(DIR_TYPE dir);
 	bool Ship_Move(DIR_TYPE dir, int distance);
 	static const char *m_sClassName;
+	SLAB_DECLARE
 	CItemShip( ITEMID_TYPE id, CItemBase * pItemDef );
 	virtual ~CItemShip();
 
@@ -1911,6 +1934,7 @@ class CItemMemory : public CItem
 	// Allow extra tags for the memory
 public:
 	static const char *m_sClassName;
+	SLAB_DECLARE
 	CItemMemory( ITEMID_TYPE id, CItemBase * pItemDef ) :
 		CItem( ITEMID_MEMORY, pItemDef )
 	{
@@ -1967,6 +1991,7 @@ class CItemMap : public CItemVendable
 	// IT_MAP
 public:
 	static const char *m_sClassName;
+	SLAB_DECLARE
 	enum
 	{
 		MAX_PINS = 128,
@@ -2007,6 +2032,7 @@ protected:
 	CResourceRefArray m_Speech;	// Speech fragment list (other stuff we know)
 public:
 	static const char *m_sClassName;
+	SLAB_DECLARE
 	CItemCommCrystal( ITEMID_TYPE id, CItemBase * pItemDef ) : CItemVendable( id, pItemDef )
 	{
 	}
@@ -2189,6 +2215,7 @@ private:
 	void ElectMaster();
 public:
 	static const char *m_sClassName;
+	SLAB_DECLARE
 	CStoneMember * AddRecruit(const CChar * pChar, STONEPRIV_TYPE iPriv, bool bFull = false);
 
 	// War
@@ -2254,6 +2281,7 @@ private:
 	CGObArray<CGString*> m_sBodyLines;	// The main body of the text for bboard message or book.
 public:
 	static const char *m_sClassName;
+	SLAB_DECLARE
 	CGString m_sAuthor;					// Should just have author name !
 	static LPCTSTR const sm_szLoadKeys[CIC_QTY+1];
 
@@ -2331,6 +2359,7 @@ struct CCharNPC
 	// This is basically the unique "brains" for any character.
 public:
 	static const char *m_sClassName;
+	SLAB_DECLARE
 	// Stuff that is specific to an NPC character instance (not an NPC type see CCharBase for that).
 	// Any NPC AI stuff will go here.
 	static LPCTSTR const sm_szVerbKeys[];
@@ -2389,6 +2418,7 @@ private:
 
 public:
 	static const char *m_sClassName;
+	SLAB_DECLARE
 	CAccount *m_pAccount;	// The account index. (for idle players mostly)
 	static LPCTSTR const sm_szVerbKeys[];
 
@@ -2692,6 +2722,7 @@ public:
 	std::vector<NotoSaves> m_notoSaves;
 
 	static const char *m_sClassName;
+	SLAB_DECLARE
 	CClient *m_pClient;			// Is the char a logged in m_pPlayer ?
 	CCharPlayer *m_pPlayer;		// May even be an off-line player !
 	CCharNPC *m_pNPC;			// we can be both a player and an NPC if "controlled" ?
@@ -2702,6 +2733,8 @@ public:
 	static LPCTSTR const sm_szRefKeys[];
 	static LPCTSTR const sm_szLoadKeys[];
 	static LPCTSTR const sm_szVerbKeys[];
+	static const CTableHash sm_LoadKeysHash;
+	static const CTableHash sm_VerbKeysHash;
 	static LPCTSTR const sm_szTrigName[CTRIG_QTY+1];
 	static const LAYER_TYPE sm_VendorLayers[3];
 
@@ -1,75 +1,118 @@
 #include "../graysvr/CPathFinder.h"
 
-unsigned long CPathFinder::Heuristic(CPathFinderPointRef& Pt1,CPathFinderPointRef& Pt2)
+//***************************************************************************
+// CPathFinderArena
+
+CPathFinderArena::CPathFinderArena() : m_HeapSize(0), m_Generation(0)
 {
-	return 10*(abs(Pt1.m_Point->m_x - Pt2.m_Point->m_x) + abs(Pt1.m_Point->m_y - Pt2.m_Point->m_y));
+	ADDTOCALLSTACK("CPathFinderArena::CPathFinderArena");
+	memset(m_Nodes, 0, sizeof(m_Nodes));
 }
 
-void CPathFinder::GetChildren(CPathFinderPointRef& Point, std::list<CPathFinderPointRef>& ChildrenRefList )
+void CPathFinderArena::Begin()
 {
-	int RealX = 0, RealY = 0;
-	for ( int x = -1; x != 2; ++x)
+	ADDTOCALLSTACK("CPathFinderArena::Begin");
+	// start a new search, invalidating the nodes of the previous one
+	m_HeapSize = 0;
+	if ( ++m_Generation == 0 )
 	{
-		for ( int y = -1; y != 2; ++y)
-		{
-			if ( x == 0 && y == 0 )
-				continue;
-			RealX = x + Point.m_Point->m_x;
-			RealY = y + Point.m_Point->m_y;
-			if ( RealX < 0 || RealY < 0 || RealX > 23 || RealY > 23 )
-				continue;
-			if ( m_Points[RealX][RealY].m_Walkable == false )
-				continue;
-			if ( x != 0 && y != 0 ) // Diagonal
-			{
-				if ( m_Points[RealX - x][RealY].m_Walkable == false || m_Points[RealX][RealY - y].m_Walkable == false )
-					continue;
-			}
-
-
-			CPathFinderPointRef PtRef( m_Points[RealX][RealY] );
-			ChildrenRefList.push_back( PtRef  );
-		}
+		// the stamps wrapped around, old nodes could look current again
+		memset(m_Nodes, 0, sizeof(m_Nodes));
+		m_Generation = 1;
 	}
 }
 
-CPathFinderPoint::CPathFinderPoint() : m_Parent(0), m_Walkable(false), FValue(0), GValue(0), HValue(0)
+CPathFinderNode &CPathFinderArena::Touch(WORD index)
 {
-	ADDTOCALLSTACK("CPathFinderPoint::CPathFinderPoint");
-	m_x = 0;
-	m_y = 0;
-	m_z = 0;
-	m_map = 0;
+	// returns the node, reset to unvisited if it was not used by this search yet
+	ASSERT(index < PATH_NODES);
+	CPathFinderNode &node = m_Nodes[index];
+	if ( node.m_Generation != m_Generation )
+	{
+		node.m_Generation = m_Generation;
+		node.m_Parent = PATH_NOPARENT;
+		node.m_HeapIndex = PATH_NODES;
+		node.m_GValue = INT_MAX;
+		node.m_FValue = INT_MAX;
+		node.m_z = 0;
+		node.m_Walkable = PATH_UNRESOLVED;
+	}
+	return node;
 }
 
-CPathFinderPoint::CPathFinderPoint(const CPointMap& pt) : m_Parent(0), m_Walkable(false), FValue(0), GValue(0), HValue(0)
+void CPathFinderArena::Push(WORD index)
 {
-	ADDTOCALLSTACK("CPathFinderPoint::CPathFinderPoint");
-	m_x = pt.m_x;
-	m_y = pt.m_y;
-	m_z = pt.m_z;
-	m_map = pt.m_map;
+	ASSERT(m_HeapSize < PATH_NODES);
+	m_Heap[m_HeapSize] = index;
+	m_Nodes[index].m_HeapIndex = static_cast<WORD>(m_HeapSize);
+	SiftUp(m_HeapSize++);
 }
 
+WORD CPathFinderArena::Pop()
+{
+	// removes the open node with the lowest F value and marks it closed
+	ASSERT(m_HeapSize > 0);
+	WORD index = m_Heap[0];
+	m_Nodes[index].m_HeapIndex = PATH_CLOSED;
+	if ( --m_HeapSize > 0 )
+	{
+		m_Heap[0] = m_Heap[m_HeapSize];
+		m_Nodes[m_Heap[0]].m_HeapIndex = 0;
+		SiftDown(0);
+	}
+	return index;
+}
 
-bool CPathFinderPoint::operator < (const CPathFinderPoint& pt) const
+void CPathFinderArena::Update(WORD index)
 {
-	//ADDTOCALLSTACK("CPathFinderPoint::operator <");
-	return (FValue < pt.FValue);
+	// F value of an open node has decreased
+	ASSERT(m_Nodes[index].m_HeapIndex < m_HeapSize);
+	SiftUp(m_Nodes[index].m_HeapIndex);
 }
 
-const CPathFinderPoint* CPathFinderPoint::GetParent() const
+void CPathFinderArena::SiftUp(size_t pos)
 {
-	ADDTOCALLSTACK("CPathFinderPoint::GetParent");
-	return m_Parent;
+	WORD index = m_Heap[pos];
+	int iFValue = m_Nodes[index].m_FValue;
+	while ( pos > 0 )
+	{
+		size_t parent = (pos - 1) / 2;
+		if ( m_Nodes[m_Heap[parent]].m_FValue <= iFValue )
+			break;
+		m_Heap[pos] = m_Heap[parent];
+		m_Nodes[m_Heap[pos]].m_HeapIndex = static_cast<WORD>(pos);
+		pos = parent;
+	}
+	m_Heap[pos] = index;
+	m_Nodes[index].m_HeapIndex = static_cast<WORD>(pos);
 }
 
-void CPathFinderPoint::SetParent(CPathFinderPointRef& pt)
+void CPathFinderArena::SiftDown(size_t pos)
 {
-	ADDTOCALLSTACK("CPathFinderPoint::SetParent");
-	m_Parent = pt.m_Point;
+	WORD index = m_Heap[pos];
+	int iFValue = m_Nodes[index].m_FValue;
+	for (;;)
+	{
+		size_t child = (pos * 2) + 1;
+		if ( child >= m_HeapSize )
+			break;
+		if (( child + 1 < m_HeapSize ) && ( m_Nodes[m_Heap[child + 1]].m_FValue < m_Nodes[m_Heap[child]].m_FValue ))
+			++child;
+		if ( iFValue <= m_Nodes[m_Heap[child]].m_FValue )
+			break;
+		m_Heap[pos] = m_Heap[child];
+		m_Nodes[m_Heap[pos]].m_HeapIndex = static_cast<WORD>(pos);
+		pos = child;
+	}
+	m_Heap[pos] = index;
+	m_Nodes[index].m_HeapIndex = static_cast<WORD>(pos);
 }
 
+//***************************************************************************
+// CPathFinder
+
+TlsValue<CPathFinderArena *> CPathFinder::sm_pArena;
+
 CPathFinder::CPathFinder(CChar *pChar, CPointMap ptTarget)
 {
 	ADDTOCALLSTACK("CPathFinder::CPathFinder");
@@ -86,117 +129,141 @@ CPathFinder::CPathFinder(CChar *pChar, CPointMap ptTarget)
 	m_Target.m_x -= static_cast<short>(m_RealX);
 	m_Target.m_y -= static_cast<short>(m_RealY);
 
-	EXC_SET("FillMap");
+	EXC_SET("arena");
 
-	FillMap();
+	// the arena is kept for the lifetime of the thread, pathfinding runs on the
+	// sector threads too so it cannot be shared
+	m_pArena = sm_pArena.get();
+	if ( m_pArena == NULL )
+	{
+		m_pArena = new CPathFinderArena();
+		sm_pArena = m_pArena;
+	}
+	m_pArena->Begin();
 
 	EXC_CATCH;
 }
 
 CPathFinder::~CPathFinder()
 {
-	ADDTOCALLSTACK("CPathFinderPoint::~CPathFinderPoint");
+	ADDTOCALLSTACK("CPathFinder::~CPathFinder");
+}
+
+int CPathFinder::Heuristic(int x, int y) const
+{
+	return 10*(abs(x - m_Target.m_x) + abs(y - m_Target.m_y));
+}
+
+bool CPathFinder::IsWalkable(int x, int y, signed char z)
+{
+	// Walkable status is only resolved for the cells the search actually reaches,
+	// from the height of the first neighbour that reached them.
+	CPathFinderNode &node = m_pArena->Touch(static_cast<WORD>((y * PATH_SIZE) + x));
+	if ( node.m_Walkable != PATH_UNRESOLVED )
+		return ( node.m_Walkable == PATH_WALKABLE );
+
+	if ( x == m_Target.m_x && y == m_Target.m_y )
+	{
+		// always assume that our target position is walkable
+		node.m_Walkable = PATH_WALKABLE;
+		node.m_z = z;
+	}
+	else
+	{
+		CPointMap pt = m_pChar->GetTopPoint();
+		pt.m_x = static_cast<short>(x + m_RealX);
+		pt.m_y = static_cast<short>(y + m_RealY);
+		pt.m_z = z;
+		node.m_Walkable = m_pChar->CanMoveWalkTo(pt, true, true, DIR_QTY, true) ? PATH_WALKABLE : PATH_UNWALKABLE;
+		node.m_z = pt.m_z;
+	}
+	return ( node.m_Walkable == PATH_WALKABLE );
 }
 
 int CPathFinder::FindPath() //A* algorithm
 {
 	ADDTOCALLSTACK("CPathFinder::FindPath");
 	ASSERT(m_pChar != NULL);
+	ASSERT(m_pArena != NULL);
 
 	int X = m_pChar->GetTopPoint().m_x - m_RealX;
 	int Y = m_pChar->GetTopPoint().m_y - m_RealY;
 
-	if ( X < 0 || Y < 0 || X > 23 || Y > 23 )
+	if ( X < 0 || Y < 0 || X >= PATH_SIZE || Y >= PATH_SIZE ||
+		m_Target.m_x < 0 || m_Target.m_y < 0 || m_Target.m_x >= PATH_SIZE || m_Target.m_y >= PATH_SIZE )
 	{
 		//Too far away
 		Clear();
 		return PATH_NONEXISTENT;
 	}
 
-	CPathFinderPointRef Start(m_Points[X][Y]); //Start point
-	CPathFinderPointRef End(m_Points[m_Target.m_x][m_Target.m_y]); //End Point
-
-	ASSERT(Start.m_Point);
-	ASSERT(End.m_Point);
-
-	Start.m_Point->GValue = 0;
-	Start.m_Point->HValue = Heuristic(Start, End);
-	Start.m_Point->FValue = Start.m_Point->HValue;
-
-	m_Opened.push_back( Start );
+	CPathFinderArena &arena = *m_pArena;
+	WORD wStart = static_cast<WORD>((Y * PATH_SIZE) + X);
+	WORD wEnd = static_cast<WORD>((m_Target.m_y * PATH_SIZE) + m_Target.m_x);
 
-	std::list<CPathFinderPointRef> Children;
-	CPathFinderPointRef Child, Current;
-	std::deque<CPathFinderPointRef>::iterator InOpened, InClosed;
+	CPathFinderNode &start = arena.Touch(wStart);
+	start.m_Walkable = PATH_WALKABLE;
+	start.m_z = m_pChar->GetTopPoint().m_z;
+	start.m_GValue = 0;
+	start.m_FValue = Heuristic(X, Y);
+	arena.Push(wStart);
 
-	while ( !m_Opened.empty() )
+	while ( !arena.IsEmpty() )
 	{
-		std::sort(m_Opened.begin(), m_Opened.end());
-		Current = *m_Opened.begin();
-
-		m_Opened.pop_front();
-		m_Closed.push_back( Current );
-
-		if ( Current == End )
+		WORD wCurrent = arena.Pop();
+		if ( wCurrent == wEnd )
 		{
-			CPathFinderPointRef PathRef = Current;
-			while ( PathRef.m_Point->GetParent() ) //Rebuild path + save
-			{
-				PathRef.m_Point = const_cast<CPathFinderPoint*>(PathRef.m_Point->GetParent());
-				m_LastPath.push_front(CPointMap(static_cast<WORD>(PathRef.m_Point->m_x + m_RealX), static_cast<WORD>(PathRef.m_Point->m_y + m_RealY), 0, PathRef.m_Point->m_map));
-			}
+			//Rebuild path + save, the end point itself is not stored
+			BYTE bMap = m_pChar->GetTopPoint().m_map;
+			for ( WORD wPath = arena.m_Nodes[wCurrent].m_Parent; wPath != PATH_NOPARENT; wPath = arena.m_Nodes[wPath].m_Parent )
+				m_LastPath.push_front(CPointMap(static_cast<WORD>((wPath % PATH_SIZE) + m_RealX), static_cast<WORD>((wPath / PATH_SIZE) + m_RealY), 0, bMap));
 			Clear();
 			return PATH_FOUND;
 		}
-		else
-		{
-			Children.clear();
-			GetChildren( Current, Children );
 
-			while ( !Children.empty() )
+		const CPathFinderNode &current = arena.m_Nodes[wCurrent];
+		int iCurX = wCurrent % PATH_SIZE;
+		int iCurY = wCurrent / PATH_SIZE;
+
+		for ( int x = -1; x != 2; ++x )
+		{
+			for ( int y = -1; y != 2; ++y )
 			{
-				Child = Children.front();
-				Children.pop_front();
+				if ( x == 0 && y == 0 )
+					continue;
+				int RealX = iCurX + x;
+				int RealY = iCurY + y;
+				if ( RealX < 0 || RealY < 0 || RealX >= PATH_SIZE || RealY >= PATH_SIZE )
+					continue;
+				if ( !IsWalkable(RealX, RealY, current.m_z) )
+					continue;
+				if ( x != 0 && y != 0 ) // Diagonal
+				{
+					if ( !IsWalkable(RealX - x, RealY, current.m_z) || !IsWalkable(RealX, RealY - y, current.m_z) )
+						continue;
+				}
 
-				InClosed = std::find( m_Closed.begin(), m_Closed.end(), Child );
-				InOpened = std::find( m_Opened.begin(), m_Opened.end(), Child );
+				WORD wChild = static_cast<WORD>((RealY * PATH_SIZE) + RealX);
+				CPathFinderNode &child = arena.m_Nodes[wChild];	// touched by IsWalkable
+				if ( child.m_HeapIndex == PATH_CLOSED )
+					continue;
 
-				if ( InClosed != m_Closed.end() )
+				int iGValue = current.m_GValue + (( x != 0 && y != 0 ) ? 14 : 10);
+				if ( iGValue >= child.m_GValue )
 					continue;
 
-				if ( InOpened == m_Opened.end() )
-				{
-					Child.m_Point->SetParent( Current );
-					Child.m_Point->GValue = Current.m_Point->GValue;
-
-					if ( Child.m_Point->m_x == Current.m_Point->m_x || Child.m_Point->m_y == Current.m_Point->m_y )
-						Child.m_Point->GValue += 10; //Not diagonal
-					else
-						Child.m_Point->GValue += 14; //Diagonal
-
-					Child.m_Point->HValue = Heuristic( Child, End );
-					Child.m_Point->FValue = Child.m_Point->GValue + Child.m_Point->HValue;
-					m_Opened.push_back( Child );
-					//sort ( m_Opened.begin(), m_Opened.end() );
-				}
+				bool fOpened = ( child.m_GValue != INT_MAX );
+				child.m_Parent = wCurrent;
+				child.m_GValue = iGValue;
+				child.m_FValue = iGValue + Heuristic(RealX, RealY);
+				if ( fOpened )
+					arena.Update(wChild);
 				else
-				{
-					if ( Child.m_Point->GValue < Current.m_Point->GValue )
-					{
-						Child.m_Point->SetParent( Current );
-						if ( Child.m_Point->m_x == Current.m_Point->m_x || Child.m_Point->m_y == Current.m_Point->m_y )
-							Child.m_Point->GValue += 10;
-						else
-							Child.m_Point->GValue += 14;
-						Child.m_Point->FValue = Child.m_Point->GValue + Child.m_Point->HValue;
-						//sort ( m_Opened.begin(), m_Opened.end() );
-					}
-				}
+					arena.Push(wChild);
 			}
 		}
 	}
 
-
 	Clear();
 	return PATH_NONEXISTENT;
 }
@@ -206,46 +273,10 @@ void CPathFinder::Clear()
 	ADDTOCALLSTACK("CPathFinder::Clear");
 	m_Target = CPointMap(0,0);
 	m_pChar = 0;
-	m_Opened.clear();
-	m_Closed.clear();
 	m_RealX = 0;
 	m_RealY = 0;
 }
 
-void CPathFinder::FillMap()
-{
-	ADDTOCALLSTACK("CPathFinder::FillMap");
-	CRegionBase	*pArea;
-	CPointMap	pt, ptChar;
-
-	EXC_TRY("FillMap");
-	pt = ptChar = m_pChar->GetTopPoint();
-
-	for ( int x = 0 ; x != PATH_SIZE; ++x )
-	{
-		for ( int y = 0; y != PATH_SIZE; ++y )
-		{
-			if (x == m_Target.m_x && y == m_Target.m_y)
-			{
-				// always assume that our target position is walkable
-				m_Points[x][y].m_Walkable = PATH_WALKABLE;
-			}
-			else
-			{
-				pt.m_x = static_cast<short>(x + static_cast<short>(m_RealX));
-				pt.m_y = static_cast<short>(y + m_RealY);
-					pArea = m_pChar->CanMoveWalkTo(pt, true, true, DIR_QTY, true);
-
-				m_Points[x][y].m_Walkable = pArea ? PATH_WALKABLE : PATH_UNWALKABLE;
-			}
-
-			m_Points[x][y].Set(static_cast<WORD>(x), static_cast<WORD>(y), pt.m_z, pt.m_map);
-		}
-	}
-
-	EXC_CATCH;
-}
-
 CPointMap CPathFinder::ReadStep(size_t Step)
 {
 	ADDTOCALLSTACK("CPathFinder::ReadStep");
@@ -263,4 +294,3 @@ void CPathFinder::ClearLastPath()
 	ADDTOCALLSTACK("CPathFinder::ClearLastPath");
 	m_LastPath.clear();
 }
-
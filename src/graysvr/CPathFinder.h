@@ -8,72 +8,59 @@
 
 #include "../graysvr/graysvr.h"
 #include <deque>
-#include <list>
-#include <algorithm>
 
 using std::deque;
-using std::list;
 
 #define PATH_SIZE (UO_MAP_VIEW_SIGHT*2)	// limit NPC view by one screen (both sides)
+#define PATH_NODES (PATH_SIZE*PATH_SIZE)	// cells in the search grid
 
-class CPathFinderPointRef;
+#define PATH_NOPARENT	0xFFFF	// node has no parent (start node)
+#define PATH_CLOSED		0xFFFF	// node has already been expanded
+#define PATH_UNRESOLVED	2		// walkable status of the cell not checked yet
 
-class CPathFinderPoint : public CPointMap
+struct CPathFinderNode
 {
-protected:
-	CPathFinderPoint* m_Parent;
-public:
-	bool m_Walkable;
-	int FValue;
-	int GValue;
-	int HValue;
+	// A* state of one cell of the search grid. The fields are only meaningful while
+	// m_Generation matches the arena's current search, so nothing is cleared between searches.
+	DWORD m_Generation;		// search the node was last touched by
+	WORD m_Parent;			// node index we came from
+	WORD m_HeapIndex;		// position in the open heap, PATH_CLOSED once expanded
+	int m_GValue;			// cost from the start
+	int m_FValue;			// cost from the start + estimate to the target
+	signed char m_z;		// height the char reaches this cell at
+	BYTE m_Walkable;		// PATH_WALKABLE, PATH_UNWALKABLE or PATH_UNRESOLVED
+};
 
+class CPathFinderArena
+{
+	// Search grid and open list reused by all the searches of one thread.
 public:
-	CPathFinderPoint();
-	explicit CPathFinderPoint(const CPointMap& pt);
+	CPathFinderArena();
 
 private:
-	CPathFinderPoint(const CPathFinderPoint& copy);
-	CPathFinderPoint& operator=(const CPathFinderPoint& other);
+	CPathFinderArena(const CPathFinderArena& copy);
+	CPathFinderArena& operator=(const CPathFinderArena& other);
 
 public:
-	const CPathFinderPoint* GetParent() const;
-	void SetParent(CPathFinderPointRef& pt);
+	void Begin();
+	CPathFinderNode &Touch(WORD index);
 
-	bool operator < (const CPathFinderPoint& pt) const;
-};
+	bool IsEmpty() const { return m_HeapSize == 0; }
+	void Push(WORD index);
+	WORD Pop();
+	void Update(WORD index);
 
-class CPathFinderPointRef
-{
-public:
-	CPathFinderPoint* m_Point;
+private:
+	void SiftUp(size_t pos);
+	void SiftDown(size_t pos);
 
 public:
-	CPathFinderPointRef() : m_Point(0)
-	{
-	}
-
-	explicit CPathFinderPointRef(CPathFinderPoint& Pt)
-	{
-		m_Point = &Pt;
-	}
+	CPathFinderNode m_Nodes[PATH_NODES];
 
-public:
-	CPathFinderPointRef& operator = ( const CPathFinderPointRef& Pt )
-	{
-		m_Point = Pt.m_Point;
-		return *this;
-	}
-
-	bool operator < (const CPathFinderPointRef& Pt) const
-	{
-		return m_Point->FValue < Pt.m_Point->FValue;
-	}
-
-	bool operator == ( const CPathFinderPointRef& Pt )
-	{
-		return Pt.m_Point == m_Point;
-	}
+private:
+	WORD m_Heap[PATH_NODES];	// indexed binary min-heap on m_FValue
+	size_t m_HeapSize;
+	DWORD m_Generation;
 };
 
 class CPathFinder
@@ -102,10 +89,7 @@ public:
 	void ClearLastPath();
 
 protected:
-	CPathFinderPoint m_Points[PATH_SIZE][PATH_SIZE];
-	std::deque<CPathFinderPointRef> m_Opened;
-	std::deque<CPathFinderPointRef> m_Closed;
-
+	CPathFinderArena *m_pArena;
 	std::deque<CPointMap> m_LastPath;
 
 	int m_RealX;
@@ -114,11 +98,12 @@ protected:
 	CChar *m_pChar;
 	CPointMap m_Target;
 
+	static TlsValue<CPathFinderArena *> sm_pArena;	// per thread arena, allocated on first use
+
 protected:
 	void Clear();
-	unsigned long Heuristic(CPathFinderPointRef& Pt1,CPathFinderPointRef& Pt2);
-	void GetChildren(CPathFinderPointRef& Point, std::list<CPathFinderPointRef>& ChildrenRefList );
-	void FillMap();	// prepares map with walkable statuses
+	int Heuristic(int x, int y) const;
+	bool IsWalkable(int x, int y, signed char z);	// resolves walkable status of a cell on first use
 };
 
 
@@ -11,8 +11,17 @@ CResource::CResource()
 	m_fUseHTTP		= 2;
 	m_fUseAuthID	= true;
 	m_iMapCacheTime = 2*60*TICK_PER_SEC;
+	m_fWalkCache = false;
+	m_fSectorGrid = false;
+	m_fAreaOfInterest = false;
 	m_iSectorSleepMask = (1<<10)-1;
+	m_iSectorThreads = 0;
 	m_fUseMapDiffs = false;
+	m_fMulMapping = false;
+	m_fLogAsync = false;
+	m_fPacketPool = false;
+	m_fUIDGenerations = false;
+	m_fSlabAlloc = false;
 
 	m_wDebugFlags = 0; //DEBUGF_NPC_EMOTE
 	m_fSecure = true;
@@ -61,6 +70,9 @@ CResource::CResource()
 	m_iSaveBackupLevels = 10;
 	m_iSaveBackgroundTime = 0;		// Use the new background save.
 	m_fSaveGarbageCollect = true;	// Always force a full garbage collection.
+	m_fSaveBinary = false;
+	m_iSaveThreads = 0;
+	m_fSaveFork = false;
 	m_iSavePeriod = 20*60*TICK_PER_SEC;
 	m_iSaveSectorsPerTick = 1;
 	m_iSaveStepMaxComplexity = 500;
@@ -224,6 +236,7 @@ CResource::CResource()
 #ifdef _MTNETWORK
 	m_iNetworkThreads = 0;
 	m_iNetworkThreadPriority = IThread::Disabled;
+	m_fNetworkFraming = false;
 #endif
 	m_fUseAsyncNetwork = 0;
 	m_iNetMaxPings = 15;
@@ -367,6 +380,7 @@ enum RC_TYPE
 	RC_ALLOWNEWBTRANSFER,		// m_bAllowNewbTransfer
 	RC_ARCHERYMAXDIST,			// m_iArcheryMaxDist
 	RC_ARCHERYMINDIST,			// m_iArcheryMinDist
+	RC_AREAOFINTEREST,			// m_fAreaOfInterest
 	RC_ARRIVEDEPARTMSG,
 	RC_ATTACKERTIMEOUT,			// m_iAttackerTimeout
 	RC_ATTACKINGISACRIME,		// m_fAttackingIsACrime
@@ -461,6 +475,7 @@ enum RC_TYPE
 	RC_LIGHTNIGHT,				// m_iLightNight
 	RC_LOCALIPADMIN,			// m_fLocalIPAdmin
 	RC_LOG,
+	RC_LOGASYNC,				// m_fLogAsync
 	RC_LOGMASK,					// GetLogMask
 	RC_LOOTINGISACRIME,			// m_fLootingIsACrime
 	RC_LOSTNPCTELEPORT,			// m_fLostNPCTeleport
@@ -490,6 +505,7 @@ enum RC_TYPE
 	RC_MOUNTHEIGHT,				// m_iMountHeight
 	RC_MOVERATE,				// m_iMoveRate
 	RC_MULFILES,
+	RC_MULMAPPING,				// m_fMulMapping
 	RC_MURDERDECAYTIME,			// m_iMurderDecayTime;
 	RC_MURDERMINCOUNT,			// m_iMurderMinCount
 	RC_MYSQL,					// m_bMySql
@@ -499,6 +515,7 @@ enum RC_TYPE
 	RC_MYSQLUSER,				// m_sMySqlUser
 	RC_NETTTL,					// m_iNetHistoryTTL
 #ifdef _MTNETWORK
+	RC_NETWORKFRAMING,			// m_fNetworkFraming
 	RC_NETWORKTHREADPRIORITY,	// m_iNetworkThreadPriority
 	RC_NETWORKTHREADS,			// m_iNetworkThreads
 #endif
@@ -515,6 +532,7 @@ enum RC_TYPE
 	RC_OPTIONFLAGS,				// m_iOptionFlags
 	RC_OVERSKILLMULTIPLY,		// m_iOverSkillMultiply
 	RC_PACKETDEATHANIMATION,	// m_iPacketDeathAnimation
+	RC_PACKETPOOL,				// m_fPacketPool
 	RC_PAYFROMPACKONLY,			// m_fPayFromPackOnly
 	RC_PETSINHERITNOTORIETY,	// m_iPetsInheritNotoriety
 	RC_PLAYEREVIL,				// m_iPlayerKarmaEvil
@@ -528,13 +546,19 @@ enum RC_TYPE
 	RC_RTIME,
 	RC_RUNNINGPENALTY,			// m_iStamRunningPenalty
 	RC_SAVEBACKGROUND,			// m_iSaveBackgroundTime
+	RC_SAVEBINARY,				// m_fSaveBinary
+	RC_SAVEFORK,				// m_fSaveFork
 	RC_SAVEPERIOD,
 	RC_SAVESECTORSPERTICK,		// m_iSaveSectorsPerTick
 	RC_SAVESTEPMAXCOMPLEXITY,	// m_iSaveStepMaxComplexity
+	RC_SAVETHREADS,				// m_iSaveThreads
 	RC_SCPFILES,
+	RC_SECTORGRID,				// m_fSectorGrid
 	RC_SECTORSLEEP,				// m_iSectorSleepMask
+	RC_SECTORTHREADS,			// m_iSectorThreads
 	RC_SECURE,
 	RC_SKILLPRACTICEMAX,		// m_iSkillPracticeMax
+	RC_SLABALLOC,				// m_fSlabAlloc
 	RC_SNOOPCRIMINAL,
 	RC_SPEECHOTHER,
 	RC_SPEECHPET,
@@ -557,6 +581,7 @@ enum RC_TYPE
 	RC_TOOLTIPCACHE,			// m_iTooltipCache
 	RC_TOOLTIPMODE,				// m_iTooltipMode
 	RC_TRADEWINDOWSNOOPING,		// m_iTradeWindowSnooping
+	RC_UIDGENERATIONS,			// m_fUIDGenerations
 	RC_UOGSTATUS,				// m_fUOGStatus
 	RC_USEASYNCNETWORK,			// m_fUseAsyncNetwork
 	RC_USEAUTHID,				// m_fUseAuthID
@@ -570,6 +595,7 @@ enum RC_TYPE
 	RC_VENDORTRADETITLE,		// m_fVendorTradeTitle
 	RC_VERSION,
 	RC_WALKBUFFER,
+	RC_WALKCACHE,				// m_fWalkCache
 	RC_WALKREGEN,
 	RC_WOOLGROWTHTIME,			// m_iWoolGrowthTime
 	RC_WOPCOLOR,
@@ -591,6 +617,7 @@ const CAssocReg CResource::sm_szLoadKeys[RC_QTY+1] =
 	{ "ALLOWNEWBTRANSFER",		{ ELEM_BOOL,	OFFSETOF(CResource,m_bAllowNewbTransfer),	0 }},
 	{ "ARCHERYMAXDIST",			{ ELEM_INT,		OFFSETOF(CResource,m_iArcheryMaxDist),		0 }},
 	{ "ARCHERYMINDIST",			{ ELEM_INT,		OFFSETOF(CResource,m_iArcheryMinDist),		0 }},
+	{ "AREAOFINTEREST",			{ ELEM_BOOL,	OFFSETOF(CResource,m_fAreaOfInterest),		0 }},
 	{ "ARRIVEDEPARTMSG",		{ ELEM_INT,		OFFSETOF(CResource,m_iArriveDepartMsg),		0 }},
 	{ "ATTACKERTIMEOUT",		{ ELEM_INT,		OFFSETOF(CResource,m_iAttackerTimeout),		0 }},
 	{ "ATTACKINGISACRIME",		{ ELEM_BOOL,	OFFSETOF(CResource,m_fAttackingIsACrime),	0 }},
@@ -685,6 +712,7 @@ const CAssocReg CResource::sm_szLoadKeys[RC_QTY+1] =
 	{ "LIGHTNIGHT",				{ ELEM_INT,		OFFSETOF(CResource,m_iLightNight),			0 }},
 	{ "LOCALIPADMIN",			{ ELEM_BOOL,	OFFSETOF(CResource,m_fLocalIPAdmin),		0 }}, // The local ip is assumed to be the admin.
 	{ "LOG",					{ ELEM_VOID,	0,											0 }},
+	{ "LOGASYNC",				{ ELEM_BOOL,	OFFSETOF(CResource,m_fLogAsync),			0 }},
 	{ "LOGMASK",				{ ELEM_VOID,	0,											0 }}, // GetLogMask
 	{ "LOOTINGISACRIME",		{ ELEM_BOOL,	OFFSETOF(CResource,m_fLootingIsACrime),		0 }},
 	{ "LOSTNPCTELEPORT",		{ ELEM_INT,		OFFSETOF(CResource,m_iLostNPCTeleport),		0 }},
@@ -714,6 +742,7 @@ const CAssocReg CResource::sm_szLoadKeys[RC_QTY+1] =
 	{ "MOUNTHEIGHT",			{ ELEM_BOOL,	OFFSETOF(CResource,m_iMountHeight),			0 }},
 	{ "MOVERATE",				{ ELEM_INT,		OFFSETOF(CResource,m_iMoveRate),			0 }},
 	{ "MULFILES",				{ ELEM_VOID,	0,											0 }},
+	{ "MULMAPPING",				{ ELEM_BOOL,	OFFSETOF(CResource,m_fMulMapping),			0 }},
 	{ "MURDERDECAYTIME",		{ ELEM_INT,		OFFSETOF(CResource,m_iMurderDecayTime),		0 }},
 	{ "MURDERMINCOUNT",			{ ELEM_INT,		OFFSETOF(CResource,m_iMurderMinCount),		0 }}, // amount of murders before we get title.
 	{ "MYSQL",					{ ELEM_BOOL,	OFFSETOF(CResource,m_bMySql),				0 }},
@@ -723,6 +752,7 @@ const CAssocReg CResource::sm_szLoadKeys[RC_QTY+1] =
 	{ "MYSQLUSER",				{ ELEM_CSTRING,	OFFSETOF(CResource,m_sMySqlUser),			0 }},
 	{ "NETTTL",					{ ELEM_INT,		OFFSETOF(CResource,m_iNetHistoryTTL),		0 }},
 #ifdef _MTNETWORK
+	{ "NETWORKFRAMING",			{ ELEM_BOOL,	OFFSETOF(CResource,m_fNetworkFraming),		0 }},
 	{ "NETWORKTHREADPRIORITY",	{ ELEM_INT,		OFFSETOF(CResource,m_iNetworkThreadPriority),	0 }},
 	{ "NETWORKTHREADS",			{ ELEM_INT,		OFFSETOF(CResource,m_iNetworkThreads),		0 }},
 #endif
@@ -739,6 +769,7 @@ const CAssocReg CResource::sm_szLoadKeys[RC_QTY+1] =
 	{ "OPTIONFLAGS",			{ ELEM_INT,		OFFSETOF(CResource,m_iOptionFlags),			0 }},
 	{ "OVERSKILLMULTIPLY",		{ ELEM_INT,		OFFSETOF(CResource,m_iOverSkillMultiply),	0 }},
 	{ "PACKETDEATHANIMATION",	{ ELEM_BOOL,	OFFSETOF(CResource,m_iPacketDeathAnimation),0 }},
+	{ "PACKETPOOL",				{ ELEM_BOOL,	OFFSETOF(CResource,m_fPacketPool),			0 }},
 	{ "PAYFROMPACKONLY",		{ ELEM_BOOL,	OFFSETOF(CResource,m_fPayFromPackOnly),		0 }},
 	{ "PETSINHERITNOTORIETY",	{ ELEM_INT,		OFFSETOF(CResource,m_iPetsInheritNotoriety),0 }},
 	{ "PLAYEREVIL",				{ ELEM_INT,		OFFSETOF(CResource,m_iPlayerKarmaEvil),		0 }},
@@ -752,13 +783,19 @@ const CAssocReg CResource::sm_szLoadKeys[RC_QTY+1] =
 	{ "RTIME",					{ ELEM_VOID,	0,											0 }},
 	{ "RUNNINGPENALTY",			{ ELEM_INT,		OFFSETOF(CResource,m_iStamRunningPenalty),	0 }},
 	{ "SAVEBACKGROUND",			{ ELEM_INT,		OFFSETOF(CResource,m_iSaveBackgroundTime),	0 }},
+	{ "SAVEBINARY",				{ ELEM_BOOL,	OFFSETOF(CResource,m_fSaveBinary),			0 }},
+	{ "SAVEFORK",				{ ELEM_BOOL,	OFFSETOF(CResource,m_fSaveFork),			0 }},
 	{ "SAVEPERIOD",				{ ELEM_INT,		OFFSETOF(CResource,m_iSavePeriod),			0 }},
 	{ "SAVESECTORSPERTICK",		{ ELEM_INT,		OFFSETOF(CResource,m_iSaveSectorsPerTick),	0 }},
 	{ "SAVESTEPMAXCOMPLEXITY",	{ ELEM_INT,		OFFSETOF(CResource,m_iSaveStepMaxComplexity),	0 }},
+	{ "SAVETHREADS",			{ ELEM_INT,		OFFSETOF(CResource,m_iSaveThreads),			0 }},
 	{ "SCPFILES",				{ ELEM_CSTRING,	OFFSETOF(CResource,m_sSCPBaseDir),			0 }},
+	{ "SECTORGRID",				{ ELEM_BOOL,	OFFSETOF(CResource,m_fSectorGrid),			0 }},
 	{ "SECTORSLEEP",			{ ELEM_INT,		OFFSETOF(CResource,m_iSectorSleepMask),		0 }},
+	{ "SECTORTHREADS",			{ ELEM_INT,		OFFSETOF(CResource,m_iSectorThreads),		0 }},
 	{ "SECURE",					{ ELEM_BOOL,	OFFSETOF(CResource,m_fSecure),				0 }},
 	{ "SKILLPRACTICEMAX",		{ ELEM_WORD,	OFFSETOF(CResource,m_iSkillPracticeMax),	0 }},
+	{ "SLABALLOC",				{ ELEM_BOOL,	OFFSETOF(CResource,m_fSlabAlloc),			0 }},
 	{ "SNOOPCRIMINAL",			{ ELEM_INT,		OFFSETOF(CResource,m_iSnoopCriminal),		0 }},
 	{ "SPEECHOTHER",			{ ELEM_CSTRING,	OFFSETOF(CResource,m_sSpeechOther),			0 }},
 	{ "SPEECHPET",				{ ELEM_CSTRING,	OFFSETOF(CResource,m_sSpeechPet),			0 }},
@@ -781,6 +818,7 @@ const CAssocReg CResource::sm_szLoadKeys[RC_QTY+1] =
 	{ "TOOLTIPCACHE",			{ ELEM_INT,		OFFSETOF(CResource,m_iTooltipCache),		0 }},
 	{ "TOOLTIPMODE",			{ ELEM_INT,		OFFSETOF(CResource,m_iTooltipMode),			0 }},
 	{ "TRADEWINDOWSNOOPING",	{ ELEM_BOOL,	OFFSETOF(CResource,m_iTradeWindowSnooping),	0 }},
+	{ "UIDGENERATIONS",			{ ELEM_BOOL,	OFFSETOF(CResource,m_fUIDGenerations),		0 }},
 	{ "UOGSTATUS",				{ ELEM_BOOL,	OFFSETOF(CResource,m_fUOGStatus),			0 }},
 	{ "USEASYNCNETWORK",		{ ELEM_INT,		OFFSETOF(CResource,m_fUseAsyncNetwork),		0 }},
 	{ "USEAUTHID",				{ ELEM_BOOL,	OFFSETOF(CResource,m_fUseAuthID),			0 }},	// we use authid like osi
@@ -794,6 +832,7 @@ const CAssocReg CResource::sm_szLoadKeys[RC_QTY+1] =
 	{ "VENDORTRADETITLE",		{ ELEM_BOOL,	OFFSETOF(CResource,m_fVendorTradeTitle),	0 }},
 	{ "VERSION",				{ ELEM_VOID,	0,											0 }},
 	{ "WALKBUFFER",				{ ELEM_INT,		OFFSETOF(CResource,m_iWalkBuffer),			0 }},
+	{ "WALKCACHE",				{ ELEM_BOOL,	OFFSETOF(CResource,m_fWalkCache),			0 }},
 	{ "WALKREGEN",				{ ELEM_INT,		OFFSETOF(CResource,m_iWalkRegen),			0 }},
 	{ "WOOLGROWTHTIME",			{ ELEM_INT,		OFFSETOF(CResource,m_iWoolGrowthTime),		0 }},
 	{ "WOPCOLOR",				{ ELEM_INT,		OFFSETOF(CResource,m_iWordsOfPowerColor),	0 }},
@@ -1121,6 +1160,38 @@ bool CResource::r_LoadVal( CScript &s )
 			}
 			break;
 
+		case RC_SECTORGRID:
+			if ( g_Serv.m_iModeCode == SERVMODE_Loading )	// not on resync, the objects already placed are in no cell
+				m_fSectorGrid = (s.GetArgVal() != 0);
+			else if ( (s.GetArgVal() != 0) != m_fSectorGrid )
+				g_Log.EventError("The value of SectorGrid cannot be modified after the server has started\n");
+			break;
+
+		case RC_SLABALLOC:
+			if ( g_Serv.m_iModeCode == SERVMODE_Loading && !CSlab::IsEnabled() )	// not on resync, and never off again
+			{
+				m_fSlabAlloc = (s.GetArgVal() != 0);
+				if ( m_fSlabAlloc )
+					CSlab::Enable();
+			}
+			else if ( (s.GetArgVal() != 0) != m_fSlabAlloc )
+				g_Log.EventError("The value of SlabAlloc cannot be modified after the server has started\n");
+			break;
+
+		case RC_UIDGENERATIONS:
+			if ( g_Serv.m_iModeCode == SERVMODE_Loading )	// not on resync, the uids in use would no longer match their slots
+				m_fUIDGenerations = (s.GetArgVal() != 0);
+			else if ( (s.GetArgVal() != 0) != m_fUIDGenerations )
+				g_Log.EventError("The value of UIDGenerations cannot be modified after the server has started\n");
+			break;
+
+		case RC_SECTORTHREADS:
+			if ( g_Serv.m_iModeCode == SERVMODE_Loading )	// not on resync, the threads are started already
+				m_iSectorThreads = s.GetArgVal();
+			else
+				g_Log.EventError("The value of SectorThreads cannot be modified after the server has started\n");
+			break;
+
 		case RC_SAVEBACKGROUND:
 			m_iSaveBackgroundTime = s.GetArgVal() * 60 * TICK_PER_SEC;
 			break;
@@ -3411,7 +3482,7 @@ RESOURCE_ID CResource::ResourceGetNewID( RES_TYPE restype, LPCTSTR pszName, CVar
 		int iVarNum = g_Exp.m_VarDefs.SetNum( pszName, rid.GetPrivateUID() );
 		if ( iVarNum >= 0 )
 		{
-			*ppVarNum = dynamic_cast <CVarDefContNum*>( g_Exp.m_VarDefs.GetAt(iVarNum));
+			*ppVarNum = dynamic_cast <CVarDefContNum*>( g_Exp.m_VarDefs.GetKey(pszName));
 		}
 	}
 
@@ -716,8 +716,17 @@ public:
 	int	 m_fUseHTTP;
 	bool m_fUseAuthID;
 	int  m_iMapCacheTime;		// Time in sec to keep unused map data.
+	bool m_fWalkCache;			// Cache the walk checks of each sector until something in it changes.
+	bool m_fSectorGrid;			// Index the objects of each sector by cells for CWorldSearch.
+	bool m_fAreaOfInterest;		// Send moves, speech and object updates only to the clients in the sectors nearby.
 	int	 m_iSectorSleepMask;	// The mask for how long sectors will sleep.
+	unsigned int m_iSectorThreads;	// Number of threads ticking the sectors. (0 = main thread only)
 	bool m_fUseMapDiffs;			// Whether or not to use map diff files.
+	bool m_fMulMapping;				// Map the map, statics and tiledata files into memory instead of reading them.
+	bool m_fLogAsync;				// Write the log from a separate thread.
+	bool m_fPacketPool;				// Keep the buffers of deleted packets for reuse.
+	bool m_fUIDGenerations;			// Keep a generation in the UIDs so stale ones no longer find a reused slot.
+	bool m_fSlabAlloc;				// Allocate items, chars and their satellites from per class slabs.
 
 	CGString m_sWorldBaseDir;	// "e:\graysvr\worldsave\" = world files go here.
 	CGString m_sAcctBaseDir;	// Where do the account files go/come from ?
@@ -748,6 +757,9 @@ public:
 	unsigned int  m_iSaveSectorsPerTick;     // max number of sectors per dynamic background save step
 	unsigned int  m_iSaveStepMaxComplexity;  // maximum "number of items+characters" saved at once during dynamic background save
 	bool m_fSaveGarbageCollect;	// Always force a full garbage collection.
+	bool m_fSaveBinary;			// Write the world files as binary records instead of text.
+	unsigned int m_iSaveThreads;	// Threads serializing the sectors of a forced binary save. (0 = main thread only)
+	bool m_fSaveFork;			// Write the periodic saves from a forked copy of the world. (Linux only)
 
 	// Account
 	int  m_iDeadSocketTime;
@@ -986,6 +998,7 @@ public:
 #ifdef _MTNETWORK
 	unsigned int m_iNetworkThreads;			// number of network threads to create
 	unsigned int m_iNetworkThreadPriority;	// priority of network threads
+	bool		m_fNetworkFraming;			// decrypt and split the packets of clients in game in the network threads
 #endif
 	int			m_fUseAsyncNetwork;			// 0=normal send, 1=async send, 2=async send for 4.0.0+ only
 	int			m_iNetMaxPings;				// max pings before blocking an ip
@@ -3,11 +3,10 @@
 //////////////////////////////////////////////////////////////////
 // -CSector
 
-int CSectorBase::m_iMapBlockCacheTime = 0;
-
 CSector::CSector()
 {
 	m_ListenItems = 0;
+	m_pItemsDue = NULL;
 
 	m_RainChance = 0;		// 0 to 100%
 	m_ColdChance = 0;		// Will be snow if rain chance success.
@@ -238,6 +237,13 @@ bool CSector::r_Verb( CScript & s, CTextConsole * pSrc )
 void CSector::r_Write()
 {
 	ADDTOCALLSTACK_INTENSIVE("CSector::r_Write");
+	r_Write(g_World.m_FileWorld, g_World.m_FilePlayers, g_World.m_FileMultis);
+}
+
+void CSector::r_Write( CScript & sWorld, CScript & sPlayers, CScript & sMultis )
+{
+	ADDTOCALLSTACK_INTENSIVE("CSector::r_Write");
+	// Sectors may be written on the CSectorSaver threads, only write to the given files.
 	if ( m_fSaveParity == g_World.m_fSaveParity )
 		return; // already saved.
 	CPointMap pt = GetBasePoint();
@@ -247,8 +253,8 @@ void CSector::r_Write()
 
 	if ( m_dwFlags > 0)
 	{
-		g_World.m_FileWorld.WriteSection("SECTOR %d,%d,0,%d", pt.m_x, pt.m_y, pt.m_map );
-		g_World.m_FileWorld.WriteKeyHex("FLAGS", m_dwFlags);
+		sWorld.WriteSection("SECTOR %d,%d,0,%d", pt.m_x, pt.m_y, pt.m_map );
+		sWorld.WriteKeyHex("FLAGS", m_dwFlags);
 		bHeaderCreated = true;
 	}
 
@@ -256,34 +262,34 @@ void CSector::r_Write()
 	{
 		if ( bHeaderCreated == false )
 		{
-			g_World.m_FileWorld.WriteSection("SECTOR %d,%d,0,%d", pt.m_x, pt.m_y, pt.m_map);
+			sWorld.WriteSection("SECTOR %d,%d,0,%d", pt.m_x, pt.m_y, pt.m_map);
 			bHeaderCreated = true;
 		}
 
-		g_World.m_FileWorld.WriteKeyVal("LIGHT", GetLight());
+		sWorld.WriteKeyVal("LIGHT", GetLight());
 	}
 
 	if (!g_Cfg.m_fNoWeather && (IsRainOverriden() || IsColdOverriden()))
 	{
 		if ( bHeaderCreated == false )
 		{
-			g_World.m_FileWorld.WriteSection("SECTOR %d,%d,0,%d", pt.m_x, pt.m_y, pt.m_map);
+			sWorld.WriteSection("SECTOR %d,%d,0,%d", pt.m_x, pt.m_y, pt.m_map);
 			bHeaderCreated = true;
 		}
 
 		if ( IsRainOverriden() )
-			g_World.m_FileWorld.WriteKeyVal("RAINCHANCE", GetRainChance());
+			sWorld.WriteKeyVal("RAINCHANCE", GetRainChance());
 
 		if ( IsColdOverriden() )
-			g_World.m_FileWorld.WriteKeyVal("COLDCHANCE", GetColdChance());
+			sWorld.WriteKeyVal("COLDCHANCE", GetColdChance());
 	}
 
 	if (GetSeason() != SEASON_Summer)
 	{
 		if ( bHeaderCreated == false )
-			g_World.m_FileWorld.WriteSection("SECTOR %d,%d,0,%d", pt.m_x, pt.m_y, pt.m_map);
+			sWorld.WriteSection("SECTOR %d,%d,0,%d", pt.m_x, pt.m_y, pt.m_map);
 
-		g_World.m_FileWorld.WriteKeyVal("SEASON", GetSeason());
+		sWorld.WriteKeyVal("SEASON", GetSeason());
 	}
 
 	// Chars in the sector.
@@ -291,14 +297,14 @@ void CSector::r_Write()
 	for ( CChar *pChar = static_cast<CChar*>(m_Chars_Active.GetHead()); pChar != NULL; pChar = pCharNext )
 	{
 		pCharNext = pChar->GetNext();
-		pChar->r_WriteParity(pChar->m_pPlayer ? g_World.m_FilePlayers : g_World.m_FileWorld);
+		pChar->r_WriteParity(pChar->m_pPlayer ? sPlayers : sWorld);
 	}
 
 	// Inactive Client Chars, ridden horses and dead NPCs (NOTE: Push inactive player chars out to the account files here?)
 	for ( CChar *pChar = static_cast<CChar*>(m_Chars_Disconnect.GetHead()); pChar != NULL; pChar = pCharNext )
 	{
 		pCharNext = pChar->GetNext();
-		pChar->r_WriteParity(pChar->m_pPlayer ? g_World.m_FilePlayers : g_World.m_FileWorld);
+		pChar->r_WriteParity(pChar->m_pPlayer ? sPlayers : sWorld);
 	}
 
 	// Items on the ground.
@@ -307,18 +313,18 @@ void CSector::r_Write()
 	{
 		pItemNext = pItem->GetNext();
 		if ( pItem->IsType(IT_MULTI_CUSTOM) )
-			pItem->r_WriteSafe(g_World.m_FileMultis);
+			pItem->r_WriteSafe(sMultis);
 		else if ( !pItem->IsAttr(ATTR_STATIC) )
-			pItem->r_WriteSafe(g_World.m_FileWorld);
+			pItem->r_WriteSafe(sWorld);
 	}
 
 	for ( CItem *pItem = static_cast<CItem*>(m_Items_Timer.GetHead()); pItem != NULL; pItem = pItemNext )
 	{
 		pItemNext = pItem->GetNext();
 		if ( pItem->IsType(IT_MULTI_CUSTOM) )
-			pItem->r_WriteSafe(g_World.m_FileMultis);
+			pItem->r_WriteSafe(sMultis);
 		else if ( !pItem->IsAttr(ATTR_STATIC) )
-			pItem->r_WriteSafe(g_World.m_FileWorld);
+			pItem->r_WriteSafe(sWorld);
 	}
 }
 
@@ -782,19 +788,23 @@ void CSector::OnHearItem( CChar * pChar, TCHAR * szText )
 	}
 }
 
-void CSector::MoveItemToSector( CItem * pItem, bool fActive )
+void CSector::MoveItemToSector( CItem * pItem, bool fActive, bool fNotAMove )
 {
 	ADDTOCALLSTACK("CSector::MoveItemToSector");
 	// remove from previous list and put in new.
-	// May just be setting a timer. SetTimer or MoveTo()
+	// May just be setting a timer. SetTimer (fNotAMove) or MoveTo()
 	ASSERT( pItem );
+	if ( CSectorTicker::DeferMove( this, pItem, fActive, fNotAMove ))
+		return;	// another stripe is ticking this sector
+
 	if ( fActive )
 	{
-		m_Items_Timer.AddItemToSector( pItem );
+		m_Items_Timer.AddItemToSector( pItem, fNotAMove );
+		g_World.m_TimerWheel.Schedule( pItem );
 	}
 	else
 	{
-		m_Items_Inert.AddItemToSector( pItem );
+		m_Items_Inert.AddItemToSector( pItem, fNotAMove );
 	}
 }
 
@@ -838,6 +848,8 @@ bool CSector::MoveCharToSector(CChar * pChar)
 
 	if (IsCharActiveIn(pChar))
 		return false;	// already here
+	if (CSectorTicker::DeferMove(this, pChar, true))
+		return true;	// another stripe is ticking this sector
 
 	CheckSaveParity(pChar);
 
@@ -855,6 +867,8 @@ bool CSector::MoveDisconnectedCharToSector(CChar * pChar)
 
 	if (IsCharDisconnectedIn(pChar))
 		return false;	// already here
+	if (CSectorTicker::DeferMove(this, pChar, false))
+		return true;	// another stripe is ticking this sector
 
 	CheckSaveParity(pChar);
 
@@ -969,6 +983,8 @@ void CSector::OnTick(int iPulseCount)
 	//	do not tick sectors on maps not supported by server
 	if ( !g_MapList.m_maps[m_map] ) return;
 
+	ProfileScope sectorScope("sector tick");
+
 	// Check for light change before putting the sector to sleep, since in other case the
 	// world light levels will be shitty
 	bool fEnvironChange = false;
@@ -1069,6 +1085,7 @@ void CSector::OnTick(int iPulseCount)
 	// regen all creatures and do AI
 
 	ProfileTask charactersTask(PROFILE_CHARS);
+	ProfileScope charactersScope("chars");
 
 	CChar * pCharNext = NULL;
 	CChar * pChar = static_cast<CChar *>(m_Chars_Active.GetHead());
@@ -1077,6 +1094,8 @@ void CSector::OnTick(int iPulseCount)
 		EXC_TRYSUB("TickChar");
 
 		pCharNext = pChar->GetNext();
+		if ( pChar->IsDeletePending() )
+			continue;	// deleted from another stripe, leaves the list at the end of the phase.
 		if ( fEnvironChange && IsTrigUsed(TRIGGER_ENVIRONCHANGE) )
 			pChar->OnTrigger(CTRIG_EnvironChange, pChar);
 
@@ -1116,19 +1135,19 @@ void CSector::OnTick(int iPulseCount)
 	}
 
 	// decay items on ground = time out spells / gates etc.. etc..
-	// No need to check these so often !
+	// Only the items whose timer expired, CTimerWheel has put them in m_pItemsDue.
 
 	ProfileTask itemsTask(PROFILE_ITEMS);
+	ProfileScope itemsScope("items");
 
-	CItem * pItemNext = NULL;
-	CItem * pItem = dynamic_cast <CItem*>( m_Items_Timer.GetHead());
-	for ( ; pItem != NULL; pItem = pItemNext )
+	CItem * pItem = NULL;
+	while ( (pItem = m_pItemsDue) != NULL )
 	{
 		EXC_TRYSUB("TickItem");
-		pItemNext = pItem->GetNext();
+		CTimerWheel::Unlink(pItem);
 
 		EXC_SETSUB("TimerExpired");
-		if ( pItem->IsTimerExpired() )
+		if ( pItem->IsTimerExpired() && !pItem->IsDeletePending() )
 		{
 			EXC_SETSUB("ItemTick");
 			if ( !pItem->OnTick() )
@@ -1147,9 +1166,6 @@ void CSector::OnTick(int iPulseCount)
 			}
 		}
 
-		EXC_SETSUB("UpdateFlags");
-		pItem->OnTickStatusUpdate();
-
 #ifdef _WIN32
 		EXC_CATCHSUB("Sector");
 
@@ -1190,8 +1206,7 @@ void CSector::OnTick(int iPulseCount)
 	if ( fSleeping || ! ( iPulseCount & 0x7f ))	// 30 seconds or so.
 	{
 		// delete the static CGrayMapBlock items that have not been used recently.
-		m_iMapBlockCacheTime = ( fSleeping ? 0 : g_Cfg.m_iMapCacheTime );
-		CheckMapBlockCache();
+		CheckMapBlockCache( fSleeping ? 0 : g_Cfg.m_iMapCacheTime );
 	}
 	EXC_CATCH;
 
@@ -1201,3 +1216,570 @@ void CSector::OnTick(int iPulseCount)
 	EXC_DEBUG_END;
 }
 
+
+//////////////////////////////////////////////////////////////////
+// -CSectorTickContext
+
+CSectorTickContext::CSectorTickContext()
+{
+	m_pStripe = NULL;
+}
+
+bool CSectorTickContext::IsInStripe( const CSectorBase * pSector ) const
+{
+	if ( m_pStripe == NULL || pSector == NULL )
+		return false;
+	if ( pSector->GetMap() != m_pStripe->m_map )
+		return false;
+
+	int iCol = pSector->GetIndex() % g_MapList.GetSectorCols(m_pStripe->m_map);
+	return ( iCol >= m_pStripe->m_iColStart && iCol < m_pStripe->m_iColEnd );
+}
+
+bool CSectorTickContext::IsPending( const CObjBase * pObj ) const
+{
+	// Has a list change of this object been deferred already ?
+	// Later ones have to wait too, or they would be done out of order.
+	for ( std::vector<CSectorTickMove>::const_iterator it = m_Moves.begin(); it != m_Moves.end(); ++it )
+	{
+		if ( it->m_pObj == pObj )
+			return true;
+	}
+	return false;
+}
+
+void CSectorTickContext::Merge()
+{
+	ADDTOCALLSTACK("CSectorTickContext::Merge");
+	// Called from the ticking thread once the phase is over, nothing else is running.
+	// The deferred moves are done later by MergeMoves(), once every context is merged.
+
+	CGObListRec * pRec;
+	while ( (pRec = m_ObjNew.GetHead()) != NULL )
+		g_World.m_ObjNew.InsertHead(pRec);
+	while ( (pRec = m_ObjDelete.GetHead()) != NULL )
+		g_World.m_ObjDelete.InsertHead(pRec);
+
+	for ( size_t i = 0; i < m_ObjStatusUpdates.GetCount(); i++ )
+	{
+		CObjBase * pObj = m_ObjStatusUpdates.GetAt(i);
+		if ( !g_World.m_ObjStatusUpdates.ContainsPtr(pObj) )
+			g_World.m_ObjStatusUpdates.Add(pObj);
+	}
+	m_ObjStatusUpdates.RemoveAll();
+}
+
+void CSectorTickContext::MergeMoves()
+{
+	ADDTOCALLSTACK("CSectorTickContext::MergeMoves");
+	// Do the deferred list changes in the order they were asked for.
+	// sm_fParallel is off now so nothing gets deferred again.
+
+	for ( std::vector<CSectorTickMove>::iterator it = m_Moves.begin(); it != m_Moves.end(); ++it )
+	{
+		CObjBase * pObj = it->m_pObj;
+		if ( it->m_type == TICKMOVE_DELETE )
+		{
+			CSectorTicker::ObjDelete(pObj);	// out of the sector list now.
+			continue;
+		}
+		if ( pObj->IsDeleted() )
+			continue;
+
+		switch ( it->m_type )
+		{
+			case TICKMOVE_SECTOR:
+				if ( pObj->GetTopPoint().GetSector() != it->m_pSector )
+					break;	// not there anymore.
+				if ( pObj->IsItem() )
+				{
+					CItem * pItem = static_cast<CItem *>(pObj);
+					if ( pItem->GetParentObj() == NULL )
+						it->m_pSector->MoveItemToSector(pItem, pItem->IsTimerSet(), it->m_fNotAMove);
+				}
+				else if ( it->m_fActive )
+					it->m_pSector->MoveCharToSector(static_cast<CChar *>(pObj));
+				else
+					it->m_pSector->MoveDisconnectedCharToSector(static_cast<CChar *>(pObj));
+				break;
+			case TICKMOVE_CONT:
+				if ( !it->m_pCont->IsDeleted() )
+					static_cast<CItemContainer *>(it->m_pCont)->ContentAdd(static_cast<CItem *>(pObj), it->m_pt, static_cast<BYTE>(it->m_iArg));
+				break;
+			case TICKMOVE_EQUIP:
+				if ( !it->m_pCont->IsDeleted() )
+					static_cast<CChar *>(it->m_pCont)->ItemEquip(static_cast<CItem *>(pObj));
+				break;
+			case TICKMOVE_LAYER:
+				if ( !it->m_pCont->IsDeleted() )
+					static_cast<CChar *>(it->m_pCont)->LayerAdd(static_cast<CItem *>(pObj), static_cast<LAYER_TYPE>(it->m_iArg));
+				break;
+			default:
+				break;
+		}
+	}
+	m_Moves.clear();
+}
+
+//////////////////////////////////////////////////////////////////
+// -CSectorTickThread
+
+static const char * GenerateSectorThreadName( const char * pszName, size_t id )
+{
+	char * pszThreadName = new char[32];
+	sprintf(pszThreadName, "%s #%" FMTSIZE_T, pszName, id);
+	return pszThreadName;
+}
+
+CSectorTickThread::CSectorTickThread( CSectorTicker & ticker, size_t id ) :
+	AbstractSphereThread(GenerateSectorThreadName("SectorThread", id), IThread::Disabled), m_ticker(ticker)
+{
+}
+
+CSectorTickThread::~CSectorTickThread()
+{
+	// thread name was allocated by GenerateSectorThreadName, so should be delete[]'d
+	delete[] getName();
+}
+
+void CSectorTickThread::onStart()
+{
+	AbstractSphereThread::onStart();
+	CSectorTicker::sm_pContext = &m_Context;
+	m_profile.EnableProfile(PROFILE_CHARS);
+	m_profile.EnableProfile(PROFILE_ITEMS);
+}
+
+void CSectorTickThread::tick()
+{
+	ADDTOCALLSTACK("CSectorTickThread::tick");
+	// Woken up for each phase, help until no stripe is left.
+	while ( m_ticker.TickNextStripe() )
+		;
+}
+
+//////////////////////////////////////////////////////////////////
+// -CSectorTicker
+
+volatile bool CSectorTicker::sm_fParallel = false;
+SimpleMutex CSectorTicker::sm_WorldLock;
+TlsValue<CSectorTickContext *> CSectorTicker::sm_pContext;
+
+CSectorTicker::CSectorTicker()
+{
+	m_iNextStripe = 0;
+	m_iBusy = 0;
+	m_iPulse = 0;
+}
+
+CSectorTicker::~CSectorTicker()
+{
+	Stop();
+}
+
+void CSectorTicker::Start()
+{
+	ADDTOCALLSTACK("CSectorTicker::Start");
+	if ( g_Cfg.m_iSectorThreads <= 0 || IsActive() )
+		return;
+
+	// About 4 stripes per thread and phase so a busy stripe doesn't hold the others,
+	// but at least 2 columns wide: a char can only step into the next column.
+	size_t iThreads = g_Cfg.m_iSectorThreads;
+	for ( int m = 0; m < 256; m++ )
+	{
+		if ( !g_MapList.m_maps[m] )
+			continue;
+
+		int iCols = g_MapList.GetSectorCols(m);
+		int iStripes = static_cast<int>(iThreads * 8);
+		if ( iStripes > iCols / 2 )
+			iStripes = iCols / 2;
+		if ( iStripes < 1 )
+			iStripes = 1;
+
+		for ( int i = 0; i < iStripes; i++ )
+		{
+			CSectorStripe stripe;
+			stripe.m_map = m;
+			stripe.m_iColStart = (i * iCols) / iStripes;
+			stripe.m_iColEnd = ((i + 1) * iCols) / iStripes;
+			m_Stripes.push_back(stripe);
+		}
+	}
+
+	for ( size_t i = 0; i < iThreads; i++ )
+	{
+		CSectorTickThread * pThread = new CSectorTickThread(*this, i);
+		m_Threads.push_back(pThread);
+		pThread->start();
+	}
+
+	g_Log.Event(LOGM_INIT, "Ticking sectors on %" FMTSIZE_T " threads (%" FMTSIZE_T " stripes)\n", m_Threads.size(), m_Stripes.size());
+}
+
+void CSectorTicker::Stop()
+{
+	ADDTOCALLSTACK("CSectorTicker::Stop");
+	for ( std::vector<CSectorTickThread *>::iterator it = m_Threads.begin(); it != m_Threads.end(); ++it )
+	{
+		(*it)->waitForClose();
+		delete *it;
+	}
+	m_Threads.clear();
+	m_Stripes.clear();
+}
+
+bool CSectorTicker::TickNextStripe()
+{
+	ADDTOCALLSTACK("CSectorTicker::TickNextStripe");
+	const CSectorStripe * pStripe = NULL;
+	int iPulse = 0;
+	{
+		SimpleThreadLock lock(m_StripeLock);
+		if ( !sm_fParallel || m_iNextStripe >= m_Stripes.size() )
+			return false;
+
+		pStripe = &m_Stripes[m_iNextStripe];
+		m_iNextStripe += 2;	// leave the neighbour for the other phase.
+		m_iBusy++;
+		iPulse = m_iPulse;
+	}
+
+	CSectorTickContext * pContext = sm_pContext.get();
+	ASSERT(pContext);
+	pContext->m_pStripe = pStripe;
+
+	int iCols = g_MapList.GetSectorCols(pStripe->m_map);
+	int iRows = g_MapList.GetSectorRows(pStripe->m_map);
+	for ( int y = 0; y < iRows; y++ )
+	{
+		for ( int x = pStripe->m_iColStart; x < pStripe->m_iColEnd; x++ )
+		{
+			EXC_TRYSUB("Tick");
+
+			CSector * pSector = g_World.GetSector(pStripe->m_map, (y * iCols) + x);
+			if ( pSector )
+				pSector->OnTick(iPulse);
+
+			EXC_CATCHSUB("Sector");
+		}
+	}
+	pContext->m_pStripe = NULL;
+
+	{
+		SimpleThreadLock lock(m_StripeLock);
+		m_iBusy--;
+	}
+	m_PhaseEvent.signal();
+	return true;
+}
+
+void CSectorTicker::OnTick( int iPulse )
+{
+	ADDTOCALLSTACK("CSectorTicker::OnTick");
+	// Tick all the sectors, return when all are done.
+	sm_pContext = &m_MainContext;
+
+	for ( size_t iPhase = 0; iPhase < 2; iPhase++ )
+	{
+		sm_fParallel = true;
+		{
+			SimpleThreadLock lock(m_StripeLock);
+			m_iNextStripe = iPhase;
+			m_iBusy = 0;
+			m_iPulse = iPulse;
+		}
+
+		for ( std::vector<CSectorTickThread *>::iterator it = m_Threads.begin(); it != m_Threads.end(); ++it )
+			(*it)->awaken();
+
+		// Help the workers, then wait for the stripes they are still busy with.
+		while ( TickNextStripe() )
+			;
+
+		for (;;)
+		{
+			{
+				SimpleThreadLock lock(m_StripeLock);
+				if ( m_iBusy == 0 )
+				{
+					sm_fParallel = false;
+					break;
+				}
+			}
+			m_PhaseEvent.wait(1);
+		}
+
+		// Barrier: merge what has been deferred during the phase.
+		// All the deletes first, so the moves see them.
+		m_MainContext.Merge();
+		for ( std::vector<CSectorTickThread *>::iterator it = m_Threads.begin(); it != m_Threads.end(); ++it )
+			(*it)->m_Context.Merge();
+
+		m_MainContext.MergeMoves();
+		for ( std::vector<CSectorTickThread *>::iterator it = m_Threads.begin(); it != m_Threads.end(); ++it )
+			(*it)->m_Context.MergeMoves();
+	}
+
+	sm_pContext = NULL;
+}
+
+MTRand & CSectorTicker::GetRand() // static
+{
+	CSectorTickContext * pContext = GetContext();
+	if ( pContext )
+		return pContext->m_Rand;
+	return g_World.m_Rand;
+}
+
+bool CSectorTicker::IsDeferred( const CObjBase * pObj ) // static
+{
+	// Must list changes of this object wait for the end of the phase ?
+	// Yes if it is in a sector list of another stripe, that stripe may be walking the list now.
+	CSectorTickContext * pContext = GetContext();
+	if ( pContext == NULL )
+		return false;
+	if ( pContext->IsPending(pObj) )
+		return true;
+
+	const CSectorObjList * pList = dynamic_cast<const CSectorObjList *>(pObj->GetParent());
+	if ( pList == NULL )
+		return false;	// in a container or nowhere yet.
+	return !pContext->IsInStripe(pList->GetSector());
+}
+
+bool CSectorTicker::DeferMove( CSector * pSector, CObjBase * pObj, bool fActive, bool fNotAMove ) // static
+{
+	// Moves into or out of sectors outside the current stripe wait for the end of the phase.
+	// RETURN: true = deferred.
+	CSectorTickContext * pContext = GetContext();
+	if ( pContext == NULL )
+		return false;
+	if ( pContext->IsInStripe(pSector) && !IsDeferred(pObj) )
+		return false;
+
+	CSectorTickMove move;
+	move.m_type = TICKMOVE_SECTOR;
+	move.m_pObj = pObj;
+	move.m_pSector = pSector;
+	move.m_fActive = fActive;
+	move.m_fNotAMove = fNotAMove;
+	move.m_pCont = NULL;
+	move.m_iArg = 0;
+	pContext->m_Moves.push_back(move);
+	return true;
+}
+
+bool CSectorTicker::DeferContent( TICKMOVE_TYPE type, CObjBase * pCont, CItem * pItem, const CPointMap & pt, int iArg ) // static
+{
+	// Putting an item of another stripe's sector in a container (or equipping it).
+	// RETURN: true = deferred.
+	if ( !IsDeferred(pItem) )
+		return false;
+
+	CSectorTickMove move;
+	move.m_type = type;
+	move.m_pObj = pItem;
+	move.m_pSector = NULL;
+	move.m_fActive = false;
+	move.m_fNotAMove = false;
+	move.m_pCont = pCont;
+	move.m_pt = pt;
+	move.m_iArg = iArg;
+	GetContext()->m_Moves.push_back(move);
+	return true;
+}
+
+bool CSectorTicker::DeferDelete( CObjBase * pObj ) // static
+{
+	// Deleting an object of another stripe's sector, it is only taken out of the sector list at the end of the phase.
+	// It is IsDeleted() already and skipped by the ticks and searches until then.
+	// RETURN: true = deferred.
+	if ( !IsDeferred(pObj) )
+		return false;
+
+	CSectorTickMove move;
+	move.m_type = TICKMOVE_DELETE;
+	move.m_pObj = pObj;
+	move.m_pSector = NULL;
+	move.m_fActive = false;
+	move.m_fNotAMove = false;
+	move.m_pCont = NULL;
+	move.m_iArg = 0;
+	GetContext()->m_Moves.push_back(move);
+	return true;
+}
+
+void CSectorTicker::ObjNew( CObjBase * pObj ) // static
+{
+	CSectorTickContext * pContext = GetContext();
+	if ( pContext )
+		pContext->m_ObjNew.InsertHead(pObj);
+	else
+		g_World.m_ObjNew.InsertHead(pObj);
+}
+
+void CSectorTicker::ObjDelete( CObjBase * pObj ) // static
+{
+	CSectorTickContext * pContext = GetContext();
+	if ( pContext )
+		pContext->m_ObjDelete.InsertHead(pObj);
+	else
+		g_World.m_ObjDelete.InsertHead(pObj);
+}
+
+void CSectorTicker::ObjStatusUpdate( CObjBase * pObj ) // static
+{
+	CSectorTickContext * pContext = GetContext();
+	CGPtrTypeArray<CObjBase*> & list = pContext ? pContext->m_ObjStatusUpdates : g_World.m_ObjStatusUpdates;
+	if ( !list.ContainsPtr(pObj) )
+		list.Add(pObj);
+}
+
+//////////////////////////////////////////////////////////////////
+// -CSectorSaveThread
+
+CSectorSaveThread::CSectorSaveThread( CSectorSaver & saver, size_t id ) :
+	AbstractSphereThread(GenerateSectorThreadName("SectorSaveThread", id), IThread::Disabled), m_saver(saver)
+{
+}
+
+CSectorSaveThread::~CSectorSaveThread()
+{
+	// thread name was allocated by GenerateSectorThreadName, so should be delete[]'d
+	delete[] getName();
+}
+
+void CSectorSaveThread::tick()
+{
+	ADDTOCALLSTACK("CSectorSaveThread::tick");
+	// Woken up for each window, help until no sector is left.
+	while ( m_saver.SaveNextSector() )
+		;
+}
+
+//////////////////////////////////////////////////////////////////
+// -CSectorSaver
+
+CSectorSaver::CSectorSaver()
+{
+	m_pBuffers = NULL;
+	m_iFirst = 0;
+	m_iCount = 0;
+	m_iNext = 0;
+	m_iBusy = 0;
+}
+
+CSectorSaver::~CSectorSaver()
+{
+	ASSERT(m_Threads.empty());
+	ASSERT(m_pBuffers == NULL);
+}
+
+bool CSectorSaver::CanSave() const
+{
+	// Only while a forced binary save freezes the world. Objects are fixed up while they
+	// are written when ForceGarbageCollect is off, and that can't be done in parallel.
+	if ( g_Cfg.m_iSaveThreads <= 0 || !g_Cfg.m_fSaveGarbageCollect )
+		return false;
+	return( g_World.m_FileWorld.IsBinaryMode() && g_Serv.m_iModeCode == SERVMODE_Saving );
+}
+
+bool CSectorSaver::SaveNextSector()
+{
+	ADDTOCALLSTACK("CSectorSaver::SaveNextSector");
+	size_t i = 0;
+	{
+		SimpleThreadLock lock(m_Lock);
+		if ( m_iNext >= m_iCount )
+			return false;
+
+		i = m_iNext++;
+		m_iBusy++;
+	}
+
+	EXC_TRYSUB("Save");
+
+	CSector * pSector = g_World.m_Sectors[m_iFirst + i];
+	if ( pSector )
+		pSector->r_Write(m_pBuffers[i].m_World, m_pBuffers[i].m_Players, m_pBuffers[i].m_Multis);
+
+	EXC_CATCHSUB("Sector");
+
+	{
+		SimpleThreadLock lock(m_Lock);
+		m_iBusy--;
+	}
+	m_DoneEvent.signal();
+	return true;
+}
+
+void CSectorSaver::Save( size_t iFrom, size_t iTo )
+{
+	ADDTOCALLSTACK("CSectorSaver::Save");
+	// Save the sectors iFrom to iTo, return when they have all been written.
+	size_t iThreads = g_Cfg.m_iSaveThreads;
+	size_t iWindow = iThreads * 32;
+	m_pBuffers = new CSectorSaveBuffer[iWindow];
+
+	for ( size_t i = 0; i < iThreads; i++ )
+	{
+		CSectorSaveThread * pThread = new CSectorSaveThread(*this, i);
+		m_Threads.push_back(pThread);
+		pThread->start();
+	}
+
+	for ( size_t iFirst = iFrom; iFirst < iTo; iFirst += iWindow )
+	{
+		size_t iCount = minimum(iWindow, iTo - iFirst);
+		{
+			SimpleThreadLock lock(m_Lock);
+			m_iFirst = iFirst;
+			m_iCount = iCount;
+			m_iNext = 0;
+			m_iBusy = 0;
+		}
+
+		for ( std::vector<CSectorSaveThread *>::iterator it = m_Threads.begin(); it != m_Threads.end(); ++it )
+			(*it)->awaken();
+
+		// Help the workers, then wait for the sectors they are still busy with.
+		while ( SaveNextSector() )
+			;
+
+		for (;;)
+		{
+			{
+				SimpleThreadLock lock(m_Lock);
+				if ( m_iBusy == 0 )
+					break;
+			}
+			m_DoneEvent.wait(1);
+		}
+
+		// Append the window in sector order, one block per sector.
+		for ( size_t i = 0; i < iCount; i++ )
+		{
+			g_World.m_FileWorld.WriteBlock(m_pBuffers[i].m_World);
+			g_World.m_FilePlayers.WriteBlock(m_pBuffers[i].m_Players);
+			g_World.m_FileMultis.WriteBlock(m_pBuffers[i].m_Multis);
+		}
+		g_Serv.PrintPercent(iFirst + iCount, g_World.m_SectorsQty + 3);
+	}
+
+	{
+		SimpleThreadLock lock(m_Lock);
+		m_iCount = 0;
+	}
+
+	for ( std::vector<CSectorSaveThread *>::iterator it = m_Threads.begin(); it != m_Threads.end(); ++it )
+	{
+		(*it)->waitForClose();
+		delete *it;
+	}
+	m_Threads.clear();
+
+	delete[] m_pBuffers;
+	m_pBuffers = NULL;
+}
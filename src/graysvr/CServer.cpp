@@ -1091,6 +1091,9 @@ bool CServer::r_WriteVal( LPCTSTR pszKey, CGString & sVal, CTextConsole * pSrc )
 		return false;
 	}
 
+	if ( !strnicmp(pszKey, "SLAB.", 5) )
+		return CSlab::r_WriteVal(pszKey + 5, sVal);
+
 	// Just do stats values for now.
 	if ( g_Cfg.r_WriteVal(pszKey, sVal, pSrc) )
 		return true;
@@ -1121,6 +1124,7 @@ enum SV_TYPE
 	SV_LOAD,
 	SV_LOG,
 	SV_PRINTLISTS,
+	SV_PROFILESCOPES,
 	SV_RESPAWN,
 	SV_RESTOCK,
 	SV_RESTORE,
@@ -1159,6 +1163,7 @@ LPCTSTR const CServer::sm_szVerbKeys[SV_QTY+1] =
 	"LOAD",
 	"LOG",
 	"PRINTLISTS",
+	"PROFILESCOPES",
 	"RESPAWN",
 	"RESTOCK",
 	"RESTORE",
@@ -1495,6 +1500,32 @@ bool CServer::r_Verb( CScript &s, CTextConsole * pSrc )
 		case SV_CLEARLISTS:
 			g_Exp.m_ListGlobals.ClearKeys(s.GetArgStr());
 			break;
+		case SV_PROFILESCOPES:	// "PROFILESCOPES 0/1/2", "PROFILESCOPES CLEAR", "PROFILESCOPES DUMP"
+			{
+				LPCTSTR pszArg = s.GetArgStr();
+				pszMsg = Str_GetTemp();
+				if ( ! strcmpi(pszArg, "CLEAR") )
+				{
+					ScopeProfiler::sm_dwClear++;
+					strcpy(pszMsg, "Scope profiler cleared.\n");
+				}
+				else if ( ! strcmpi(pszArg, "DUMP") )
+				{
+					if ( ScopeProfiler::Export("profiler_scopes.folded", "profiler_scopes.json") )
+						strcpy(pszMsg, "Scope profiler dumped to profiler_scopes.folded and profiler_scopes.json.\n");
+					else
+						strcpy(pszMsg, "Failed to write the scope profiler dump.\n");
+				}
+				else
+				{
+					if ( *pszArg )
+					{
+						int iMode = ATOI(pszArg);
+						ScopeProfiler::sm_iMode = ( iMode < 0 ) ? 0 : (( iMode > 2 ) ? 2 : iMode);
+					}
+					sprintf(pszMsg, "Scope profiler %s.\n", ( ScopeProfiler::sm_iMode == 0 ) ? "disabled" : (( ScopeProfiler::sm_iMode == 1 ) ? "enabled" : "enabled with trace events"));
+				}
+			} break;
 		default:
 			return CScriptObj::r_Verb(s, pSrc);
 
@@ -1518,6 +1549,7 @@ bool CServer::r_Verb( CScript &s, CTextConsole * pSrc )
 //*********************************************************
 
 extern void defragSphere(char *);
+extern void convertSphere(char *);
 
 bool CServer::CommandLine( int argc, TCHAR * argv[] )
 {
@@ -1539,6 +1571,7 @@ bool CServer::CommandLine( int argc, TCHAR * argv[] )
 			case '?':
 				PrintStr(SPHERE_TITLE " \n"
 					"Command Line Switches:\n"
+					"-Bpath/to/file Converts a save file between text (" SPHERE_SCRIPT ") and binary (" SPHERE_SCRIPT_BIN ")\n"
 #ifdef _WIN32
 					"-cClassName Setup custom window class name for sphere (default: " SPHERE_TITLE "Svr)\n"
 #else
@@ -1604,6 +1637,9 @@ bool CServer::CommandLine( int argc, TCHAR * argv[] )
 					PrintStr("Crash dump NOT enabled.\n");
 				continue;
 #endif
+			case 'B':
+				convertSphere(pArg + 1);
+				continue;
 			case 'G':
 				defragSphere(pArg + 1);
 				continue;
@@ -1642,6 +1678,7 @@ void CServer::SetResyncPause(bool fPause, CTextConsole * pSrc, bool bMessage)
 	{
 		g_Serv.SysMessagef("%s\n",g_Cfg.GetDefaultMsg(DEFMSG_SERVER_RESYNC_RESTART));
 		SetServerMode(SERVMODE_ResyncLoad);
+		CSectorBase::InvalidateWalkCaches();	// item definitions may change
 
 		if ( !g_Cfg.Load(true) )
 		{
@@ -541,6 +541,10 @@ CWorldSearch::CWorldSearch( const CPointMap & pt, int iDist ) :
 	m_fSearchSquare = false;
 	m_pObj = m_pObjNext = NULL;
 	m_fInertToggle = false;
+	m_pList = NULL;
+	m_iCellColMin = m_iCellColMax = m_iCellRowMax = 0;
+	m_iCellCol = m_iCellRow = 0;
+	m_iCellSlot = 0;
 
 	m_pSectorBase = m_pSector = pt.GetSector();
 
@@ -571,13 +575,107 @@ bool CWorldSearch::GetNextSector()
 		if ( m_pSectorBase == m_pSector )
 			continue;	// same as base.
 		m_pObj = NULL;	// start at head of next Sector.
+		m_pList = NULL;
 		return( true );
 	}
 }
 
+bool CWorldSearch::IsInRange( const CObjBase * pObj ) const
+{
+	ADDTOCALLSTACK_INTENSIVE("CWorldSearch::IsInRange");
+	if ( m_fSearchSquare )
+	{
+		if ( m_fAllShow )
+			return( m_pt.GetDistSightBase(pObj->GetTopPoint()) <= m_iDist );
+		return( m_pt.GetDistSight(pObj->GetTopPoint()) <= m_iDist );
+	}
+	if ( m_fAllShow )
+		return( m_pt.GetDistBase(pObj->GetTopPoint()) <= m_iDist );
+	return( m_pt.GetDist(pObj->GetTopPoint()) <= m_iDist );
+}
+
+void CWorldSearch::SetCellList( CSectorObjList * pList )
+{
+	ADDTOCALLSTACK_INTENSIVE("CWorldSearch::SetCellList");
+	m_pList = pList;
+	m_iCellColMin = m_iCellCol = pList->GetCellCol(m_pt.m_x - m_iDist);
+	m_iCellColMax = pList->GetCellCol(m_pt.m_x + m_iDist);
+	m_iCellRow = pList->GetCellRow(m_pt.m_y - m_iDist);
+	m_iCellRowMax = pList->GetCellRow(m_pt.m_y + m_iDist);
+	m_iCellSlot = 0;
+}
+
+CObjBase * CWorldSearch::GetNextCellObj( bool fChars )
+{
+	ADDTOCALLSTACK_INTENSIVE("CWorldSearch::GetNextCellObj");
+	// (SectorGrid) Next object of m_pSector whose point is inside the search box. NULL = sector done.
+	// Only the cells overlapping the box are scanned and their points are tested without touching the objects.
+	if ( m_pList == NULL )
+	{
+		m_fInertToggle = false;
+		if ( fChars )
+			SetCellList(&m_pSector->m_Chars_Active);
+		else
+			SetCellList(&m_pSector->m_Items_Inert);
+	}
+
+	const int iMinX = m_pt.m_x - m_iDist;
+	const int iMinY = m_pt.m_y - m_iDist;
+	const unsigned int iSpan = static_cast<unsigned int>(m_iDist) * 2;
+	for (;;)
+	{
+		const CSectorIndexCell * pCell = m_pList->GetCell(m_iCellCol, m_iCellRow);
+		if ( pCell != NULL )
+		{
+			size_t iQty = pCell->m_Pos.size();
+			while ( m_iCellSlot < iQty )
+			{
+				const CSectorIndexPos & pos = pCell->m_Pos[m_iCellSlot++];
+				if (( static_cast<unsigned int>(pos.m_x - iMinX) > iSpan ) || ( static_cast<unsigned int>(pos.m_y - iMinY) > iSpan ))
+					continue;
+				CObjBaseTemplate * pObj = pCell->m_Obj[m_iCellSlot - 1];
+				if ( pObj != NULL )
+					return static_cast<CObjBase *>(pObj);
+			}
+		}
+
+		m_iCellSlot = 0;
+		if ( ++m_iCellCol <= m_iCellColMax )
+			continue;
+		m_iCellCol = m_iCellColMin;
+		if ( ++m_iCellRow <= m_iCellRowMax )
+			continue;
+
+		// Next list of the sector.
+		if ( m_fInertToggle || ( fChars && !m_fAllShow ))
+			return NULL;
+		m_fInertToggle = true;
+		if ( fChars )
+			SetCellList(&m_pSector->m_Chars_Disconnect);
+		else
+			SetCellList(&m_pSector->m_Items_Timer);
+	}
+}
+
 CItem * CWorldSearch::GetItem()
 {
 	ADDTOCALLSTACK("CWorldSearch::GetItem");
+	if ( g_Cfg.m_fSectorGrid )
+	{
+		for (;;)
+		{
+			m_pObj = GetNextCellObj(false);
+			if ( m_pObj == NULL )
+			{
+				if ( GetNextSector())
+					continue;
+				return NULL;
+			}
+			if ( IsInRange(m_pObj) && !m_pObj->IsDeletePending() )
+				return static_cast<CItem *>(m_pObj);
+		}
+	}
+
 	for (;;)
 	{
 		if ( m_pObj == NULL )
@@ -605,38 +703,30 @@ CItem * CWorldSearch::GetItem()
 
 jumpover:
 		m_pObjNext = m_pObj->GetNext();
-		if ( m_fSearchSquare )
-		{
-			if ( m_fAllShow )
-			{
-				if ( m_pt.GetDistSightBase(m_pObj->GetTopPoint()) <= m_iDist )
-					return static_cast<CItem *>(m_pObj);
-			}
-			else
-			{
-				if ( m_pt.GetDistSight(m_pObj->GetTopPoint()) <= m_iDist )
-					return static_cast<CItem *>(m_pObj);
-			}
-		}
-		else
-		{
-			if ( m_fAllShow )
-			{
-				if ( m_pt.GetDistBase(m_pObj->GetTopPoint()) <= m_iDist )
-					return static_cast<CItem *>(m_pObj);
-			}
-			else
-			{
-				if ( m_pt.GetDist(m_pObj->GetTopPoint()) <= m_iDist )
-					return static_cast<CItem *>(m_pObj);
-			}
-		}
+		if ( IsInRange(m_pObj) && !m_pObj->IsDeletePending() )
+			return static_cast<CItem *>(m_pObj);
 	}
 }
 
 CChar * CWorldSearch::GetChar()
 {
 	ADDTOCALLSTACK("CWorldSearch::GetChar");
+	if ( g_Cfg.m_fSectorGrid )
+	{
+		for (;;)
+		{
+			m_pObj = GetNextCellObj(true);
+			if ( m_pObj == NULL )
+			{
+				if ( GetNextSector())
+					continue;
+				return NULL;
+			}
+			if ( IsInRange(m_pObj) && !m_pObj->IsDeletePending() )
+				return static_cast<CChar *>(m_pObj);
+		}
+	}
+
 	for (;;)
 	{
 		if ( m_pObj == NULL )
@@ -664,32 +754,8 @@ CChar * CWorldSearch::GetChar()
 
 jumpover:
 		m_pObjNext = m_pObj->GetNext();
-		if ( m_fSearchSquare )
-		{
-			if ( m_fAllShow )
-			{
-				if ( m_pt.GetDistSightBase(m_pObj->GetTopPoint()) <= m_iDist )
-					return static_cast<CChar *>(m_pObj);
-			}
-			else
-			{
-				if ( m_pt.GetDistSight(m_pObj->GetTopPoint()) <= m_iDist )
-					return static_cast<CChar *>(m_pObj);
-			}
-		}
-		else
-		{
-			if ( m_fAllShow )
-			{
-				if ( m_pt.GetDistBase(m_pObj->GetTopPoint()) <= m_iDist )
-					return static_cast<CChar *>(m_pObj);
-			}
-			else
-			{
-				if ( m_pt.GetDist(m_pObj->GetTopPoint()) <= m_iDist )
-					return static_cast<CChar *>(m_pObj);
-			}
-		}
+		if ( IsInRange(m_pObj) && !m_pObj->IsDeletePending() )
+			return static_cast<CChar *>(m_pObj);
 	}
 }
 
@@ -699,10 +765,8 @@ jumpover:
 CWorldThread::CWorldThread()
 {
 	m_fSaveParity = false;		// has the sector been saved relative to the char entering it ?
-	m_iUIDIndexLast = 1;
-
-	m_FreeUIDs = (DWORD*)calloc(FREE_UIDS_SIZE, sizeof(DWORD));
-	m_FreeOffset = FREE_UIDS_SIZE;
+	m_UIDFreeHead = 0;
+	m_UIDFreeTail = 0;
 }
 
 CWorldThread::~CWorldThread()
@@ -717,12 +781,10 @@ void CWorldThread::CloseAllUIDs()
 	m_ObjNew.DeleteAll();
 	m_UIDs.RemoveAll();
 
-	if ( m_FreeUIDs != NULL )
-	{
-		free(m_FreeUIDs);
-		m_FreeUIDs = NULL;
-	}
-	m_FreeOffset = FREE_UIDS_SIZE;
+	m_UIDFreeNext.clear();
+	m_UIDGen.clear();
+	m_UIDFreeHead = 0;
+	m_UIDFreeTail = 0;
 }
 
 bool CWorldThread::IsSaving() const
@@ -735,74 +797,126 @@ DWORD CWorldThread::GetUIDCount() const
 	return m_UIDs.GetCount();
 }
 
-CObjBase *CWorldThread::FindUID(DWORD dwIndex) const
+DWORD CWorldThread::GetUIDSlot(DWORD dwIndex) const
+{
+	// With UIDGenerations the top bits of the index hold the generation of the slot.
+	if ( g_Cfg.m_fUIDGenerations )
+		return( dwIndex & UID_GEN_SLOT_MASK );
+	return( dwIndex );
+}
+
+void CWorldThread::PushFreeUID(DWORD dwSlot)
+{
+	// Append to the tail so freed slots age a while before they are reused.
+	if ( !dwSlot || m_UIDFreeNext[dwSlot] != UID_FREE_OUT )
+		return;
+	m_UIDFreeNext[dwSlot] = 0;
+	if ( m_UIDFreeTail )
+		m_UIDFreeNext[m_UIDFreeTail] = dwSlot;
+	else
+		m_UIDFreeHead = dwSlot;
+	m_UIDFreeTail = dwSlot;
+}
+
+void CWorldThread::ResizeUIDs(DWORD dwCount)
+{
+	ADDTOCALLSTACK("CWorldThread::ResizeUIDs");
+	if ( g_Cfg.m_fUIDGenerations && dwCount > UID_GEN_SLOT_MASK + 1 )
+		dwCount = UID_GEN_SLOT_MASK + 1;
+
+	DWORD dwCountPrv = GetUIDCount();
+	if ( dwCount <= dwCountPrv )
+		return;
+
+	m_UIDs.SetCount(dwCount);
+	m_UIDFreeNext.resize(dwCount, UID_FREE_OUT);
+	m_UIDGen.resize(dwCount, 0);
+	for ( DWORD d = dwCountPrv; d < dwCount; d++ )
+		PushFreeUID(d);
+}
+
+CObjBase *CWorldThread::FindUIDSlot(DWORD dwSlot) const
 {
-	if ( !dwIndex || dwIndex >= GetUIDCount() )
+	if ( !dwSlot || dwSlot >= GetUIDCount() )
 		return NULL;
-	if ( m_UIDs[ dwIndex ] == UID_PLACE_HOLDER )	// unusable for now. (background save is going on)
+	if ( m_UIDs[ dwSlot ] == UID_PLACE_HOLDER )	// unusable for now. (background save is going on)
 		return NULL;
-	return m_UIDs[dwIndex];
+	return m_UIDs[dwSlot];
+}
+
+CObjBase *CWorldThread::FindUID(DWORD dwIndex) const
+{
+	CObjBase * pObj = FindUIDSlot(GetUIDSlot(dwIndex));
+	if ( pObj && g_Cfg.m_fUIDGenerations && ( static_cast<DWORD>(pObj->GetUID()) & UID_O_INDEX_MASK ) != dwIndex )
+		return NULL;	// stale uid, the slot has been reused since
+	return pObj;
 }
 
 void CWorldThread::FreeUID(DWORD dwIndex)
 {
+	CSectorTickLock lock;
+	DWORD dwSlot = GetUIDSlot(dwIndex);
+	if ( g_Cfg.m_fUIDGenerations )
+		m_UIDGen[dwSlot] = static_cast<BYTE>(( m_UIDGen[dwSlot] + 1 ) & ( UID_GEN_MASK >> UID_GEN_SHIFT ));
+
 	// Can't free up the UID til after the save !
-	m_UIDs[dwIndex] = ( IsSaving()) ? UID_PLACE_HOLDER : NULL;
+	if ( IsSaving())
+	{
+		m_UIDs[dwSlot] = UID_PLACE_HOLDER;
+		return;
+	}
+	m_UIDs[dwSlot] = NULL;
+	PushFreeUID(dwSlot);
 }
 
 DWORD CWorldThread::AllocUID( DWORD dwIndex, CObjBase * pObj )
 {
 	ADDTOCALLSTACK("CWorldThread::AllocUID");
-	DWORD dwCountTotal = GetUIDCount();
+	CSectorTickLock lock;
+	DWORD dwSlot;
 
-	if ( !dwIndex )					// auto-select tbe suitable hole
+	if ( !dwIndex )					// take the oldest free slot
 	{
-		if ( !dwCountTotal )		// if the uids array is empty - increase it.
-		{
-			dwIndex = 1;
-			goto setcount;
-		}
-
-		if ( m_FreeOffset < FREE_UIDS_SIZE && m_FreeUIDs != NULL )
+		for (;;)
 		{
-			//	We do have a free uid's array. Use it if possible to determine the first free element
-			for ( ; m_FreeOffset < FREE_UIDS_SIZE && m_FreeUIDs[m_FreeOffset] != 0; m_FreeOffset++ )
+			if ( !m_UIDFreeHead )
 			{
-				//	yes, that's a free slot
-				if ( !m_UIDs[m_FreeUIDs[m_FreeOffset]] )
+				// We have run out of free UID's !!! Grow the array
+				ResizeUIDs(( GetUIDCount() + 0x1000 ) &~ 0xFFF );
+				if ( !m_UIDFreeHead )
 				{
-					dwIndex = m_FreeUIDs[m_FreeOffset++];
-					goto successalloc;
+					g_Log.EventError("UID table is full (%lu slots)\n", GetUIDCount());
+					return UID_O_INDEX_MASK;
 				}
 			}
+
+			dwSlot = m_UIDFreeHead;
+			m_UIDFreeHead = m_UIDFreeNext[dwSlot];
+			m_UIDFreeNext[dwSlot] = UID_FREE_OUT;
+			if ( !m_UIDFreeHead )
+				m_UIDFreeTail = 0;
+
+			if ( m_UIDs[dwSlot] == NULL )
+				break;
+			// taken by an explicit index since it was freed
 		}
-		m_FreeOffset = FREE_UIDS_SIZE;	// mark array invalid, since it does not contain any empty slots
-										// use default allocation for a while, till the next garbage collection
-		DWORD dwCount = dwCountTotal - 1;
-		dwIndex = m_iUIDIndexLast;
-		while ( m_UIDs[dwIndex] != NULL )
-		{
-			if ( ! -- dwIndex )
-			{
-				dwIndex = dwCountTotal - 1;
-			}
-			if ( ! -- dwCount )
-			{
-				dwIndex = dwCountTotal;
-				goto setcount;
-			}
-		}
+
+		dwIndex = dwSlot;
+		if ( g_Cfg.m_fUIDGenerations )
+			dwIndex |= static_cast<DWORD>(m_UIDGen[dwSlot]) << UID_GEN_SHIFT;
 	}
-	else if ( dwIndex >= dwCountTotal )
+	else
 	{
-setcount:
-		// We have run out of free UID's !!! Grow the array
-		m_UIDs.SetCount(( dwIndex + 0x1000 ) &~ 0xFFF );
+		dwSlot = GetUIDSlot(dwIndex);
+		if ( dwSlot >= GetUIDCount() )
+			ResizeUIDs(( dwSlot + 0x1000 ) &~ 0xFFF );
+		if ( g_Cfg.m_fUIDGenerations )
+			m_UIDGen[dwSlot] = static_cast<BYTE>(( dwIndex & UID_GEN_MASK ) >> UID_GEN_SHIFT);
 	}
 
-successalloc:
-	m_iUIDIndexLast = dwIndex; // start from here next time so we have even distribution of allocation.
-	CObjBase	*pObjPrv = m_UIDs[dwIndex];
+	CObjBase	*pObjPrv = m_UIDs[dwSlot];
+	if ( pObjPrv == UID_PLACE_HOLDER )
+		pObjPrv = NULL;
 	if ( pObjPrv )
 	{
 		//NOTE: We cannot use Delete() in here because the UID will
@@ -810,17 +924,20 @@ successalloc:
 		DEBUG_ERR(("UID conflict delete 0%lx, '%s'\n", dwIndex, pObjPrv->GetName()));
 		delete pObjPrv;
 	}
-	m_UIDs[dwIndex] = pObj;
+	m_UIDs[dwSlot] = pObj;
 	return dwIndex;
 }
 
 void CWorldThread::SaveThreadClose()
 {
 	ADDTOCALLSTACK("CWorldThread::SaveThreadClose");
-	for ( size_t i = 1; i < GetUIDCount(); i++ )
+	for ( DWORD i = 1; i < GetUIDCount(); i++ )
 	{
 		if ( m_UIDs[i] == UID_PLACE_HOLDER )
+		{
 			m_UIDs[i] = NULL;
+			PushFreeUID(i);
+		}
 	}
 
 	m_FileData.Close();
@@ -838,7 +955,7 @@ int CWorldThread::FixObjTry( CObjBase * pObj, DWORD dwUID )
 
 	if ( dwUID != 0 )
 	{
-		if (( pObj->GetUID() & UID_O_INDEX_MASK ) != dwUID )
+		if ( GetUIDSlot( pObj->GetUID() & UID_O_INDEX_MASK ) != dwUID )
 		{
 			// Miss linked in the UID table !!! BAD
 			// Hopefully it was just not linked at all. else How the hell should i clean this up ???
@@ -1004,26 +1121,6 @@ void CWorldThread::GarbageCollection_UIDs()
 	{
 		g_Log.Event(LOGL_EVENT, "GC: %" FMTSIZE_T " objects accounted for\n", iCount);
 	}
-
-	if ( m_FreeUIDs != NULL )	// new UID engine - search for empty holes and store it in a huge array
-	{							// the size of the array should be enough even for huge shards
-								// to survive till next garbage collection
-		memset(m_FreeUIDs, 0, FREE_UIDS_SIZE * sizeof(DWORD));
-		m_FreeOffset = 0;
-
-		for ( DWORD d = 1; d < GetUIDCount(); d++ )
-		{
-			CObjBase	*pObj = m_UIDs[d];
-
-			if ( !pObj )
-			{
-				if ( m_FreeOffset >= ( FREE_UIDS_SIZE - 1 ))
-					break;
-
-				m_FreeUIDs[m_FreeOffset++] = d;
-			}
-		}
-	}
 }
 
 //////////////////////////////////////////////////////////////////
@@ -1093,12 +1190,205 @@ bool CWorldClock::Advance()
 	return true;
 }
 
+//////////////////////////////////////////////////////////////////
+// -CTimerWheel
+
+#define TIMERWHEEL_CATCHUP	(TIMERWHEEL_ROOT_SIZE << TIMERWHEEL_LEVEL_BITS)	// further clock jumps reschedule everything.
+
+CTimerWheel::CTimerWheel()
+{
+	m_lTime = 0;
+	m_fInit = false;
+	memset(m_pRoot, 0, sizeof(m_pRoot));
+	memset(m_pLevel, 0, sizeof(m_pLevel));
+}
+
+void CTimerWheel::Link( CItem ** ppHead, CItem * pItem ) // static
+{
+	ASSERT(ppHead);
+	ASSERT(pItem);
+	ASSERT(pItem->m_ppTimerPrev == NULL);
+
+	pItem->m_pTimerNext = *ppHead;
+	if ( pItem->m_pTimerNext )
+		pItem->m_pTimerNext->m_ppTimerPrev = &pItem->m_pTimerNext;
+	pItem->m_ppTimerPrev = ppHead;
+	*ppHead = pItem;
+}
+
+void CTimerWheel::Unlink( CItem * pItem ) // static
+{
+	// Remove the item from whatever bucket or due list it is in.
+	ASSERT(pItem);
+	if ( pItem->m_ppTimerPrev == NULL )
+		return;
+
+	CSectorTickLock lock;
+
+	*pItem->m_ppTimerPrev = pItem->m_pTimerNext;
+	if ( pItem->m_pTimerNext )
+		pItem->m_pTimerNext->m_ppTimerPrev = pItem->m_ppTimerPrev;
+	pItem->m_pTimerNext = NULL;
+	pItem->m_ppTimerPrev = NULL;
+}
+
+UINT64 CTimerWheel::GetExpire( const CItem * pItem ) // static
+{
+	INT64 iTime = static_cast<INT64>(CServTime::GetCurrentTime().GetTimeRaw()) + pItem->GetTimerDiff();
+	return ( iTime > 0 ) ? static_cast<UINT64>(iTime) : 0;
+}
+
+CItem ** CTimerWheel::GetBucket( UINT64 lExpire )
+{
+	if ( lExpire < m_lTime )
+		lExpire = m_lTime;	// already expired, dispatch on the next tick.
+
+	UINT64 lDelta = lExpire - m_lTime;
+	if ( lDelta < TIMERWHEEL_ROOT_SIZE )
+		return &m_pRoot[lExpire & (TIMERWHEEL_ROOT_SIZE - 1)];
+
+	int iLevel = 0;
+	for ( ; iLevel < TIMERWHEEL_LEVELS - 1; iLevel++ )
+	{
+		if ( lDelta < (static_cast<UINT64>(1) << (TIMERWHEEL_ROOT_BITS + (iLevel + 1) * TIMERWHEEL_LEVEL_BITS)) )
+			break;
+	}
+
+	UINT64 lSpan = static_cast<UINT64>(1) << (TIMERWHEEL_ROOT_BITS + TIMERWHEEL_LEVELS * TIMERWHEEL_LEVEL_BITS);
+	if ( lDelta >= lSpan )
+		lExpire = m_lTime + lSpan - 1;	// park it in the furthest bucket, it gets rescheduled from there.
+
+	return &m_pLevel[iLevel][(lExpire >> (TIMERWHEEL_ROOT_BITS + iLevel * TIMERWHEEL_LEVEL_BITS)) & (TIMERWHEEL_LEVEL_SIZE - 1)];
+}
+
+size_t CTimerWheel::Cascade( int iLevel )
+{
+	ADDTOCALLSTACK("CTimerWheel::Cascade");
+	// Move the items of the current upper bucket down to the finer wheels.
+	size_t index = static_cast<size_t>(m_lTime >> (TIMERWHEEL_ROOT_BITS + iLevel * TIMERWHEEL_LEVEL_BITS)) & (TIMERWHEEL_LEVEL_SIZE - 1);
+
+	CItem * pItem;
+	while ( (pItem = m_pLevel[iLevel][index]) != NULL )
+	{
+		Unlink(pItem);
+		Link(GetBucket(GetExpire(pItem)), pItem);
+	}
+	return index;
+}
+
+void CTimerWheel::Rebase( UINT64 lTime )
+{
+	ADDTOCALLSTACK("CTimerWheel::Rebase");
+	// The clock has been reset or jumped too far. Reschedule everything from the new time.
+	CItem * pList = NULL;
+	CItem * pItem;
+
+	for ( size_t i = 0; i < TIMERWHEEL_ROOT_SIZE; i++ )
+	{
+		while ( (pItem = m_pRoot[i]) != NULL )
+		{
+			Unlink(pItem);
+			Link(&pList, pItem);
+		}
+	}
+	for ( int iLevel = 0; iLevel < TIMERWHEEL_LEVELS; iLevel++ )
+	{
+		for ( size_t i = 0; i < TIMERWHEEL_LEVEL_SIZE; i++ )
+		{
+			while ( (pItem = m_pLevel[iLevel][i]) != NULL )
+			{
+				Unlink(pItem);
+				Link(&pList, pItem);
+			}
+		}
+	}
+
+	m_lTime = lTime;
+	m_fInit = true;
+
+	while ( (pItem = pList) != NULL )
+	{
+		Unlink(pItem);
+		Link(GetBucket(GetExpire(pItem)), pItem);
+	}
+}
+
+void CTimerWheel::Schedule( CItem * pItem )
+{
+	ADDTOCALLSTACK("CTimerWheel::Schedule");
+	// (Re)register the timer of an item in CSector::m_Items_Timer.
+	ASSERT(pItem);
+	CSectorTickLock lock;
+	Unlink(pItem);
+	if ( !pItem->IsTimerSet() )
+		return;
+
+	if ( !m_fInit )
+	{
+		m_lTime = CServTime::GetCurrentTime().GetTimeRaw();
+		m_fInit = true;
+	}
+	Link(GetBucket(GetExpire(pItem)), pItem);
+}
+
+void CTimerWheel::Dispatch( CItem * pItem )
+{
+	ADDTOCALLSTACK("CTimerWheel::Dispatch");
+	if ( !pItem->IsTimerSet() )
+		return;
+	if ( !pItem->IsTimerExpired() )
+	{
+		// parked in a far bucket.
+		Link(GetBucket(GetExpire(pItem)), pItem);
+		return;
+	}
+
+	// Let the sector tick it, so sleeping sectors still wait for their pulse.
+	CSector * pSector = pItem->GetTopSector();
+	if ( pSector )
+		Link(&pSector->m_pItemsDue, pItem);
+}
+
+void CTimerWheel::OnTick( CServTime timeCurrent )
+{
+	ADDTOCALLSTACK("CTimerWheel::OnTick");
+	// Hand every timer expired up to timeCurrent over to its sector.
+	UINT64 lTime = timeCurrent.GetTimeRaw();
+	if ( !m_fInit || (lTime < m_lTime) || (lTime - m_lTime > TIMERWHEEL_CATCHUP) )
+		Rebase(lTime);
+
+	CItem * pItem;
+	while ( m_lTime <= lTime )
+	{
+		size_t index = static_cast<size_t>(m_lTime) & (TIMERWHEEL_ROOT_SIZE - 1);
+		if ( index == 0 )
+		{
+			for ( int iLevel = 0; iLevel < TIMERWHEEL_LEVELS; iLevel++ )
+			{
+				if ( Cascade(iLevel) != 0 )
+					break;
+			}
+		}
+
+		while ( (pItem = m_pRoot[index]) != NULL )
+		{
+			Unlink(pItem);
+			Dispatch(pItem);
+		}
+		m_lTime++;
+	}
+}
+
 //////////////////////////////////////////////////////////////////
 // -CWorld
 
 CWorld::CWorld()
 {
 	m_savetimer = 0;
+#ifndef _WIN32
+	m_iSaveForkPid = 0;
+	m_iSaveForkPipe = -1;
+#endif
 	m_iSaveCountID = 0;
 	m_iSaveStage = 0;
 	m_iPrevBuild = 0;
@@ -1188,7 +1478,7 @@ CWorld::~CWorld()
 ///////////////////////////////////////////////
 // Loading and Saving.
 
-void CWorld::GetBackupName( CGString & sArchive, LPCTSTR pszBaseDir, TCHAR chType, int iSaveCount ) // static
+void CWorld::GetBackupName( CGString & sArchive, LPCTSTR pszBaseDir, TCHAR chType, int iSaveCount, LPCTSTR pszExt ) // static
 {
 	ADDTOCALLSTACK("CWorld::GetBackupName");
 	int iCount = iSaveCount;
@@ -1199,7 +1489,7 @@ void CWorld::GetBackupName( CGString & sArchive, LPCTSTR pszBaseDir, TCHAR chTyp
 			break;
 		iCount >>= 3;
 	}
-	sArchive.Format("%s" SPHERE_FILE "b%d%d%c%s", pszBaseDir, iGroup, iCount & 0x07, chType, SPHERE_SCRIPT);
+	sArchive.Format("%s" SPHERE_FILE "b%d%d%c%s", pszBaseDir, iGroup, iCount & 0x07, chType, pszExt);
 }
 
 bool CWorld::OpenScriptBackup( CScript & s, LPCTSTR pszBaseDir, LPCTSTR pszBaseName, int iSaveCount ) // static
@@ -1207,15 +1497,18 @@ bool CWorld::OpenScriptBackup( CScript & s, LPCTSTR pszBaseDir, LPCTSTR pszBaseN
 	ADDTOCALLSTACK("CWorld::OpenScriptBackup");
 	ASSERT(pszBaseName);
 
+	// binary saves keep their own files and backups. (SaveBinary)
+	LPCTSTR pszExt = s.IsBinaryMode() ? SPHERE_SCRIPT_BIN : SPHERE_SCRIPT;
+
 	CGString sArchive;
-	GetBackupName( sArchive, pszBaseDir, pszBaseName[0], iSaveCount );
+	GetBackupName( sArchive, pszBaseDir, pszBaseName[0], iSaveCount, pszExt );
 
 	// remove possible previous archive of same name
 	remove( sArchive );
 
 	// rename previous save to archive name.
 	CGString sSaveName;
-	sSaveName.Format("%s" SPHERE_FILE "%s%s", pszBaseDir, pszBaseName, SPHERE_SCRIPT);
+	sSaveName.Format("%s" SPHERE_FILE "%s%s", pszBaseDir, pszBaseName, pszExt);
 
 	rename(sSaveName, sArchive);
 	//if ( rename(sSaveName, sArchive) )	// may not exist if this is the first time
@@ -1249,14 +1542,20 @@ bool CWorld::SaveStage() // Save world state in stages.
 	{
 		// NPC Chars in the world secors and the stuff they are carrying.
 		// Sector lighting info.
-		if(IsSetEF(EF_Dynamic_Backsave))
+		if ( m_SectorSaver.CanSave() )
+		{
+			// all the sectors at once, on the SaveThreads.
+			m_SectorSaver.Save(m_iSaveStage, m_SectorsQty);
+			m_iSaveStage = static_cast<int>(m_SectorsQty) - 1;
+		}
+		else if(IsSetEF(EF_Dynamic_Backsave))
 		{
 			unsigned int szComplexity = 0;
 
 			CSector *s = m_Sectors[m_iSaveStage];
 			if( s )
 			{
-				s->r_Write();
+				SaveSector(s);
 				szComplexity += ( s->GetCharComplexity() + s->GetInactiveChars())*100 + s->GetItemComplexity();
 			}
 			unsigned int dynStage = m_iSaveStage+1;
@@ -1272,7 +1571,7 @@ bool CWorld::SaveStage() // Save world state in stages.
 
 						if(szComplexity <= g_Cfg.m_iSaveStepMaxComplexity)
 						{
-							s->r_Write();
+							SaveSector(s);
 							m_iSaveStage = dynStage;
 							szSectorCnt++;
 						}
@@ -1288,36 +1587,12 @@ bool CWorld::SaveStage() // Save world state in stages.
 		else
 		{
 			if ( m_Sectors[m_iSaveStage] )
-				m_Sectors[m_iSaveStage]->r_Write();
+				SaveSector(m_Sectors[m_iSaveStage]);
 		}
 	}
 	else if ( m_iSaveStage == static_cast<int>(m_SectorsQty) )
 	{
-		m_FileData.WriteSection( "TIMERF" );
-		g_World.m_TimedFunctions.r_Write(m_FileData);
-
-		m_FileData.WriteSection("GLOBALS");
-		g_Exp.m_VarGlobals.r_WritePrefix(m_FileData, NULL);
-
-		g_Exp.m_ListGlobals.r_WriteSave(m_FileData);
-
-		size_t iQty = g_Cfg.m_RegionDefs.GetCount();
-		for ( size_t i = 0; i < iQty; i++ )
-		{
-			CRegionBase *pRegion = dynamic_cast <CRegionBase*> (g_Cfg.m_RegionDefs.GetAt(i));
-			if ( !pRegion || !pRegion->HasResourceName() || !pRegion->m_iModified )
-				continue;
-
-			m_FileData.WriteSection("WORLDSCRIPT %s", pRegion->GetResourceName());
-			pRegion->r_WriteModified(m_FileData);
-		}
-
-		// GM_Pages.
-		CGMPage *pPage = static_cast<CGMPage *>(m_GMPages.GetHead());
-		for ( ; pPage != NULL; pPage = pPage->GetNext())
-		{
-			pPage->r_Write(m_FileData);
-		}
+		SaveGlobals();
 	}
 	else if ( m_iSaveStage == static_cast<int>(m_SectorsQty)+1 )
 	{
@@ -1382,6 +1657,237 @@ bool CWorld::SaveStage() // Save world state in stages.
 	return false;
 }
 
+void CWorld::SaveSector( CSector * pSector )
+{
+	ADDTOCALLSTACK("CWorld::SaveSector");
+	pSector->r_Write();
+
+	// binary saves keep each sector in its own block.
+	m_FileWorld.FlushBlock();
+	m_FilePlayers.FlushBlock();
+	m_FileMultis.FlushBlock();
+}
+
+void CWorld::SaveGlobals()
+{
+	ADDTOCALLSTACK("CWorld::SaveGlobals");
+	m_FileData.WriteSection( "TIMERF" );
+	g_World.m_TimedFunctions.r_Write(m_FileData);
+
+	m_FileData.WriteSection("GLOBALS");
+	g_Exp.m_VarGlobals.r_WritePrefix(m_FileData, NULL);
+
+	g_Exp.m_ListGlobals.r_WriteSave(m_FileData);
+
+	size_t iQty = g_Cfg.m_RegionDefs.GetCount();
+	for ( size_t i = 0; i < iQty; i++ )
+	{
+		CRegionBase *pRegion = dynamic_cast <CRegionBase*> (g_Cfg.m_RegionDefs.GetAt(i));
+		if ( !pRegion || !pRegion->HasResourceName() || !pRegion->m_iModified )
+			continue;
+
+		m_FileData.WriteSection("WORLDSCRIPT %s", pRegion->GetResourceName());
+		pRegion->r_WriteModified(m_FileData);
+	}
+
+	// GM_Pages.
+	CGMPage *pPage = static_cast<CGMPage *>(m_GMPages.GetHead());
+	for ( ; pPage != NULL; pPage = pPage->GetNext())
+	{
+		pPage->r_Write(m_FileData);
+	}
+}
+
+#ifndef _WIN32
+// pthread_atfork handlers: only the forking thread lives on in the child, so the locks the
+// child needs are taken before fork() and released on both sides.
+static void ForkPrepare()
+{
+	g_Log.OnForkPrepare();
+	CVarDefKeys::LockFork(true);
+	CScriptBinary::LockFork(true);
+	fflush(stdout);
+}
+
+static void ForkParent()
+{
+	CScriptBinary::LockFork(false);
+	CVarDefKeys::LockFork(false);
+	g_Log.OnForkParent();
+}
+
+static void ForkChild()
+{
+	CScriptBinary::LockFork(false);
+	CVarDefKeys::LockFork(false);
+	g_Log.OnForkChild();
+}
+
+bool CWorld::SaveFork()
+{
+	ADDTOCALLSTACK("CWorld::SaveFork");
+	// Write the save from a forked copy of the world, we only pause for the fork. (SaveFork)
+	// RETURN: true = the child process is writing the save.
+	if ( g_Cfg.m_fSaveGarbageCollect )
+		GarbageCollection();
+	else
+		GarbageCollection_New();
+
+	// The child can't hand account changes back, merge them here.
+	g_Accounts.Account_LoadAll(true);
+	g_Accounts.Account_LoadAll(true, true);
+
+	int iPipe[2];
+	if ( pipe(iPipe) != 0 )
+	{
+		g_Log.Event(LOGM_SAVE|LOGL_ERROR, "Save fork FAILED, can't create pipe (code %d)\n", errno);
+		return false;
+	}
+
+	ULONGLONG llTicksStart;
+	TIME_PROFILE_START;
+	m_savetimer = llTicksStart;
+
+	static bool fForkHandlers = false;
+	if ( !fForkHandlers )
+	{
+		pthread_atfork(ForkPrepare, ForkParent, ForkChild);
+		fForkHandlers = true;
+	}
+
+	pid_t pid = fork();
+	if ( pid < 0 )
+	{
+		close(iPipe[0]);
+		close(iPipe[1]);
+		g_Log.Event(LOGM_SAVE|LOGL_ERROR, "Save fork FAILED (code %d)\n", errno);
+		return false;
+	}
+
+	if ( pid == 0 )
+	{
+		close(iPipe[0]);
+
+		char chResult = SaveForkChild() ? 1 : 0;
+		while ( write(iPipe[1], &chResult, 1) < 0 && errno == EINTR )
+			;
+		_exit(0);
+	}
+
+	close(iPipe[1]);
+	fcntl(iPipe[0], F_SETFL, O_NONBLOCK);
+	m_iSaveForkPid = pid;
+	m_iSaveForkPipe = iPipe[0];
+	return true;
+}
+
+bool CWorld::SaveForkChild()
+{
+	ADDTOCALLSTACK("CWorld::SaveForkChild");
+	// Runs in the forked process: write the whole save at once, no triggers.
+	try
+	{
+		m_FileData.SetBinary(g_Cfg.m_fSaveBinary);
+		m_FileWorld.SetBinary(g_Cfg.m_fSaveBinary);
+		m_FilePlayers.SetBinary(g_Cfg.m_fSaveBinary);
+		m_FileMultis.SetBinary(g_Cfg.m_fSaveBinary);
+
+		if ( !OpenScriptBackup(m_FileData, g_Cfg.m_sWorldBaseDir, "data", m_iSaveCountID) )
+			return false;
+		if ( !OpenScriptBackup(m_FileWorld, g_Cfg.m_sWorldBaseDir, "world", m_iSaveCountID) )
+			return false;
+		if ( !OpenScriptBackup(m_FilePlayers, g_Cfg.m_sWorldBaseDir, "chars", m_iSaveCountID) )
+			return false;
+		if ( !OpenScriptBackup(m_FileMultis, g_Cfg.m_sWorldBaseDir, "multis", m_iSaveCountID) )
+			return false;
+
+		// The parity only flips in here, the parent still sees everything as saved by the last save.
+		m_fSaveParity = ! m_fSaveParity;
+
+		r_Write(m_FileData);
+		r_Write(m_FileWorld);
+		r_Write(m_FilePlayers);
+		r_Write(m_FileMultis);
+
+		for ( unsigned int i = 0; i < m_SectorsQty; i++ )
+		{
+			if ( m_Sectors[i] )
+				SaveSector(m_Sectors[i]);
+		}
+
+		SaveGlobals();
+		bool fAccounts = g_Accounts.Account_SaveAll(false);
+
+		m_FileData.WriteSection("EOF");
+		m_FileWorld.WriteSection("EOF");
+		m_FilePlayers.WriteSection("EOF");
+		m_FileMultis.WriteSection("EOF");
+
+		m_FileData.Close();
+		m_FileWorld.Close();
+		m_FilePlayers.Close();
+		m_FileMultis.Close();
+		return fAccounts;
+	}
+	catch ( const CGrayError& e )
+	{
+		g_Log.CatchEvent(&e, "Forked save FAILED");
+	}
+	catch (...)
+	{
+		g_Log.CatchEvent(NULL, "Forked save FAILED");
+	}
+	return false;
+}
+
+void CWorld::SaveForkCheck( bool fWait )
+{
+	ADDTOCALLSTACK("CWorld::SaveForkCheck");
+	// Collect the result of the forked save, if it is done. fWait = block until it is.
+	if ( m_iSaveForkPid <= 0 )
+		return;
+
+	if ( fWait )
+		fcntl(m_iSaveForkPipe, F_SETFL, 0);
+
+	char chResult = 0;
+	ssize_t iRead;
+	do
+	{
+		iRead = read(m_iSaveForkPipe, &chResult, 1);
+	} while ( iRead < 0 && errno == EINTR );
+
+	if ( iRead < 0 && errno == EAGAIN )
+		return;	// still writing.
+
+	// the child wrote its result or died (EOF).
+	close(m_iSaveForkPipe);
+	waitpid(m_iSaveForkPid, NULL, 0);
+	m_iSaveForkPipe = -1;
+	m_iSaveForkPid = 0;
+
+	if (( iRead != 1 ) || ( chResult == 0 ))
+	{
+		g_Log.Event(LOGM_SAVE|LOGL_CRIT, "Forked world save FAILED\n");
+		return;
+	}
+
+	m_iSaveCountID++;	// Save only counts if we get to the end winout trapping.
+
+	ULONGLONG llTicksStart = m_savetimer, llTicksEnd;
+	TIME_PROFILE_END;
+
+	TCHAR * time = Str_GetTemp();
+	sprintf(time, "%lld.%04lld", static_cast<INT64>(TIME_PROFILE_GET_HI/1000), static_cast<INT64>(TIME_PROFILE_GET_LO));
+
+	g_Log.Event(LOGM_SAVE, "World save completed, took %s seconds\n", time);
+
+	CScriptTriggerArgs Args;
+	Args.Init(time);
+	g_Serv.r_Call("f_onserver_save_finished", &g_Serv, &Args);
+}
+#endif
+
 bool CWorld::SaveForce() // Save world state
 {
 	ADDTOCALLSTACK("CWorld::SaveForce");
@@ -1457,6 +1963,15 @@ bool CWorld::SaveTry( bool fForceImmediate ) // Save world state
 {
 	ADDTOCALLSTACK("CWorld::SaveTry");
 	EXC_TRY("SaveTry");
+#ifndef _WIN32
+	if ( m_iSaveForkPid > 0 )
+	{
+		// A forked save is still writing.
+		if ( !fForceImmediate )
+			return false;
+		SaveForkCheck(true);
+	}
+#endif
 	if ( m_FileWorld.IsFileOpen())
 	{
 		// Save is already active !
@@ -1472,6 +1987,14 @@ bool CWorld::SaveTry( bool fForceImmediate ) // Save world state
 		return false;
 	}
 
+#ifndef _WIN32
+	if ( g_Cfg.m_fSaveFork && !fForceImmediate )
+	{
+		m_bSaveNotificationSent = false;
+		return SaveFork();
+	}
+#endif
+
 	// Do the write async from here in the future.
 	if ( g_Cfg.m_fSaveGarbageCollect )
 	{
@@ -1482,6 +2005,11 @@ bool CWorld::SaveTry( bool fForceImmediate ) // Save world state
 	TIME_PROFILE_START;
 	m_savetimer = llTicksStart;
 
+	m_FileData.SetBinary(g_Cfg.m_fSaveBinary);
+	m_FileWorld.SetBinary(g_Cfg.m_fSaveBinary);
+	m_FilePlayers.SetBinary(g_Cfg.m_fSaveBinary);
+	m_FileMultis.SetBinary(g_Cfg.m_fSaveBinary);
+
 	// Determine the save name based on the time.
 	// exponentially degrade the saves over time.
 	if ( !OpenScriptBackup(m_FileData, g_Cfg.m_sWorldBaseDir, "data", m_iSaveCountID) )
@@ -1660,12 +2188,33 @@ void CWorld::SaveStatics()
 
 /////////////////////////////////////////////////////////////////////
 
+static time_t GetFileModifiedTime( LPCTSTR pszName )
+{
+	struct stat fileStat;
+	if ( stat(pszName, &fileStat) != 0 )
+		return 0;
+	return fileStat.st_mtime;
+}
+
 bool CWorld::LoadFile(LPCTSTR pszLoadName)	// Load world from script
 {
-	g_Log.Event(LOGM_INIT, "Loading %s%s\n", static_cast<LPCTSTR>(pszLoadName), SPHERE_SCRIPT);
+	// Load the text or the binary file, whichever has been saved last. (SaveBinary)
+	CGString sName(pszLoadName);
+	size_t iExtLen = strlen(SPHERE_SCRIPT);
+	if ( static_cast<size_t>(sName.GetLength()) > iExtLen && !strcmpi(sName.GetPtr() + sName.GetLength() - iExtLen, SPHERE_SCRIPT) )
+		sName.SetLength(sName.GetLength() - static_cast<int>(iExtLen));
 
-	CScript s;
-	if ( !s.Open(pszLoadName, OF_READ|OF_TEXT|OF_DEFAULTMODE) )
+	CGString sTextName, sBinaryName;
+	sTextName.Format("%s" SPHERE_SCRIPT, static_cast<LPCTSTR>(sName));
+	sBinaryName.Format("%s" SPHERE_SCRIPT_BIN, static_cast<LPCTSTR>(sName));
+	bool fBinary = ( GetFileModifiedTime(sBinaryName) > GetFileModifiedTime(sTextName) );
+	sName = fBinary ? sBinaryName : sTextName;
+
+	g_Log.Event(LOGM_INIT, "Loading %s\n", static_cast<LPCTSTR>(sName));
+
+	CScriptBinary s;
+	s.SetBinary(fBinary);
+	if ( !s.Open(sName, OF_READ|OF_TEXT|OF_DEFAULTMODE) )
 		return false;
 
 	// Find the size of the file.
@@ -1766,7 +2315,7 @@ void CWorld::LoadWorld() // Load world from script
 
 		CloseAllUIDs();
 		m_Clock.Init();
-		m_UIDs.SetCount(8 * 1024);
+		ResizeUIDs(8 * 1024);
 
 		// Get the name of the previous backups.
 		CGString sArchive;
@@ -1806,7 +2355,7 @@ void CWorld::LoadWorld() // Load world from script
 void CWorld::LoadAll() // Load world from script
 {
 	// start count. (will grow as needed)
-	m_UIDs.SetCount(8 * 1024);
+	ResizeUIDs(8 * 1024);
 	m_Clock.Init();		// will be loaded from the world file.
 
 	// Load all the accounts.
@@ -2129,6 +2678,9 @@ void CWorld::ResyncMultiRegions()
 void CWorld::Close()
 {
 	ADDTOCALLSTACK("CWorld::Close");
+#ifndef _WIN32
+	SaveForkCheck(true);
+#endif
 	if ( IsSaving() )
 		Save(true);
 
@@ -2182,6 +2734,22 @@ void CWorld::GarbageCollection()
 	g_Log.Flush();
 }
 
+static int GetHearDist( TALKMODE_TYPE mode )
+{
+	// Max distance a speech of this mode is heard from. -1 = everywhere (see CChar::CanHear)
+	switch ( mode )
+	{
+		case TALKMODE_BROADCAST:
+			return -1;
+		case TALKMODE_YELL:
+			return g_Cfg.m_iDistanceYell;
+		case TALKMODE_WHISPER:
+			return g_Cfg.m_iDistanceWhisper;
+		default:
+			return UO_MAP_VIEW_RADAR;
+	}
+}
+
 void CWorld::Speak( const CObjBaseTemplate * pSrc, LPCTSTR pszText, HUE_TYPE wHue, TALKMODE_TYPE mode, FONT_TYPE font )
 {
 	ADDTOCALLSTACK("CWorld::Speak");
@@ -2212,7 +2780,7 @@ void CWorld::Speak( const CObjBaseTemplate * pSrc, LPCTSTR pszText, HUE_TYPE wHu
 	bool fCanSee = false;
 	CChar * pChar = NULL;
 
-	ClientIterator it;
+	ClientAreaIterator it(pSrc, GetHearDist(mode), NULL, pSrc && pSrc->IsChar());
 	for (CClient* pClient = it.next(); pClient != NULL; pClient = it.next(), fCanSee = false, pChar = NULL)
 	{
 		if ( ! pClient->CanHear( pSrc, mode ))
@@ -2301,7 +2869,7 @@ void CWorld::SpeakUNICODE( const CObjBaseTemplate * pSrc, const NCHAR * pwText,
 	bool fCanSee = false;
 	CChar * pChar = NULL;
 
-	ClientIterator it;
+	ClientAreaIterator it(pSrc, GetHearDist(mode), NULL, pSrc && pSrc->IsChar());
 	for (CClient* pClient = it.next(); pClient != NULL; pClient = it.next(), fCanSee = false, pChar = NULL)
 	{
 		if ( ! pClient->CanHear( pSrc, mode ))
@@ -2478,21 +3046,30 @@ void CWorld::OnTick()
 		m_Sector_Pulse ++;
 		int	m, s;
 
-		for ( m = 0; m < 256; m++ )
-		{
-			if ( !g_MapList.m_maps[m] ) continue;
+		EXC_TRYSUB("Tick");
+		m_TimerWheel.OnTick( GetCurrentTime());	// hand expired item timers to their sectors.
+		EXC_CATCHSUB("TimerWheel");
 
-			for ( s = 0; s < g_MapList.GetSectorQty(m); s++ )
+		if ( m_SectorTicker.IsActive() )
+			m_SectorTicker.OnTick( m_Sector_Pulse );
+		else
+		{
+			for ( m = 0; m < 256; m++ )
 			{
-				EXC_TRYSUB("Tick");
+				if ( !g_MapList.m_maps[m] ) continue;
 
-				CSector	*pSector = GetSector(m, s);
-				if ( !pSector )
-					g_Log.EventError("Ticking NULL sector %d on map %d\n", s, m);
-				else
-					pSector->OnTick( m_Sector_Pulse );
+				for ( s = 0; s < g_MapList.GetSectorQty(m); s++ )
+				{
+					EXC_TRYSUB("Tick");
+
+					CSector	*pSector = GetSector(m, s);
+					if ( !pSector )
+						g_Log.EventError("Ticking NULL sector %d on map %d\n", s, m);
+					else
+						pSector->OnTick( m_Sector_Pulse );
 
-				EXC_CATCHSUB("Sector");
+					EXC_CATCHSUB("Sector");
+				}
 			}
 		}
 
@@ -2527,6 +3104,9 @@ void CWorld::OnTick()
 	m_TimedFunctions.OnTick();
 	EXC_CATCHSUB("TimerFunction");
 
+#ifndef _WIN32
+	SaveForkCheck(false);
+#endif
 	if ( !m_bSaveNotificationSent && (m_timeSave - (10 * TICK_PER_SEC) <= GetCurrentTime()) )
 	{
 		Broadcast( g_Cfg.GetDefaultMsg( DEFMSG_SERVER_WORLDSAVE_NOTIFY ) );
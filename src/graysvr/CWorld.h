@@ -26,6 +26,9 @@ private:
 	BYTE m_ColdChance;		// Will be snow if rain chance success.
 	BYTE m_ListenItems;		// Items on the ground that listen ?
 
+public:
+	CItem * m_pItemsDue;	// Items in m_Items_Timer whose timer has expired. (filled by CTimerWheel)
+
 private:
 	WEATHER_TYPE GetWeatherCalc() const;
 	BYTE GetLightCalc( bool fQuickSet ) const;
@@ -119,7 +122,7 @@ public:
 		return pItem->GetParent() == &m_Items_Inert ||
 			   pItem->GetParent() == &m_Items_Timer;
 	}
-	void MoveItemToSector( CItem * pItem, bool fActive );
+	void MoveItemToSector( CItem * pItem, bool fActive, bool fNotAMove = false );
 
 	void AddListenItem()
 	{
@@ -168,13 +171,13 @@ public:
 	{
 		if ( ! IsCharActiveIn( pChar ))
 			return;
-		m_Chars_Active.ClientAttach();
+		m_Chars_Active.ClientAttach( pChar );
 	}
 	void ClientDetach( CChar * pChar )
 	{
 		if ( ! IsCharActiveIn( pChar ))
 			return;
-		m_Chars_Active.ClientDetach();
+		m_Chars_Active.ClientDetach( pChar );
 	}
 	bool MoveCharToSector( CChar * pChar );
 	bool MoveDisconnectedCharToSector(CChar * pChar);
@@ -186,6 +189,7 @@ public:
 	virtual bool r_LoadVal( CScript & s );
 	virtual bool r_WriteVal( LPCTSTR pszKey, CGString & sVal, CTextConsole * pSrc );
 	virtual void r_Write();
+	void r_Write( CScript & sWorld, CScript & sPlayers, CScript & sMultis );
 	virtual bool r_Verb( CScript & s, CTextConsole * pSrc );
 
 	// AllThings Verbs
@@ -213,9 +217,6 @@ enum IMPFLAGS_TYPE	// IMPORT and EXPORT flags.
 	IMPFLAGS_ACCOUNT = 0x20		// 0x20 = recover just this account/char	(and all it is carrying)
 };
 
-#define FREE_UIDS_SIZE	500000	//	the list of free empty slots in the uids list should contain these elements
-
-
 class CWorldThread
 {
 	// A regional thread of execution. hold all the objects in my region.
@@ -223,10 +224,15 @@ class CWorldThread
 
 protected:
 	CGObArray<CObjBase*> m_UIDs;	// all the UID's in the World. CChar and CItem.
-	int m_iUIDIndexLast;	// remeber the last index allocated so we have more even usage.
 
-	DWORD	*m_FreeUIDs;		//	list of free uids available
-	DWORD	m_FreeOffset;		//	offset of the first free element
+	std::vector<DWORD> m_UIDFreeNext;	// next free slot of each free slot in m_UIDs (UID_FREE_OUT = not in the list)
+	std::vector<BYTE> m_UIDGen;			// generation of each slot (UIDGenerations)
+	DWORD	m_UIDFreeHead;		// oldest free slot, 0 = none
+	DWORD	m_UIDFreeTail;		// newest free slot
+
+	DWORD GetUIDSlot( DWORD dwIndex ) const;
+	void PushFreeUID( DWORD dwSlot );
+	void ResizeUIDs( DWORD dwCount );
 
 public:
 	static const char *m_sClassName;
@@ -240,10 +246,10 @@ public:
 	CGObList m_ObjDelete;		// Objects to be deleted.
 
 	// Background save. Does this belong here ?
-	CScript m_FileData;			// Save or Load file.
-	CScript m_FileWorld;		// Save or Load file.
-	CScript m_FilePlayers;		// Save of the players chars.
-	CScript m_FileMultis;		// Save of the custom multis.
+	CScriptBinary m_FileData;		// Save or Load file.
+	CScriptBinary m_FileWorld;		// Save or Load file.
+	CScriptBinary m_FilePlayers;	// Save of the players chars.
+	CScriptBinary m_FileMultis;		// Save of the custom multis.
 	bool	m_fSaveParity;		// has the sector been saved relative to the char entering it ?
 	MTRand	m_Rand;
 
@@ -254,7 +260,12 @@ public:
 	// UID Managenent
 	DWORD GetUIDCount() const;
 #define UID_PLACE_HOLDER (reinterpret_cast<CObjBase*>(0xFFFFFFFF))
+#define UID_FREE_OUT		0xFFFFFFFF	// slot is not in the free list
+#define UID_GEN_SLOT_MASK	0x00FFFFFF	// slot part of the index when UIDGenerations is on
+#define UID_GEN_MASK		0x0E000000	// generation part (UID_O_INDEX_FREE stays clear for the fake spell uids)
+#define UID_GEN_SHIFT		25
 	CObjBase * FindUID(DWORD dwIndex) const;
+	CObjBase * FindUIDSlot(DWORD dwSlot) const;	// ignores the generation, to walk the whole table
 	void FreeUID(DWORD dwIndex);
 	DWORD AllocUID( DWORD dwIndex, CObjBase * pObj );
 
@@ -347,6 +358,286 @@ class CTimedFunctionHandler
 		int IsTimer( CGrayUID uid, LPCTSTR funcname );
 };
 
+#define TIMERWHEEL_ROOT_BITS	8	// 256 single ticks in the first wheel.
+#define TIMERWHEEL_ROOT_SIZE	(1 << TIMERWHEEL_ROOT_BITS)
+#define TIMERWHEEL_LEVEL_BITS	6	// 64 buckets in each upper wheel.
+#define TIMERWHEEL_LEVEL_SIZE	(1 << TIMERWHEEL_LEVEL_BITS)
+#define TIMERWHEEL_LEVELS		3	// upper wheels. covers 2^26 ticks (~77 days), longer timers get parked in the last bucket.
+
+class CTimerWheel
+{
+	// Hierarchical timing wheel for the timers of top level items. (CSector::m_Items_Timer)
+	// Items are hashed into buckets by their expiry tick, so a pulse only touches
+	// the buckets that expire instead of sweeping every timed item in every sector.
+	// Expired items are handed to their sector, which ticks them on its own pulse. (sector sleep)
+public:
+	static const char *m_sClassName;
+
+private:
+	UINT64 m_lTime;		// next tick to be dispatched.
+	bool m_fInit;
+	CItem * m_pRoot[TIMERWHEEL_ROOT_SIZE];
+	CItem * m_pLevel[TIMERWHEEL_LEVELS][TIMERWHEEL_LEVEL_SIZE];
+
+private:
+	static UINT64 GetExpire( const CItem * pItem );
+	CItem ** GetBucket( UINT64 lExpire );
+	size_t Cascade( int iLevel );
+	void Rebase( UINT64 lTime );
+	void Dispatch( CItem * pItem );
+
+public:
+	CTimerWheel();
+
+private:
+	CTimerWheel(const CTimerWheel& copy);
+	CTimerWheel& operator=(const CTimerWheel& other);
+
+public:
+	static void Link( CItem ** ppHead, CItem * pItem );
+	static void Unlink( CItem * pItem );
+
+	void Schedule( CItem * pItem );
+	void OnTick( CServTime timeCurrent );
+};
+
+struct CSectorStripe
+{
+	// A band of sector columns on one map, always ticked as a whole by one thread.
+	int m_map;
+	int m_iColStart;
+	int m_iColEnd;		// not included.
+};
+
+enum TICKMOVE_TYPE
+{
+	TICKMOVE_SECTOR,	// MoveItemToSector(), MoveCharToSector(), MoveDisconnectedCharToSector()
+	TICKMOVE_CONT,		// CItemContainer::ContentAdd()
+	TICKMOVE_EQUIP,		// CChar::ItemEquip()
+	TICKMOVE_LAYER,		// CChar::LayerAdd()
+	TICKMOVE_DELETE		// CObjBase::Delete()
+};
+
+struct CSectorTickMove
+{
+	// A sector list change that would race with another stripe, done in order when the phase is over.
+	TICKMOVE_TYPE m_type;
+	CObjBase * m_pObj;
+	CSector * m_pSector;	// TICKMOVE_SECTOR
+	bool m_fActive;			// m_Chars_Active/m_Items_Timer or m_Chars_Disconnect/m_Items_Inert
+	bool m_fNotAMove;		// only an item timer change
+	CObjBase * m_pCont;		// TICKMOVE_CONT, TICKMOVE_EQUIP, TICKMOVE_LAYER
+	CPointMap m_pt;			// TICKMOVE_CONT
+	int m_iArg;				// grid index or layer
+};
+
+class CSectorTickContext
+{
+	// Per thread state while the sectors are ticked in parallel.
+	// Changes to the shared world lists are queued here and merged at the end of the phase.
+public:
+	static const char *m_sClassName;
+	const CSectorStripe * m_pStripe;	// stripe being ticked now.
+	MTRand m_Rand;
+	CGObList m_ObjNew;
+	CGObList m_ObjDelete;
+	CGPtrTypeArray<CObjBase*> m_ObjStatusUpdates;
+	std::vector<CSectorTickMove> m_Moves;
+
+public:
+	CSectorTickContext();
+
+private:
+	CSectorTickContext(const CSectorTickContext& copy);
+	CSectorTickContext& operator=(const CSectorTickContext& other);
+
+public:
+	bool IsInStripe( const CSectorBase * pSector ) const;
+	bool IsPending( const CObjBase * pObj ) const;
+	void Merge();
+	void MergeMoves();
+};
+
+class CSectorTicker;
+
+class CSectorTickThread : public AbstractSphereThread
+{
+	// Worker thread for CSectorTicker.
+public:
+	static const char *m_sClassName;
+	CSectorTickContext m_Context;
+
+private:
+	CSectorTicker & m_ticker;
+
+public:
+	CSectorTickThread( CSectorTicker & ticker, size_t id );
+	virtual ~CSectorTickThread();
+
+private:
+	CSectorTickThread(const CSectorTickThread& copy);
+	CSectorTickThread& operator=(const CSectorTickThread& other);
+
+protected:
+	virtual void onStart();
+	virtual void tick();
+};
+
+class CSectorTicker
+{
+	// Ticks the sectors on worker threads. (SectorThreads)
+	// The sector columns of each map are split in stripes, even and odd stripes are ticked
+	// in two phases so neighbouring sectors are never ticked at the same time.
+public:
+	static const char *m_sClassName;
+	static volatile bool sm_fParallel;				// a phase is running.
+	static SimpleMutex sm_WorldLock;				// shared world state during a phase. (see CSectorTickLock)
+	static TlsValue<CSectorTickContext *> sm_pContext;
+
+private:
+	std::vector<CSectorTickThread *> m_Threads;
+	std::vector<CSectorStripe> m_Stripes;
+	CSectorTickContext m_MainContext;	// for the thread calling OnTick()
+
+	SimpleMutex m_StripeLock;
+	AutoResetEvent m_PhaseEvent;	// a stripe has been finished.
+	size_t m_iNextStripe;
+	size_t m_iBusy;				// stripes being ticked.
+	int m_iPulse;
+
+public:
+	CSectorTicker();
+	~CSectorTicker();
+
+private:
+	CSectorTicker(const CSectorTicker& copy);
+	CSectorTicker& operator=(const CSectorTicker& other);
+
+public:
+	void Start();
+	void Stop();
+	bool IsActive() const
+	{
+		return !m_Threads.empty();
+	}
+	void OnTick( int iPulse );
+	bool TickNextStripe();
+
+	static CSectorTickContext * GetContext()
+	{
+		if ( !sm_fParallel )
+			return NULL;
+		return sm_pContext.get();
+	}
+	static MTRand & GetRand();
+	static bool IsDeferred( const CObjBase * pObj );
+	static bool DeferMove( CSector * pSector, CObjBase * pObj, bool fActive, bool fNotAMove = false );
+	static bool DeferContent( TICKMOVE_TYPE type, CObjBase * pCont, CItem * pItem, const CPointMap & pt, int iArg );
+	static bool DeferDelete( CObjBase * pObj );
+	static void ObjNew( CObjBase * pObj );
+	static void ObjDelete( CObjBase * pObj );
+	static void ObjStatusUpdate( CObjBase * pObj );
+};
+
+class CSectorTickLock
+{
+	// Serialise access to shared world state (scripts, packets, uids, timers) while
+	// the sectors are ticked in parallel. Does nothing otherwise.
+private:
+	ManualThreadLock m_lock;
+
+public:
+	CSectorTickLock()
+	{
+		if ( CSectorTicker::sm_fParallel )
+		{
+			m_lock.setMutex(&CSectorTicker::sm_WorldLock);
+			m_lock.doLock();
+		}
+	}
+
+private:
+	CSectorTickLock(const CSectorTickLock& copy);
+	CSectorTickLock& operator=(const CSectorTickLock& other);
+};
+
+class CSectorSaveBuffer
+{
+	// The records of one sector, for CSectorSaver.
+public:
+	static const char *m_sClassName;
+	CScriptBinary m_World;
+	CScriptBinary m_Players;
+	CScriptBinary m_Multis;
+
+public:
+	CSectorSaveBuffer()
+	{
+		m_World.SetBinary(true);
+		m_Players.SetBinary(true);
+		m_Multis.SetBinary(true);
+	}
+
+private:
+	CSectorSaveBuffer(const CSectorSaveBuffer& copy);
+	CSectorSaveBuffer& operator=(const CSectorSaveBuffer& other);
+};
+
+class CSectorSaver;
+
+class CSectorSaveThread : public AbstractSphereThread
+{
+	// Worker thread for CSectorSaver.
+public:
+	static const char *m_sClassName;
+
+private:
+	CSectorSaver & m_saver;
+
+public:
+	CSectorSaveThread( CSectorSaver & saver, size_t id );
+	virtual ~CSectorSaveThread();
+
+private:
+	CSectorSaveThread(const CSectorSaveThread& copy);
+	CSectorSaveThread& operator=(const CSectorSaveThread& other);
+
+protected:
+	virtual void tick();
+};
+
+class CSectorSaver
+{
+	// Serializes the sectors of a forced binary save on worker threads. (SaveThreads)
+	// Sectors are done a window at a time, then appended to the save files in sector order.
+public:
+	static const char *m_sClassName;
+
+private:
+	std::vector<CSectorSaveThread *> m_Threads;
+	CSectorSaveBuffer * m_pBuffers;	// one per sector of the window.
+	size_t m_iFirst;		// first sector of the window.
+	size_t m_iCount;		// sectors in the window.
+	size_t m_iNext;			// next sector of the window to serialize.
+	size_t m_iBusy;			// sectors being serialized.
+
+	SimpleMutex m_Lock;
+	AutoResetEvent m_DoneEvent;	// a sector has been serialized.
+
+public:
+	CSectorSaver();
+	~CSectorSaver();
+
+private:
+	CSectorSaver(const CSectorSaver& copy);
+	CSectorSaver& operator=(const CSectorSaver& other);
+
+public:
+	bool CanSave() const;
+	void Save( size_t iFrom, size_t iTo );
+	bool SaveNextSector();
+};
+
 extern class CWorld : public CScriptObj, public CWorldThread
 {
 	// the world. Stuff saved in *World.SCP
@@ -364,6 +655,10 @@ private:
 
 	int m_iSaveStage;			// Current stage of the background save.
 	ULONGLONG	m_savetimer;	// Time it takes to save
+#ifndef _WIN32
+	pid_t	m_iSaveForkPid;		// Process writing the current forked save. (SaveFork)
+	int		m_iSaveForkPipe;	// Reports the result of the forked save.
+#endif
 
 public:
 	static const char *m_sClassName;
@@ -394,6 +689,9 @@ public:
 	// TimedFunction Container/Wrapper
 	CTimedFunctionHandler m_TimedFunctions;
 	CGPtrTypeArray<CObjBase*> m_ObjStatusUpdates; // objects that need OnTickStatusUpdate called
+	CTimerWheel m_TimerWheel;	// timers of top level items.
+	CSectorTicker m_SectorTicker;	// parallel sector ticks. (SectorThreads)
+	CSectorSaver m_SectorSaver;		// parallel sector saves. (SaveThreads)
 
 private:
 	bool LoadFile(LPCTSTR pszName);
@@ -401,7 +699,14 @@ private:
 
 	bool SaveTry(bool fForceImmediate); // Save world state
 	bool SaveStage();
-	static void GetBackupName( CGString & sArchive, LPCTSTR pszBaseDir, TCHAR chType, int savecount );
+	void SaveSector( CSector * pSector );
+	void SaveGlobals();
+#ifndef _WIN32
+	bool SaveFork();
+	bool SaveForkChild();
+	void SaveForkCheck( bool fWait );
+#endif
+	static void GetBackupName( CGString & sArchive, LPCTSTR pszBaseDir, TCHAR chType, int savecount, LPCTSTR pszExt = SPHERE_SCRIPT );
 	bool SaveForce(); // Save world state
 
 public:
@@ -522,8 +827,20 @@ private:
 	CSector * m_pSector;	// current Sector
 	CRectMap m_rectSector;		// A rectangle containing our sectors we can search.
 	int		m_iSectorCur;		// What is the current Sector index in m_rectSector
+
+	// (SectorGrid) scan of the index cells of m_pSector
+	CSectorObjList * m_pList;	// current list (NULL = start of the sector)
+	int		m_iCellColMin;		// cells of m_pList overlapping the search box
+	int		m_iCellColMax;
+	int		m_iCellRowMax;
+	int		m_iCellCol;			// current cell
+	int		m_iCellRow;
+	size_t	m_iCellSlot;		// next slot of the current cell
 private:
 	bool GetNextSector();
+	bool IsInRange( const CObjBase * pObj ) const;
+	void SetCellList( CSectorObjList * pList );
+	CObjBase * GetNextCellObj( bool fChars );
 public:
 	static const char *m_sClassName;
 	explicit CWorldSearch( const CPointMap & pt, int iDist = 0 );
@@ -534,7 +851,7 @@ private:
 public:
 	void SetAllShow( bool fView ) { m_fAllShow = fView; }
 	void SetSearchSquare( bool fSquareSearch ) { m_fSearchSquare = fSquareSearch; }
-	void RestartSearch() { m_pObj = NULL; }		// Setting current obj to NULL will restart the search 
+	void RestartSearch() { m_pObj = NULL; m_pList = NULL; }		// Setting current obj to NULL will restart the search 
 	CChar * GetChar();
 	CItem * GetItem();
 };
@@ -997,6 +997,15 @@ void CWorld::GetHeightPoint( const CPointMap & pt, CGrayMapBlockState & block, b
 	height_t zHeight = 0;
 	int x2 = 0, y2 = 0;
 
+	// Asked the same here before ? (walk checks only, block must be as constructed)
+	CSector * pSector = NULL;
+	if ( g_Cfg.m_fWalkCache && fHouseCheck && pt.IsValidPoint() )
+	{
+		pSector = pt.GetSector();
+		if ( pSector && pSector->GetWalkCache( pt, block ))
+			return;
+	}
+
 	// Height of statics at/above given coordinates
 	// do gravity here for the z.
 	const CGrayMapBlock * pMapBlock = GetMapBlock( pt );
@@ -1249,6 +1258,9 @@ void CWorld::GetHeightPoint( const CPointMap & pt, CGrayMapBlockState & block, b
 			block.m_Top.m_z = UO_SIZE_Z;
 		}
 	}
+
+	if ( pSector )
+		pSector->SetWalkCache( pt, block );
 }
 
 signed char CWorld::GetHeightPoint( const CPointBase & pt, DWORD & wBlockFlags, bool fHouseCheck )
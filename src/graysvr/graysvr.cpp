@@ -685,8 +685,10 @@ void Sphere_ExitServer()
 	g_NetworkManager.stop();
 #endif
 	g_Main.waitForClose();
+	g_World.m_SectorTicker.Stop();
 	g_PingServer.waitForClose();
 	g_asyncHdb.waitForClose();
+	g_LogWriter.waitForClose();
 #if !defined(_WIN32) || defined(_LIBEV)
 	if ( g_Cfg.m_fUseAsyncNetwork != 0 )
 		g_NetworkEvent.waitForClose();
@@ -1148,6 +1150,73 @@ void defragSphere(char *path)
 	g_Log.Event(LOGM_INIT,	"Defragmentation complete.\n");
 }
 
+void convertSphere(char *path)
+{
+	ASSERT(path != NULL);
+
+	// Convert a save file from binary records to text or back. (SaveBinary)
+	// The converted file is next to it with the other extension, and being the most recent it is the one loaded.
+	bool fBinary = CScriptBinary::IsBinaryFile(path);
+
+	CGString sOutput(path);
+	LPCTSTR pszExt = CGFile::GetFilesExt(sOutput);
+	if ( pszExt != NULL )
+		sOutput.SetLength(static_cast<int>(pszExt - sOutput.GetPtr()));
+	sOutput += fBinary ? SPHERE_SCRIPT : SPHERE_SCRIPT_BIN;
+
+	g_Log.Event(LOGM_INIT, "Converting %s to %s\n", path, static_cast<LPCTSTR>(sOutput));
+
+	CScriptBinary inf;
+	inf.SetBinary(fBinary);
+	if ( !inf.Open(path, OF_READ|OF_TEXT|OF_DEFAULTMODE) )
+	{
+		g_Log.Event(LOGM_INIT, "Cannot open file for reading. Skipped!\n");
+		return;
+	}
+
+	CScriptBinary ouf;
+	ouf.SetBinary(!fBinary);
+	if ( !ouf.Open(sOutput, OF_WRITE|OF_TEXT|OF_DEFAULTMODE) )
+	{
+		g_Log.Event(LOGM_INIT, "Cannot open file for writing. Skipped!\n");
+		return;
+	}
+
+	DWORD dwLines = 0;
+	while ( inf.ReadTextLine(true) )
+	{
+		TCHAR * pszLine = inf.GetKeyBuffer();
+		if ( pszLine[0] == '[' )
+		{
+			TCHAR * pszEnd = strchr(pszLine, ']');
+			if ( pszEnd != NULL )
+				*pszEnd = '\0';
+			ouf.WriteSection("%s", pszLine + 1);
+		}
+		else
+		{
+			// KEY=VAL, anything else (books, hand written KEY VAL) is kept as a whole line.
+			TCHAR * pszSep = strchr(pszLine, '=');
+			if ( pszSep != NULL && pszSep > pszLine && strcspn(pszLine, " \t") >= static_cast<size_t>(pszSep - pszLine) )
+			{
+				*pszSep = '\0';
+				ouf.WriteKey(pszLine, pszSep + 1);
+			}
+			else
+			{
+				ouf.WriteKey(pszLine, NULL);
+			}
+		}
+
+		if ( ! ( ++dwLines & 0x3FFF ))
+			ouf.FlushBlock();
+	}
+
+	inf.Close();
+	ouf.Close();
+	g_Log.Event(LOGM_INIT, "Conversion complete, %lu lines.\n", dwLines);
+}
+
 #ifdef _WIN32
 int Sphere_MainEntryPoint( int argc, char *argv[] )
 #else
@@ -1164,6 +1233,10 @@ int _cdecl main( int argc, char * argv[] )
 	{
 		WritePidFile();
 
+		// Start the log writer, the log lines are queued to it from now on
+		if ( g_Cfg.m_fLogAsync )
+			g_LogWriter.start();
+
 		// Start the ping server, this can only be ran in a separate thread
 		if ( IsSetEF( EF_UsePingServer ) )
 			g_PingServer.start();
@@ -1180,6 +1253,7 @@ int _cdecl main( int argc, char * argv[] )
 #else
 		g_NetworkManager.start();
 #endif
+		g_World.m_SectorTicker.Start();
 			
 		bool shouldRunInThread = ( g_Cfg.m_iFreezeRestartTime > 0 );
 
@@ -154,6 +154,7 @@ enum RESDISPLAY_VERSION
 #include "../sphere/mutex.h"
 #include "../sphere/ProfileData.h"
 #include "../sphere/threads.h"
+#include "../sphere/containers.h"
 #if !defined(_WIN32) || defined(_LIBEV)
 	#include "../sphere/linuxev.h"
 #endif
@@ -207,6 +208,38 @@ extern DIR_TYPE GetDirStr( LPCTSTR pszDir );
 extern LPCTSTR GetTimeMinDesc( int dwMinutes );
 extern size_t FindStrWord( LPCTSTR pTextSearch, LPCTSTR pszKeyWord );
 
+#define LOG_QUEUE_SIZE		1024	// records waiting for the log writer thread (LogAsync)
+#define LOG_QUEUE_TEXT		256		// longer messages are written directly
+#define LOG_QUEUE_BUFFER	0x10000	// log file buffer while the writer thread runs
+
+struct CLogRecord
+{
+	// A log line waiting for the log writer thread.
+	DWORD m_wMask;
+	CGTime m_datetime;
+	TCHAR m_szContext[_MAX_PATH + 16];
+	TCHAR m_szMsg[LOG_QUEUE_TEXT];
+};
+
+class CLogWriter : public AbstractSphereThread
+{
+	// Writes the queued log records to the console and the log file. (LogAsync)
+public:
+	CLogWriter();
+	virtual ~CLogWriter() { };
+
+private:
+	CLogWriter(const CLogWriter& copy);
+	CLogWriter& operator=(const CLogWriter& other);
+
+public:
+	virtual void onStart();
+	virtual void tick();
+	virtual void waitForClose();
+};
+
+extern CLogWriter g_LogWriter;
+
 extern struct CLog : public CFileText, public CEventLog
 {
 	// subject matter. (severity level is first 4 bits, LOGL_EVENT)
@@ -232,6 +265,8 @@ private:
 	const CScriptObj * m_pObjectContext;	// The current context.
 
 	static CGTime sm_prevCatchTick;	// don't flood with these.
+
+	ThreadSafeRing<CLogRecord> m_Queue;	// records for the log writer thread.
 public:
 	bool m_fLockOpen;
 	SimpleMutex m_mutex;
@@ -292,10 +327,16 @@ public:
 	}
 
 	virtual int EventStr( DWORD wMask, LPCTSTR pszMsg );
+	void FlushQueue();
+#ifndef _WIN32
+	void OnForkPrepare();	// pthread_atfork handlers (SaveFork)
+	void OnForkParent();
+	void OnForkChild();
+#endif
 	void _cdecl CatchEvent( const CGrayError * pErr, LPCTSTR pszCatchContext, ...  ) __printfargs(3,4);
 
 public:
-	CLog()
+	CLog() : m_Queue(LOG_QUEUE_SIZE)
 	{
 		m_fLockOpen = false;
 		m_pScriptContext = NULL;
@@ -324,6 +365,9 @@ private:
 	 * Changes current console color to the specified one. Note, that the color should be reset after being set
 	 */
 	void SetColor(Color color);
+
+	bool IsQueued( DWORD wMask ) const;
+	void WriteEvent( DWORD wMask, const CGTime & datetime, LPCTSTR pszScriptContext, LPCTSTR pszMsg, bool fKeepOpen );
 } g_Log;		// Log file
 
 //////////////////
@@ -945,6 +989,7 @@ class CClientTooltip
 {
 public:
 	static const char *m_sClassName;
+	SLAB_DECLARE
 	DWORD m_clilocid;
 	TCHAR m_args[SCRIPT_MAX_LINE_LEN];
 
@@ -1000,6 +1045,8 @@ public:
 	static LPCTSTR const sm_szRefKeys[];
 	static LPCTSTR const sm_szLoadKeys[];
 	static LPCTSTR const sm_szVerbKeys[];
+	static const CTableHash sm_LoadKeysHash;
+	static const CTableHash sm_VerbKeysHash;
 	NetState *m_NetState;
 private:
 	CChar * m_pChar;			// What char are we playing ?
@@ -12,6 +12,8 @@
 #	define CLOSESOCKET(_x_)	{ shutdown(_x_, 2); close(_x_); }
 #endif
 
+PacketBufferPool g_PacketBufferPool;	// defined before the network objects so it outlives their packets
+
 #ifndef _MTNETWORK
 NetworkIn g_NetworkIn;
 NetworkOut g_NetworkOut;
@@ -88,6 +90,7 @@ NetState::NetState(long id)
 	m_incoming.buffer = NULL;
 #ifdef _MTNETWORK
 	m_incoming.rawBuffer = NULL;
+	m_incoming.framing = false;
 #endif
 	m_packetExceptions = 0;
 	m_clientType = CLIENTTYPE_2D;
@@ -114,6 +117,15 @@ void NetState::clear(void)
 	m_isWriteClosed = true;
 	m_needsFlush = false;
 
+#ifdef _MTNETWORK
+	// a network thread may be framing data for this client, wait for it to finish
+	// before the client goes
+	{
+		SimpleThreadLock lock(m_incoming.framingMutex);
+		m_incoming.framing = false;
+	}
+#endif
+
 	CClient* client = m_client;
 	if (client != NULL)
 	{
@@ -144,14 +156,6 @@ void NetState::clear(void)
 	// empty queues
 	clearQueues();
 
-	// clean junk queue entries
-	for (size_t i = 0; i < PacketSend::PRI_QTY; i++)
-		m_outgoing.queue[i].clean();
-	m_outgoing.asyncQueue.clean();
-#ifdef _MTNETWORK
-	m_incoming.rawPackets.clean();
-#endif
-
 	if (m_outgoing.currentTransaction != NULL)
 	{
 		delete m_outgoing.currentTransaction;
@@ -164,6 +168,10 @@ void NetState::clear(void)
 		m_outgoing.pendingTransaction = NULL;
 	}
 
+#ifdef _MTNETWORK
+	SimpleThreadLock lock(m_incoming.framingMutex);
+#endif
+
 	if (m_incoming.buffer != NULL)
 	{
 		delete m_incoming.buffer;
@@ -176,6 +184,7 @@ void NetState::clear(void)
 		delete m_incoming.rawBuffer;
 		m_incoming.rawBuffer = NULL;
 	}
+	m_incoming.framing = false;
 #endif
 
 	m_sequence = 0;
@@ -215,12 +224,19 @@ void NetState::clearQueues(void)
 	m_outgoing.bytes.Empty();
 	
 #ifdef _MTNETWORK
-	// clear received queue
+	// clear received queues
+	SimpleThreadLock lock(m_incoming.framingMutex);
 	while (m_incoming.rawPackets.empty() == false)
 	{
 		delete m_incoming.rawPackets.front();
 		m_incoming.rawPackets.pop();
 	}
+
+	while (m_incoming.packets.empty() == false)
+	{
+		delete m_incoming.packets.front();
+		m_incoming.packets.pop();
+	}
 #endif
 }
 
@@ -830,6 +846,162 @@ CClient* ClientIterator::next(bool includeClosing)
 }
 
 
+/***************************************************************************
+ *
+ *
+ *	class ClientAreaIterator	Works as client iterator getting the clients
+ *								whose character is near an object
+ *
+ *
+ ***************************************************************************/
+
+ClientAreaIterator::ClientAreaIterator(const CObjBaseTemplate* pObj, int iDist, const CPointMap* pptOld, bool fHearAll)
+{
+	m_fArea = false;
+	m_fHearAll = fHearAll;
+	m_iDist = iDist;
+	m_iPoints = 0;
+	m_iPoint = 0;
+	m_iSectorCur = 0;
+	m_pSector = NULL;
+	m_iChar = 0;
+
+	if (g_Cfg.m_fAreaOfInterest == false || pObj == NULL || iDist < 0)
+		return;
+
+	pObj = pObj->GetTopLevelObj();
+	if (pObj->IsDisconnected())
+		return;	// not placed in a sector
+
+	const CPointMap& pt = pObj->GetTopPoint();
+	if (pt.IsValidPoint() == false)
+		return;
+	if (CSectorTicker::sm_fParallel && iDist >= g_MapList.GetSectorSize(pt.m_map))
+		return;	// would reach sectors ticked by another thread
+
+	m_pt[m_iPoints++] = pt;
+	if (pptOld != NULL && pptOld->IsValidPoint())
+		m_pt[m_iPoints++] = *pptOld;
+
+	m_fArea = true;
+	setPoint(0);
+}
+
+ClientAreaIterator::~ClientAreaIterator(void)
+{
+	m_pSector = NULL;
+}
+
+CRectMap ClientAreaIterator::getRect(int iPoint) const
+{
+	// the points within m_iDist, right and bottom exclusive
+	const CPointMap& pt = m_pt[iPoint];
+	CRectMap rect;
+	rect.SetRect(pt.m_x - m_iDist, pt.m_y - m_iDist, pt.m_x + m_iDist + 1, pt.m_y + m_iDist + 1, pt.m_map);
+	return rect;
+}
+
+void ClientAreaIterator::setPoint(int iPoint)
+{
+	m_iPoint = iPoint;
+	const CPointMap& pt = m_pt[iPoint];
+
+	// CGRect::GetSector() rounds the right and bottom edges up
+	m_rect.SetRect(pt.m_x - m_iDist, pt.m_y - m_iDist, pt.m_x + m_iDist, pt.m_y + m_iDist, pt.m_map);
+	m_iSectorCur = 0;
+	m_pSector = NULL;
+	m_iChar = 0;
+}
+
+bool ClientAreaIterator::isSectorDone(const CSector* pSector) const
+{
+	// has the sector been walked for a previous point?
+	for (int i = 0; i < m_iPoint; ++i)
+	{
+		if (m_pt[i].m_map == pSector->GetMap() && getRect(i).IsOverlapped(pSector->GetRect()))
+			return true;
+	}
+	return false;
+}
+
+bool ClientAreaIterator::isCharDone(const CChar* pChar) const
+{
+	// has the char been returned from the sectors?
+	if (pChar == NULL || pChar->IsDisconnected())
+		return false;
+
+	for (int i = 0; i < m_iPoints; ++i)
+	{
+		const CPointMap& pt = pChar->GetTopPoint();
+		if (pt.m_map != m_pt[i].m_map)
+			continue;
+
+		CSector* pSector = pt.GetSector();
+		if (pSector != NULL && pSector->IsCharActiveIn(pChar) && getRect(i).IsOverlapped(pSector->GetRect()))
+			return true;
+	}
+	return false;
+}
+
+CClient* ClientAreaIterator::next(bool includeClosing)
+{
+	if (m_fArea == false)
+	{
+		for (CClient* current = m_all.next(includeClosing); current != NULL; current = m_all.next(includeClosing))
+		{
+			if (m_iPoints == 0)
+				return current;	// not narrowed at all
+
+			// the sectors are done, only the PRIV_HEARALL clients outside of them are left
+			if (current->IsPriv(PRIV_HEARALL) && isCharDone(current->GetChar()) == false)
+				return current;
+		}
+		return NULL;
+	}
+
+	for (;;)
+	{
+		if (m_pSector != NULL)
+		{
+			while (m_iChar < m_pSector->m_Chars_Active.GetClientCharCount())
+			{
+				CClient* current = m_pSector->m_Chars_Active.GetClientChar(m_iChar++)->m_pClient;
+
+				// same checks as ClientIterator
+				if (current == NULL || !current->m_NetState || !current->m_NetState->isInUse(current) || current->m_NetState->isClosed())
+					continue;
+				if (!includeClosing && current->m_NetState->isClosing())
+					continue;
+
+				return current;
+			}
+		}
+
+		// next sector around the current point
+		m_iChar = 0;
+		m_pSector = m_rect.GetSector(m_iSectorCur++);
+		if (m_pSector != NULL)
+		{
+			if (isSectorDone(m_pSector))
+				m_pSector = NULL;
+			continue;
+		}
+
+		if (m_iPoint + 1 < m_iPoints)
+		{
+			setPoint(m_iPoint + 1);
+			continue;
+		}
+
+		// all the sectors are done
+		m_fArea = false;
+		if (m_fHearAll == false)
+			return NULL;
+		return next(includeClosing);
+	}
+}
+
+
 #ifndef _MTNETWORK
 /***************************************************************************
  *
@@ -1300,6 +1472,7 @@ void NetworkIn::tick(void)
 
 				handler->resize(packetLength);
 				handler->seek(1);
+				ProfileScope packetScope("packet", packetID);
 				handler->onReceive(client);
 			}
 			else
@@ -1389,10 +1562,6 @@ int NetworkIn::checkForData(fd_set* storage)
 		if ( state->isInUse() == false )
 			continue;
 
-		EXC_SET("cleaning queues");
-		for (int i = 0; i < PacketSend::PRI_QTY; i++)
-			state->m_outgoing.queue[i].clean();
-
 		EXC_SET("check closing");
 		if (state->isClosing())
 		{
@@ -2013,7 +2182,6 @@ size_t NetworkOut::proceedQueueAsync(CClient* client)
 	if (state->isWriteClosed() || state->isAsyncMode() == false)
 		return 0;
 
-	state->m_outgoing.asyncQueue.clean();
 	if (state->m_outgoing.asyncQueue.empty() || state->isSendingAsync())
 		return 0;
 
@@ -2182,15 +2350,28 @@ bool NetworkOut::sendPacketNow(CClient* client, PacketSend* packet)
 				// game clients require encryption
 				EXC_SET("compress and encrypt");
 
-				// compress
-				size_t compressLength = client->xCompress(m_encryptBuffer, packet->getData(), packet->getLength());
+				// compress, broadcast packets share their compressed data
+				size_t compressLength;
+				const BYTE* compressBuffer;
+				if (packet->getCompressed() != NULL)
+				{
+					compressBuffer = packet->getCompressed()->compress(m_encryptBuffer, compressLength);
+				}
+				else
+				{
+					compressLength = client->xCompress(m_encryptBuffer, packet->getData(), packet->getLength());
+					compressBuffer = m_encryptBuffer;
+				}
 
 				// encrypt
 				if (client->m_Crypt.GetEncryptionType() == ENC_TFISH)
-					client->m_Crypt.Encrypt(m_encryptBuffer, m_encryptBuffer, compressLength);
+				{
+					client->m_Crypt.Encrypt(m_encryptBuffer, compressBuffer, compressLength);
+					compressBuffer = m_encryptBuffer;
+				}
 
-				sendBuffer = m_encryptBuffer;
-				sendBufferLength = compressLength;
+				sendBuffer = const_cast<BYTE*>(compressBuffer);
+				sendBufferLength = static_cast<DWORD>(compressLength);
 			}
 			else
 			{
@@ -2704,12 +2885,6 @@ void NetworkManager::tick(void)
 		if (state->isInUse() == false)
 			continue;
 
-		// clean packet queue entries
-		EXC_SET("cleaning queues");
-		for (int priority = 0; priority < PacketSend::PRI_QTY; ++priority)
-			state->m_outgoing.queue[priority].clean();
-		state->m_outgoing.asyncQueue.clean();
-
 		EXC_SET("check closing");
 		if (state->isClosing() == false)
 		{
@@ -2828,7 +3003,7 @@ size_t NetworkManager::flush(NetState * state)
  ***************************************************************************/
 NetworkThread::NetworkThread(NetworkManager& manager, size_t id)
 	: AbstractSphereThread(GenerateNetworkThreadName(id), IThread::Disabled),
-	m_manager(manager), m_id(id)
+	m_manager(manager), m_id(id), m_assignQueue(manager.m_stateCount)
 {
 }
 
@@ -2841,7 +3016,17 @@ NetworkThread::~NetworkThread(void)
 void NetworkThread::assignNetworkState(NetState* state)
 {
 	ADDTOCALLSTACK("NetworkThread::assignNetworkState");
-	m_assignQueue.push(state);
+	while (m_assignQueue.push(state) == false)
+	{
+		// every slot is waiting to be taken, let the thread catch up
+		if (isActive() == false)
+		{
+			checkNewStates();
+			continue;
+		}
+		awaken();
+		Sleep(1);
+	}
 	if (getPriority() == IThread::Disabled)
 		awaken();
 }
@@ -2860,6 +3045,9 @@ void NetworkThread::checkNewStates(void)
 		ASSERT(state != NULL);
 		state->setParentThread(this);
 		m_states.push_back(state);
+#ifdef MTNETWORK_EPOLL
+		m_input.addSocket(state);
+#endif
 	}
 }
 
@@ -2875,12 +3063,18 @@ void NetworkThread::dropInvalidStates(void)
 		if (state->getParentThread() != this)
 		{
 			// state has been unassigned or reassigned elsewhere
+#ifdef MTNETWORK_EPOLL
+			m_input.removeSocket(state);
+#endif
 			it = m_states.erase(it);
 		}
 		else if (state->isInUse() == false)
 		{
 			// state is invalid
 			state->setParentThread(NULL);
+#ifdef MTNETWORK_EPOLL
+			m_input.removeSocket(state);
+#endif
 			it = m_states.erase(it);
 		}
 		else
@@ -2951,6 +3145,10 @@ NetworkInput::NetworkInput(void) : m_thread(NULL)
 {
 	m_receiveBuffer = new BYTE[NETWORK_BUFFERSIZE];
 	m_decryptBuffer = new BYTE[NETWORK_BUFFERSIZE];
+#ifdef MTNETWORK_EPOLL
+	m_epoll = epoll_create1(EPOLL_CLOEXEC);
+	m_events = new epoll_event[NETWORK_EPOLLEVENTS];
+#endif
 }
 
 NetworkInput::~NetworkInput()
@@ -2959,8 +3157,49 @@ NetworkInput::~NetworkInput()
 		delete[] m_receiveBuffer;
 	if (m_decryptBuffer != NULL)
 		delete[] m_decryptBuffer;
+#ifdef MTNETWORK_EPOLL
+	if (m_epoll >= 0)
+		close(m_epoll);
+	delete[] m_events;
+#endif
+}
+
+#ifdef MTNETWORK_EPOLL
+void NetworkInput::addSocket(NetState* state)
+{
+	// start waiting for input on a state's socket
+	ADDTOCALLSTACK("NetworkInput::addSocket");
+	ASSERT(state != NULL);
+
+	SOCKET socket = state->m_socket.GetSocket();
+	if (m_epoll < 0 || socket == INVALID_SOCKET)
+		return;
+
+	// edge triggered, receiveData reads the socket until it would block
+	epoll_event ev;
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN|EPOLLRDHUP|EPOLLET;
+	ev.data.ptr = state;
+
+	if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, socket, &ev) != 0 && errno == EEXIST)
+		epoll_ctl(m_epoll, EPOLL_CTL_MOD, socket, &ev);
 }
 
+void NetworkInput::removeSocket(NetState* state)
+{
+	// stop waiting for input on a state's socket
+	ADDTOCALLSTACK("NetworkInput::removeSocket");
+	ASSERT(state != NULL);
+
+	// closed sockets have already left the set
+	SOCKET socket = state->m_socket.GetSocket();
+	if (m_epoll < 0 || socket == INVALID_SOCKET)
+		return;
+
+	epoll_ctl(m_epoll, EPOLL_CTL_DEL, socket, NULL);
+}
+#endif
+
 bool NetworkInput::processInput()
 {
 	ADDTOCALLSTACK("NetworkInput::processInput");
@@ -2981,9 +3220,14 @@ bool NetworkInput::processInput()
 		// wake up the thread
 		if (m_thread->isActive() && m_thread->getPriority() == IThread::Disabled)
 		{
+#ifdef MTNETWORK_EPOLL
+			if (isDataWaiting())
+				m_thread->awaken();
+#else
 			fd_set fds;
 			if (checkForData(fds))
 				m_thread->awaken();
+#endif
 		}
 
 		processData();
@@ -3001,6 +3245,32 @@ void NetworkInput::receiveData()
 #endif
 	EXC_TRY("ReceiveData");
 
+#ifdef MTNETWORK_EPOLL
+	// check for incoming data, only the ready sockets are reported
+	EXC_SET("epoll");
+	int count = checkForData();
+	if (count <= 0)
+		return;
+
+	EXC_SET("messages");
+	for (int i = 0; i < count; ++i)
+	{
+		NetState* state = static_cast<NetState*>(m_events[i].data.ptr);
+		ASSERT(state != NULL);
+
+		EXC_SET("check socket");
+		if (state->getParentThread() != m_thread || state->isReadClosed())
+			continue;
+
+		EXC_SET("start network profile");
+		ProfileTask networkTask(PROFILE_NETWORK_RX);
+
+		// edge triggered, so read until there is nothing left
+		EXC_SET("messages - receive");
+		while (receiveData(state))
+			;
+	}
+#else
 	// check for incoming data
 	EXC_SET("select");
 	fd_set fds;
@@ -3018,43 +3288,196 @@ void NetworkInput::receiveData()
 		EXC_SET("start network profile");
 		ProfileTask networkTask(PROFILE_NETWORK_RX);
 		if ( ! FD_ISSET(state->m_socket.GetSocket(), &fds))
-		{
-			state->m_incoming.rawPackets.clean();
 			continue;
-		}
 			
 		// receive data
 		EXC_SET("messages - receive");
-		int received = state->m_socket.Receive(m_receiveBuffer, NETWORK_BUFFERSIZE, 0);
-		if (received <= 0 || received > NETWORK_BUFFERSIZE)
+		receiveData(state);
+	}
+#endif
+
+	EXC_CATCH;
+}
+
+bool NetworkInput::receiveData(NetState* state)
+{
+	ADDTOCALLSTACK("NetworkInput::receiveData(state)");
+	ASSERT(state != NULL);
+
+	int received = state->m_socket.Receive(m_receiveBuffer, NETWORK_BUFFERSIZE, 0);
+	if (received <= 0 || received > NETWORK_BUFFERSIZE)
+	{
+#ifdef MTNETWORK_EPOLL
+		if (received < 0)
 		{
-			state->markReadClosed();
-			EXC_SET("next state");
-			continue;
+			// nothing more to read yet
+			int errorCode = CGSocket::GetLastError(true);
+			if (errorCode == EAGAIN || errorCode == EWOULDBLOCK)
+				return false;
 		}
+#endif
+		state->markReadClosed();
+		return false;
+	}
 
-		EXC_SET("start client profile");
-		CurrentProfileData.Count(PROFILE_DATA_RX, received);
+	CurrentProfileData.Count(PROFILE_DATA_RX, received);
+
+	SimpleThreadLock lock(state->m_incoming.framingMutex);
+	if (state->m_incoming.framing)
+	{
+		// game clients in the world have their data decrypted and split into packets here
+		frameData(state, m_receiveBuffer, static_cast<size_t>(received));
+		return true;
+	}
+
+	// otherwise we just take the data and push it into a queue for the main thread
+	// to parse into actual packets, since the login handshakes vary between the
+	// client types and encryptions that may be connecting
+	Packet* packet = new Packet(m_receiveBuffer, received);
+	state->m_incoming.rawPackets.push(packet);
+	return true;
+}
+
+void NetworkInput::frameData(NetState* state, const BYTE* data, size_t length)
+{
+	ADDTOCALLSTACK("NetworkInput::frameData");
+	ASSERT(state != NULL);
+	CClient* client = state->m_client;
+	ASSERT(client != NULL);
+
+	client->m_Crypt.Decrypt(m_decryptBuffer, data, length);
+
+	// append to the data left over from the last time
+	Packet* buffer = state->m_incoming.buffer;
+	if (buffer == NULL)
+	{
+		buffer = new Packet(m_decryptBuffer, length);
+		state->m_incoming.buffer = buffer;
+	}
+	else
+	{
+		buffer->seek(buffer->getLength());
+		buffer->writeData(m_decryptBuffer, length);
+		buffer->sync();
+		buffer->trim();
+		buffer->seek();
+	}
+
+	// queue every complete packet for the main thread
+	while (buffer->getRemainingLength() > 0)
+	{
+		BYTE packetId = buffer->getRemainingData()[0];
+		Packet* handler = m_thread->m_manager.getPacketManager().getHandler(packetId);
+
+		size_t packetLength;
+		if (handler != NULL)
+		{
+			packetLength = handler->checkLength(state, buffer);
+			if (packetLength <= 0)
+				break;	// wait for more data
+		}
+		else
+		{
+			// unknown packet, its length can't be known so the main thread gets all the data left
+			packetLength = buffer->getRemainingLength();
+		}
+
+		state->m_incoming.packets.push(new Packet(buffer->getRemainingData(), packetLength));
+		buffer->skip(static_cast<long>(packetLength));
+	}
+
+	// keep the incomplete packet at the start of the buffer
+	buffer->compact();
+}
+
+void NetworkInput::startFraming(NetState* state)
+{
+	ADDTOCALLSTACK("NetworkInput::startFraming");
+	ASSERT(state != NULL);
+	const CClient* client = state->m_client;
+	ASSERT(client != NULL);
+
+	// the encryption must be final and the client version known, so the packet lengths
+	// don't change anymore
+	if (client->GetConnectType() != CONNECT_GAME || client->m_Crypt.IsInit() == false || client->GetChar() == NULL)
+		return;
+	if (state->isClosing() || state->m_incoming.rawBuffer != NULL)
+		return;
+
+	// the network thread can only take over once all the data queued so far has been
+	// decrypted here, any partial packet left in the buffer is completed by it
+	SimpleThreadLock lock(state->m_incoming.framingMutex);
+	if (state->m_incoming.rawPackets.empty())
+		state->m_incoming.framing = true;
+}
+
+void NetworkInput::processFramedData(NetState* state)
+{
+	ADDTOCALLSTACK("NetworkInput::processFramedData");
+	EXC_TRY("ProcessFramedData");
+	ASSERT(state != NULL);
+	CClient* client = state->m_client;
+	ASSERT(client != NULL);
+
+	while (state->isClosing() == false && state->m_incoming.packets.empty() == false)
+	{
+		Packet* packet = state->m_incoming.packets.front();
+		state->m_incoming.packets.pop();
+		ASSERT(packet != NULL);
+
+		client->m_timeLastEvent = CServTime::GetCurrentTime();
+
+		EXC_SET("record message");
+#ifdef _DEBUG
+		xRecordPacket(client, packet, "client->server");
+#endif
+
+		EXC_TRYSUB("ProcessMessage");
+
+		BYTE packetId = packet->getData()[0];
+		size_t packetLength = packet->getLength();
+		Packet* handler = m_thread->m_manager.getPacketManager().getHandler(packetId);
+
+		// Packet filtering - check if any function trigger is installed
+		//  allow skipping the packet which we do not wish to get
+		if (client->xPacketFilter(packet->getData(), packetLength) == false)
+		{
+			if (handler != NULL)
+			{
+				// copy data to handler
+				handler->seek();
+				handler->writeData(packet->getData(), packetLength);
 
-		EXC_SET("messages - parse");
+				// move to position 1 (no need for id) and fire onReceive()
+				handler->resize(packetLength);
+				handler->seek(1);
+				ProfileScope packetScope("packet", packetId);
+				handler->onReceive(state);
+			}
+			else
+			{
+				// unknown packet, it holds everything that was received after it
+				g_Log.Event(LOGM_CLIENTS_LOG|LOGL_WARN, "%lx:Unknown game packet (0x%x) received.\n", state->id(), packetId);
+			}
+		}
+
+		EXC_CATCHSUB("Message");
+		EXC_DEBUGSUB_START;
+		TemporaryString dump;
+		packet->dump(dump);
+
+		g_Log.EventDebug("%lx:Parsing %s", state->id(), static_cast<LPCTSTR>(dump));
 
-		// our objective here is to take the received data and separate it into packets to
-		// be stored in NetState::m_incoming.rawPackets
-		BYTE* buffer = m_receiveBuffer;
-		while (received > 0)
+		state->m_packetExceptions++;
+		if (state->m_packetExceptions > 10)
 		{
-			// currently we just take the data and push it into a queue for the main thread
-			// to parse into actual packets
-			// todo: if possible, it would be useful to be able to perform that separation here,
-			// but this is made difficult due to the variety of client types and encryptions that
-			// may be connecting
-			size_t length = received;
-
-			Packet* packet = new Packet(buffer, length);
-			state->m_incoming.rawPackets.push(packet);
-			buffer += length;
-			received -= static_cast<int>(length);
+			g_Log.Event(LOGM_CLIENTS_LOG|LOGL_WARN, "%lx:Disconnecting client from account '%s' since it is causing exceptions problems\n", state->id(), client->m_pAccount ? client->m_pAccount->GetName() : "");
+			client->addKick(&g_Serv, false);
 		}
+
+		EXC_DEBUGSUB_END;
+
+		delete packet;
 	}
 
 	EXC_CATCH;
@@ -3085,7 +3508,7 @@ void NetworkInput::processData()
 		ASSERT(client != NULL);
 
 		EXC_SET("check message");
-		if (state->m_incoming.rawPackets.empty())
+		if (state->m_incoming.rawPackets.empty() && state->m_incoming.packets.empty())
 		{
 			if ((client->GetConnectType() != CONNECT_TELNET) && (client->GetConnectType() != CONNECT_AXIS))
 			{
@@ -3161,6 +3584,17 @@ void NetworkInput::processData()
 					state->m_incoming.rawBuffer = NULL;
 				}
 			}
+
+			if (state->m_incoming.framing)
+			{
+				EXC_SET("packets - dispatch");
+				processFramedData(state);
+			}
+			else if (g_Cfg.m_fNetworkFraming)
+			{
+				EXC_SET("packets - start framing");
+				startFraming(state);
+			}
 		}
 		EXC_SET("next state");
 	}
@@ -3168,6 +3602,36 @@ void NetworkInput::processData()
 	EXC_CATCH;
 }
 
+#ifdef MTNETWORK_EPOLL
+bool NetworkInput::isDataWaiting(void)
+{
+	// the epoll set is readable while it has events, polling it leaves them for the thread
+	ADDTOCALLSTACK("NetworkInput::isDataWaiting");
+
+	pollfd pfd;
+	pfd.fd = m_epoll;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+	return poll(&pfd, 1, 0) > 0;
+}
+
+int NetworkInput::checkForData(void)
+{
+	// collect the sockets we own that have data waiting
+	ADDTOCALLSTACK("NetworkInput::checkForData");
+
+	if (m_epoll < 0)
+		return 0;
+
+	int count;
+	do
+	{
+		count = epoll_wait(m_epoll, m_events, NETWORK_EPOLLEVENTS, 0);
+	} while (count < 0 && errno == EINTR);
+
+	return count;
+}
+#else
 bool NetworkInput::checkForData(fd_set& fds)
 {
 	// select() against each socket we own
@@ -3203,6 +3667,7 @@ bool NetworkInput::checkForData(fd_set& fds)
 	EXC_CATCH;
 	return false;
 }
+#endif
 
 bool NetworkInput::processData(NetState* state, Packet* buffer)
 {
@@ -3293,6 +3758,7 @@ bool NetworkInput::processGameClientData(NetState* state, Packet* buffer)
 			// move to position 1 (no need for id) and fire onReceive()
 			handler->resize(packetLength);
 			handler->seek(1);
+			ProfileScope packetScope("packet", packetId);
 			handler->onReceive(state);
 		}
 		else
@@ -3586,13 +4052,10 @@ bool NetworkInput::processUnknownClientData(NetState* state, Packet* buffer)
  ***************************************************************************/
 NetworkOutput::NetworkOutput() : m_thread(NULL)
 {
-	m_encryptBuffer = new BYTE[MAX_BUFFER];
 }
 
 NetworkOutput::~NetworkOutput()
 {
-	if (m_encryptBuffer != NULL)
-		delete[] m_encryptBuffer;
 }
 
 bool NetworkOutput::processOutput()
@@ -3810,6 +4273,11 @@ size_t NetworkOutput::processPacketQueue(NetState* state, unsigned int priority)
 		EXC_DEBUG_END;
 	}
 
+	// if buffering is disabled then send what this queue has gathered straight away,
+	// without waiting for the other queues
+	if (g_Cfg.m_fUseExtraBuffer == false && packetsProcessed > 0)
+		processByteQueue(state);
+
 	if (packetsProcessed >= maxPacketsToProcess)
 	{
 		DEBUGNETWORK(("Reached maximum packet count limit for this tick (%" FMTSIZE_T "/%" FMTSIZE_T ").\n", packetsProcessed, maxPacketsToProcess));
@@ -3956,46 +4424,41 @@ bool NetworkOutput::sendPacketData(NetState* state, PacketSend* packet)
 		return true;
 	}
 
-	EXC_SET("prepare data");
-	BYTE* sendBuffer = NULL;
-	size_t sendBufferLength = 0;
-
+	// packet data is gathered in the byte queue, which is sent in one go by
+	// processByteQueue once the queues of the client have been processed
 	if (client->GetConnectType() == CONNECT_GAME)
 	{
-		// game clients require encryption
+		// game clients require encryption, which is done straight into the byte queue
 		EXC_SET("compress and encrypt");
+		BYTE* queueBuffer = state->m_outgoing.bytes.AddNewDataLock(COMPRESS_MAXLENGTH(packet->getLength()));
+		size_t compressLength;
 
-		// compress
-		size_t compressLength = client->xCompress(m_encryptBuffer, packet->getData(), packet->getLength());
-
-		// encrypt
-		if (client->m_Crypt.GetEncryptionType() == ENC_TFISH)
-			client->m_Crypt.Encrypt(m_encryptBuffer, m_encryptBuffer, compressLength);
+		// compress, broadcast packets share their compressed data
+		if (packet->getCompressed() != NULL)
+		{
+			const BYTE* compressBuffer = packet->getCompressed()->compress(queueBuffer, compressLength);
+			if (client->m_Crypt.GetEncryptionType() == ENC_TFISH)
+				client->m_Crypt.Encrypt(queueBuffer, compressBuffer, compressLength);
+			else
+				memcpy(queueBuffer, compressBuffer, compressLength);
+		}
+		else
+		{
+			compressLength = client->xCompress(queueBuffer, packet->getData(), packet->getLength());
+			if (client->m_Crypt.GetEncryptionType() == ENC_TFISH)
+				client->m_Crypt.Encrypt(queueBuffer, queueBuffer, compressLength);
+		}
 
-		sendBuffer = m_encryptBuffer;
-		sendBufferLength = compressLength;
+		EXC_SET("queue data");
+		state->m_outgoing.bytes.AddNewDataFinish(compressLength);
 	}
 	else
 	{
 		// other clients expect plain data
-		sendBuffer = packet->getData();
-		sendBufferLength = packet->getLength();
+		EXC_SET("queue data");
+		state->m_outgoing.bytes.AddNewData(packet->getData(), packet->getLength());
 	}
 
-	// queue packet data
-	EXC_SET("queue data");
-	state->m_outgoing.bytes.AddNewData(sendBuffer, sendBufferLength);
-
-	// if buffering is disabled then process the queue straight away
-	// we need to do this rather than sending the packet data directly, otherwise if
-	// the packet does not send all at once we will be stuck with an incomplete data
-	// transfer (and no clean way to recover)
-	if (g_Cfg.m_fUseExtraBuffer == false)
-	{
-		EXC_SET("send data");
-		processByteQueue(state);
-	}
-		
 	EXC_SET("sent trigger");
 	packet->onSent(client);
 	delete packet;
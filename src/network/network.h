@@ -22,6 +22,15 @@
 #ifdef _MTNETWORK
 	#define MTNETWORK_INPUT		// handle input in multithreaded mode
 	#define MTNETWORK_OUTPUT	// handle output in multithreaded mode
+	#if !defined(_WIN32) && !defined(_BSD)
+		#define MTNETWORK_EPOLL	// wait for input on an epoll set per thread instead of select()
+	#endif
+#endif
+
+#ifdef MTNETWORK_EPOLL
+	#include <sys/epoll.h>
+	#include <poll.h>
+	#define NETWORK_EPOLLEVENTS 256	// max sockets reported ready per wait
 #endif
 
 #define NETWORK_DISCONNECTPRI	PacketSend::PRI_HIGHEST			// packet priorty to continue sending before closing sockets
@@ -107,6 +116,9 @@ protected:
 #ifdef _MTNETWORK
 		PacketQueue rawPackets; // raw data packets
 		Packet* rawBuffer; // received data
+		PacketQueue packets; // complete packets split by the network thread
+		volatile bool framing; // is the network thread decrypting and splitting the data (buffer is then owned by it)
+		SimpleMutex framingMutex; // held while raw data is queued or framing is switched on
 #endif
 	} m_incoming; // incoming data
 
@@ -323,6 +335,49 @@ public:
 	CClient* next(bool includeClosing = false); // finds next client
 };
 
+/***************************************************************************
+ *
+ *
+ *	class ClientAreaIterator	Works as client iterator getting the clients
+ *								whose character is near an object
+ *
+ *
+ ***************************************************************************/
+class ClientAreaIterator
+{
+	// Walks the client chars of the sectors around the object (and around its old point)
+	// when AreaOfInterest is on, otherwise all the clients like ClientIterator.
+	// Callers must still check the distance (CanSee, CanHear, ...) of each client.
+protected:
+	ClientIterator m_all;		// all the clients (fallback, then PRIV_HEARALL clients)
+	bool m_fArea;				// walking the sectors
+	bool m_fHearAll;			// then add the PRIV_HEARALL clients outside the sectors
+	int m_iDist;
+	CPointMap m_pt[2];			// center, old point
+	int m_iPoints;
+	int m_iPoint;				// current center
+	CRectMap m_rect;			// sectors around m_pt[m_iPoint]
+	int m_iSectorCur;
+	CSector* m_pSector;
+	size_t m_iChar;				// next client char of m_pSector
+
+public:
+	explicit ClientAreaIterator(const CObjBaseTemplate* pObj, int iDist = UO_MAP_VIEW_RADAR, const CPointMap* pptOld = NULL, bool fHearAll = false);
+	~ClientAreaIterator(void);
+
+private:
+	ClientAreaIterator(const ClientAreaIterator& copy);
+	ClientAreaIterator& operator=(const ClientAreaIterator& other);
+
+	void setPoint(int iPoint);
+	CRectMap getRect(int iPoint) const;
+	bool isSectorDone(const CSector* pSector) const;
+	bool isCharDone(const CChar* pChar) const;
+
+public:
+	CClient* next(bool includeClosing = false); // finds next client
+};
+
 #ifndef _MTNETWORK
 /***************************************************************************
  *
@@ -476,6 +531,10 @@ private:
 	NetworkThread* m_thread;	// owning network thread
 	BYTE* m_receiveBuffer;		// buffer for received data
 	BYTE* m_decryptBuffer;		// buffer for decrypted data
+#ifdef MTNETWORK_EPOLL
+	int m_epoll;				// epoll set of the sockets we own
+	epoll_event* m_events;		// ready sockets returned by epoll_wait
+#endif
 
 public:
 	static const char* m_sClassName;
@@ -489,16 +548,30 @@ private:
 public:
 	void setOwner(NetworkThread* thread) { m_thread = thread; } // set owner thread
 	bool processInput(void);									// process input from clients, returns true if work was done
+#ifdef MTNETWORK_EPOLL
+	void addSocket(NetState* state);							// start waiting for input on a state's socket
+	void removeSocket(NetState* state);							// stop waiting for input on a state's socket
+#endif
 
 private:
+#ifdef MTNETWORK_EPOLL
+	bool isDataWaiting(void);			// check for pending data without taking the events
+	int checkForData(void);				// get the states which have pending data to read
+#else
 	bool checkForData(fd_set& fds);		// check for states which have pending data to read
+#endif
 	void receiveData();					// receive raw data for all sockets
+	bool receiveData(NetState* state);	// receive raw data for a socket, returns true if more may be waiting
 	void processData();					// process received data for all sockets
 
 	bool processData(NetState* state, Packet* buffer);				// process received data
 	bool processUnknownClientData(NetState* state, Packet* buffer);	// process data from an unknown client type
 	bool processOtherClientData(NetState* state, Packet* buffer);		// process data from a non-game client
 	bool processGameClientData(NetState* state, Packet* buffer);		// process data from a game client
+
+	void frameData(NetState* state, const BYTE* data, size_t length);	// decrypt received data and split it into packets (network thread)
+	void startFraming(NetState* state);									// hand decryption and splitting of a state's data to the network thread
+	void processFramedData(NetState* state);							// process the packets split by the network thread
 };
 
 	
@@ -516,7 +589,6 @@ private:
 
 private:
 	NetworkThread* m_thread;	// owning network thread
-	BYTE* m_encryptBuffer;		// buffer for encrpyted data
 
 public:
 	static const char* m_sClassName;
@@ -642,7 +714,7 @@ private:
 	size_t m_id;								// network thread #
 
 	NetworkStateList m_states;					// states controlled by this thread
-	ThreadSafeQueue<NetState*> m_assignQueue;	// queue of states waiting to be taken by this thread
+	ThreadSafeRing<NetState*> m_assignQueue;	// queue of states waiting to be taken by this thread
 
 	NetworkInput m_input;		// handles data input
 	NetworkOutput m_output;		// handles data output
@@ -15,20 +15,100 @@ extern int CvtNUNICODEToSystem( TCHAR * pOut, int iSizeOutBytes, const NCHAR * p
 #undef USE_UNICODE_LIB
 #endif
 
-Packet::Packet(size_t size) : m_buffer(NULL)
+/***************************************************************************
+ *
+ *
+ *	class PacketBufferPool		Recycles packet buffers by power of 2 size classes
+ *
+ *
+ ***************************************************************************/
+PacketBufferPool::PacketBufferPool(void)
+{
+	memset(m_freeCount, 0, sizeof(m_freeCount));
+}
+
+PacketBufferPool::~PacketBufferPool(void)
+{
+	for (size_t i = 0; i < PACKET_POOL_CLASSES; i++)
+	{
+		while (m_freeCount[i] > 0)
+			delete[] m_free[i][--m_freeCount[i]];
+	}
+}
+
+size_t PacketBufferPool::getClass(size_t size)
+{
+	size_t index = 0;
+	for (size_t classSize = PACKET_POOL_MINSIZE; classSize < size; classSize <<= 1)
+	{
+		if (++index >= PACKET_POOL_CLASSES)
+			break;
+	}
+	return index;
+}
+
+BYTE* PacketBufferPool::allocate(size_t& size)
+{
+	// round up to the size class, so growing buffers double in size
+	size_t index = getClass(size);
+	if (index >= PACKET_POOL_CLASSES)
+		return new BYTE[size];
+
+	size = PACKET_POOL_MINSIZE << index;
+
+	SimpleThreadLock lock(m_mutex[index]);
+	if (m_freeCount[index] > 0)
+		return m_free[index][--m_freeCount[index]];
+
+	return new BYTE[size];
+}
+
+void PacketBufferPool::release(BYTE* buffer, size_t size)
+{
+	if (buffer == NULL)
+		return;
+
+	if (g_Cfg.m_fPacketPool)
+	{
+		size_t index = getClass(size);
+		if (index < PACKET_POOL_CLASSES && size == (PACKET_POOL_MINSIZE << index))
+		{
+			SimpleThreadLock lock(m_mutex[index]);
+			if (m_freeCount[index] < PACKET_POOL_DEPTH)
+			{
+				m_free[index][m_freeCount[index]++] = buffer;
+				return;
+			}
+		}
+	}
+
+	delete[] buffer;
+}
+
+
+/***************************************************************************
+ *
+ *
+ *	class Packet				Base packet class for both sending/receiving
+ *
+ *
+ ***************************************************************************/
+Packet::Packet(size_t size, size_t capacity) : m_buffer(NULL), m_capacity(0)
 {
 	m_expectedLength = size;
 	clear();
+	if (capacity > 0)
+		reserve(capacity);
 	resize(size > 0 ? size : PACKET_BUFFERDEFAULT);
 }
 
-Packet::Packet(const Packet& other) : m_buffer(NULL)
+Packet::Packet(const Packet& other) : m_buffer(NULL), m_capacity(0)
 {
 	clear();
 	copy(other);
 }
 
-Packet::Packet(const BYTE* data, size_t size) : m_buffer(NULL)
+Packet::Packet(const BYTE* data, size_t size) : m_buffer(NULL), m_capacity(0)
 {
 	clear();
 	m_expectedLength = 0;
@@ -77,11 +157,12 @@ void Packet::clear(void)
 {
 	if (m_buffer != NULL)
 	{
-		delete[] m_buffer;
+		g_PacketBufferPool.release(m_buffer, m_capacity);
 		m_buffer = NULL;
 	}
 
 	m_bufferSize = 0;
+	m_capacity = 0;
 	m_position = 0;
 }
 
@@ -108,14 +189,9 @@ void Packet::resize(size_t newsize)
 	ASSERT(newsize > 0);
 	if ( newsize > m_bufferSize )		// increase buffer, copying the contents
 	{
-		BYTE* buffer = new BYTE[newsize];
-		if (m_buffer != NULL)
-		{
-			memcpy(buffer, m_buffer, m_bufferSize);
-			delete[] m_buffer;
-		}
-		
-		m_buffer = buffer;
+		if ( newsize > m_capacity )
+			reserve(newsize);
+
 		m_bufferSize = newsize;
 		m_length = m_bufferSize;
 	}
@@ -125,6 +201,22 @@ void Packet::resize(size_t newsize)
 	seek();
 }
 
+void Packet::reserve(size_t capacity)
+{
+	if (capacity <= m_capacity)
+		return;
+
+	BYTE* buffer = g_PacketBufferPool.allocate(capacity);
+	if (m_buffer != NULL)
+	{
+		memcpy(buffer, m_buffer, m_bufferSize);
+		g_PacketBufferPool.release(m_buffer, m_capacity);
+	}
+
+	m_buffer = buffer;
+	m_capacity = capacity;
+}
+
 void Packet::seek(size_t pos)
 {
 	ASSERT(pos <= m_length);
@@ -620,6 +712,16 @@ void Packet::trim(void)
 		m_length = m_position;
 }
 
+void Packet::compact(void)
+{
+	size_t remaining = m_length > m_position ? m_length - m_position : 0;
+	if (remaining > 0 && m_position > 0)
+		memmove(m_buffer, &m_buffer[m_position], remaining);
+
+	m_length = remaining;
+	m_position = 0;
+}
+
 bool Packet::readBool(void)
 {
 	if ((m_position + sizeof(BYTE)) > m_length)
@@ -1116,6 +1218,69 @@ bool Packet::onReceive(NetState* client)
 }
 
 
+/***************************************************************************
+ *
+ *
+ *	class PacketCompressed		Compressed data shared by the copies of a sent packet
+ *
+ *
+ ***************************************************************************/
+PacketCompressed::PacketCompressed(const BYTE* data, size_t length)
+	: m_compressed(NULL), m_compressedLength(0), m_references(1)
+{
+	m_sourceLength = length;
+	m_source = new BYTE[length];
+	memcpy(m_source, data, length);
+}
+
+PacketCompressed::~PacketCompressed(void)
+{
+	delete[] m_source;
+	if (m_compressed != NULL)
+		delete[] m_compressed;
+}
+
+bool PacketCompressed::matches(const BYTE* data, size_t length) const
+{
+	return length == m_sourceLength && memcmp(m_source, data, length) == 0;
+}
+
+const BYTE* PacketCompressed::compress(BYTE* buffer, size_t& length)
+{
+	ADDTOCALLSTACK("PacketCompressed::compress");
+
+	SimpleThreadLock lock(m_mutex);
+	if (m_compressed == NULL)
+	{
+		// first client to send this, compress into their buffer and keep a copy
+		m_compressedLength = CClient::xCompress(buffer, m_source, m_sourceLength);
+		m_compressed = new BYTE[m_compressedLength];
+		memcpy(m_compressed, buffer, m_compressedLength);
+	}
+
+	length = m_compressedLength;
+	return m_compressed;
+}
+
+void PacketCompressed::retain(void)
+{
+	SimpleThreadLock lock(m_mutex);
+	m_references++;
+}
+
+void PacketCompressed::release(void)
+{
+	bool fDelete;
+	{
+		SimpleThreadLock lock(m_mutex);
+		fDelete = (--m_references <= 0);
+	}
+
+	if (fDelete)
+		delete this;
+}
+
+
 /***************************************************************************
  *
  *
@@ -1123,8 +1288,8 @@ bool Packet::onReceive(NetState* client)
  *
  *
  ***************************************************************************/
-PacketSend::PacketSend(BYTE id, size_t len, Priority priority)
-	: m_priority(priority), m_target(NULL), m_lengthPosition(0)
+PacketSend::PacketSend(BYTE id, size_t len, Priority priority, size_t capacity)
+	: Packet(static_cast<size_t>(0), maximum(len, capacity)), m_priority(priority), m_target(NULL), m_lengthPosition(0), m_sendCount(0), m_compressed(NULL)
 {
 	if (len > 0)
 		resize(len);
@@ -1132,13 +1297,23 @@ PacketSend::PacketSend(BYTE id, size_t len, Priority priority)
 	writeByte(id);
 }
 
-PacketSend::PacketSend(const PacketSend *other)
+PacketSend::PacketSend(const PacketSend *other) : Packet(static_cast<size_t>(0), other->getLength())
 {
 	copy(*other);
 	m_target = other->m_target;
 	m_priority = other->m_priority;
 	m_lengthPosition = other->m_lengthPosition;
 	m_position = other->m_position;
+	m_sendCount = 0;
+	m_compressed = other->m_compressed;
+	if (m_compressed != NULL)
+		m_compressed->retain();
+}
+
+PacketSend::~PacketSend()
+{
+	if (m_compressed != NULL)
+		m_compressed->release();
 }
 
 void PacketSend::initLength(void)
@@ -1164,6 +1339,32 @@ void PacketSend::fixLength()
 	}
 }
 
+void PacketSend::shareCompressed(void)
+{
+	ADDTOCALLSTACK("PacketSend::shareCompressed");
+
+	// only game clients use compression
+	const CClient* client = m_target->m_client;
+	if (client == NULL || client->GetConnectType() != CONNECT_GAME)
+		return;
+
+	// a packet sent once compresses for its client, from the second
+	// send on the copies share a single compressed form
+	if (m_sendCount++ == 0)
+		return;
+
+	if (m_compressed != NULL)
+	{
+		if (m_compressed->matches(m_buffer, m_length))
+			return;
+
+		// packet has been changed since the last send
+		m_compressed->release();
+	}
+
+	m_compressed = new PacketCompressed(m_buffer, m_length);
+}
+
 PacketSend* PacketSend::clone(void) const
 {
 	return new PacketSend(this);
@@ -1184,6 +1385,9 @@ void PacketSend::send(const CClient *client, bool appendTransaction)
 	if (sync() > NETWORK_MAXPACKETLEN)
 		return;
 
+	shareCompressed();
+
+	CSectorTickLock lock;
 #ifndef _MTNETWORK
 	g_NetworkOut.schedule(this, appendTransaction);
 #else
@@ -1215,6 +1419,7 @@ void PacketSend::push(const CClient *client, bool appendTransaction)
 		return;
 	}
 
+	CSectorTickLock lock;
 #ifndef _MTNETWORK
 	g_NetworkOut.scheduleOnce(this, appendTransaction);
 #else
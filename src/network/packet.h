@@ -11,6 +11,42 @@ class SimplePacketTransaction;
 #define PACKET_BUFFERDEFAULT 4
 #define PACKET_BUFFERGROWTH 4
 
+#define PACKET_POOL_MINSIZE 16u		// smallest buffer size class (power of 2)
+#define PACKET_POOL_CLASSES 13		// buffer size classes (16 bytes to 64KB)
+#define PACKET_POOL_DEPTH 32		// free buffers kept per size class
+
+/***************************************************************************
+ *
+ *
+ *	class PacketBufferPool		Recycles packet buffers by power of 2 size classes
+ *
+ *
+ ***************************************************************************/
+class PacketBufferPool
+{
+private:
+	BYTE* m_free[PACKET_POOL_CLASSES][PACKET_POOL_DEPTH];	// free buffers of each size class
+	size_t m_freeCount[PACKET_POOL_CLASSES];				// number of free buffers of each size class
+	SimpleMutex m_mutex[PACKET_POOL_CLASSES];
+
+public:
+	PacketBufferPool(void);
+	~PacketBufferPool(void);
+
+private:
+	PacketBufferPool(const PacketBufferPool& copy);
+	PacketBufferPool& operator=(const PacketBufferPool& other);
+
+public:
+	BYTE* allocate(size_t& size); // get a buffer of at least size bytes, size is set to the real buffer size
+	void release(BYTE* buffer, size_t size); // give back a buffer of real size bytes
+
+private:
+	static size_t getClass(size_t size); // get size class index (PACKET_POOL_CLASSES = not pooled)
+};
+
+extern PacketBufferPool g_PacketBufferPool;
+
 /***************************************************************************
  *
  *
@@ -23,13 +59,14 @@ class Packet
 protected:
 	BYTE* m_buffer;				// raw data
 	size_t m_bufferSize;		// size of raw data
+	size_t m_capacity;			// allocated size of m_buffer
 
 	size_t m_length;			// length of packet
 	size_t m_position;			// current position in packet
 	size_t m_expectedLength;	// expected length of this packet (0 = dynamic)
 
 public:
-	explicit Packet(size_t size = 0);
+	explicit Packet(size_t size = 0, size_t capacity = 0);
 	Packet(const Packet& other);
 	Packet(const BYTE* data, size_t size);
 	virtual ~Packet(void);
@@ -48,6 +85,7 @@ public:
 
 	void expand(size_t size = 0); // expand packet (resize whilst maintaining position)
 	void resize(size_t newsize); // resize packet
+	void reserve(size_t capacity); // allocate room for capacity bytes without changing the length
 	void seek(size_t pos = 0); // seek to position
 	void skip(long count = 1); // skip count bytes
 
@@ -80,6 +118,7 @@ public:
 	void fill(void); // zeroes remaining buffer
 	size_t sync(void);
 	void trim(void); // trim packet length down to current position
+	void compact(void); // move the data from the current position to the start of the packet
 
 	// read
 	bool readBool(void); // read boolean (1 byte)
@@ -113,6 +152,40 @@ protected:
 };
 
 
+/***************************************************************************
+ *
+ *
+ *	class PacketCompressed		Compressed data shared by the copies of a sent packet
+ *
+ *
+ ***************************************************************************/
+class PacketCompressed
+{
+private:
+	BYTE* m_source;				// packet data the compressed form is made from
+	size_t m_sourceLength;		// length of packet data
+	BYTE* m_compressed;			// compressed data (NULL = not compressed yet)
+	size_t m_compressedLength;	// length of compressed data
+	long m_references;			// packets sharing this
+	SimpleMutex m_mutex;
+
+public:
+	PacketCompressed(const BYTE* data, size_t length);
+
+private:
+	~PacketCompressed(void);
+	PacketCompressed(const PacketCompressed& copy);
+	PacketCompressed& operator=(const PacketCompressed& other);
+
+public:
+	bool matches(const BYTE* data, size_t length) const; // check if made from this data
+	const BYTE* compress(BYTE* buffer, size_t& length); // get compressed data, buffer = scratch space for the first compression
+
+	void retain(void); // add a reference
+	void release(void); // remove a reference, deletes on the last one
+};
+
+
 /***************************************************************************
  *
  *
@@ -137,11 +210,13 @@ protected:
 	long m_priority; // packet priority
 	NetState* m_target; // selected network target for this packet
 	size_t m_lengthPosition; // position of length-byte
+	long m_sendCount; // number of times this packet has been sent
+	PacketCompressed* m_compressed; // compressed data shared with the sent copies
 
 public:
-	explicit PacketSend(BYTE id, size_t len = 0, Priority priority = PRI_NORMAL);
+	explicit PacketSend(BYTE id, size_t len = 0, Priority priority = PRI_NORMAL, size_t capacity = 0);
 	PacketSend(const PacketSend* other);
-	virtual ~PacketSend() { };
+	virtual ~PacketSend();
 
 private:
 	PacketSend& operator=(const PacketSend& other);
@@ -156,6 +231,7 @@ public:
 
 	long getPriority() const { return m_priority; }; // get packet priority
 	NetState* getTarget() const { return m_target; }; // get target state
+	PacketCompressed* getCompressed() const { return m_compressed; }; // get shared compressed data (NULL = compress for this client)
 
 	virtual bool onSend(const CClient* client);
 	virtual void onSent(CClient* client);
@@ -170,6 +246,7 @@ public:
 
 protected:
 	void fixLength(); // write correct packet length to it's slot
+	void shareCompressed(void); // share compressed data between the copies of a packet sent to several clients
 	virtual PacketSend* clone(void) const;
 };
 
@@ -893,7 +893,7 @@ size_t PacketDeathStatus::getExpectedLength(NetState* net, Packet* packet)
 	// different size depending on client
 	size_t pos = packet->getPosition();
 	packet->skip(1);
-	DEATH_MODE_TYPE mode = static_cast<DEATH_MODE_TYPE>(readByte());
+	DEATH_MODE_TYPE mode = static_cast<DEATH_MODE_TYPE>(packet->readByte());
 	packet->seek(pos);
 
 	if (mode != DEATH_MODE_MANIFEST)
@@ -1063,7 +1063,7 @@ PacketCloseVendor::PacketCloseVendor(const CClient* target, const CChar* vendor)
  *
  *
  ***************************************************************************/
-PacketItemContents::PacketItemContents(CClient* target, const CItemContainer* container, bool isShop, bool filterLayers) : PacketSend(XCMD_Content, 5, PRI_NORMAL), m_container(container->GetUID())
+PacketItemContents::PacketItemContents(CClient* target, const CItemContainer* container, bool isShop, bool filterLayers) : PacketSend(XCMD_Content, 5, PRI_NORMAL, 5 + (minimum(container->CGObList::GetCount(), static_cast<size_t>(MAX_ITEMS_CONT)) * 20)), m_container(container->GetUID())
 {
 	ADDTOCALLSTACK("PacketItemContents::PacketItemContents");
 
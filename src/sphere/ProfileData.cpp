@@ -206,3 +206,260 @@ ProfileTask::~ProfileTask(void)
 	if (m_context != NULL)
 		m_context->m_profile.Start(m_previousTask);
 }
+
+//
+// ScopeProfiler
+//
+volatile int ScopeProfiler::sm_iMode = 0;
+volatile DWORD ScopeProfiler::sm_dwClear = 0;
+
+ScopeProfiler::ScopeProfiler() : m_pSlots(NULL), m_dwSlotMask(0), m_iDepth(0), m_pEvents(NULL), m_iEvents(0), m_dwClear(0)
+{
+}
+
+ScopeProfiler::~ScopeProfiler()
+{
+	delete[] m_pSlots;
+	delete[] m_pEvents;
+}
+
+ULONGLONG ScopeProfiler::GetTime()
+{
+	// Current time in usec.
+#ifdef _WIN32
+	LARGE_INTEGER llTicks;
+	if ( !QueryPerformanceCounter(&llTicks) )
+		return GetTickCount64() * 1000;
+	ULONGLONG llCount = static_cast<ULONGLONG>(llTicks.QuadPart);
+	return ((llCount / llTimeProfileFrequency) * 1000000) + (((llCount % llTimeProfileFrequency) * 1000000) / llTimeProfileFrequency);
+#else
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (static_cast<ULONGLONG>(ts.tv_sec) * 1000000) + (ts.tv_nsec / 1000);
+#endif
+}
+
+void ScopeProfiler::Clear()
+{
+	// Only from the owner thread, with no scope open.
+	SimpleThreadLock lock(m_mutex);
+	m_Recs.clear();
+	if ( m_pSlots != NULL )
+		memset(m_pSlots, 0xFF, (m_dwSlotMask + 1) * sizeof(DWORD));
+	m_iEvents = 0;
+	m_dwClear = sm_dwClear;
+}
+
+DWORD ScopeProfiler::FindRec(DWORD dwHash, DWORD dwParent, LPCTSTR pszName)
+{
+	if ( m_pSlots != NULL )
+	{
+		for ( DWORD i = dwHash & m_dwSlotMask; m_pSlots[i] != PROFILESCOPE_NONE; i = (i + 1) & m_dwSlotMask )
+		{
+			const ScopeRec &rec = m_Recs[m_pSlots[i]];
+			if ( rec.m_dwHash == dwHash && rec.m_dwParent == dwParent && !strcmp(rec.m_szName, pszName) )
+				return m_pSlots[i];
+		}
+	}
+
+	// First time this scope is seen here.
+	SimpleThreadLock lock(m_mutex);
+	if ( (m_Recs.size() + 1) * 2 > m_dwSlotMask )
+	{
+		DWORD dwSlots = (m_dwSlotMask + 1) * 2;
+		if ( dwSlots < 64 )
+			dwSlots = 64;
+
+		delete[] m_pSlots;
+		m_pSlots = new DWORD[dwSlots];
+		memset(m_pSlots, 0xFF, dwSlots * sizeof(DWORD));
+		m_dwSlotMask = dwSlots - 1;
+		for ( size_t j = 0; j < m_Recs.size(); ++j )
+		{
+			DWORD i = m_Recs[j].m_dwHash & m_dwSlotMask;
+			while ( m_pSlots[i] != PROFILESCOPE_NONE )
+				i = (i + 1) & m_dwSlotMask;
+			m_pSlots[i] = static_cast<DWORD>(j);
+		}
+	}
+
+	ScopeRec rec;
+	rec.m_dwHash = dwHash;
+	rec.m_dwParent = dwParent;
+	rec.m_dwCount = 0;
+	rec.m_llTotal = 0;
+	rec.m_llChild = 0;
+	strcpylen(rec.m_szName, pszName, COUNTOF(rec.m_szName));
+	m_Recs.push_back(rec);
+
+	DWORD dwRec = static_cast<DWORD>(m_Recs.size() - 1);
+	DWORD i = dwHash & m_dwSlotMask;
+	while ( m_pSlots[i] != PROFILESCOPE_NONE )
+		i = (i + 1) & m_dwSlotMask;
+	m_pSlots[i] = dwRec;
+	return dwRec;
+}
+
+bool ScopeProfiler::Enter(LPCTSTR pszName, LPCTSTR pszDetail, DWORD dwId)
+{
+	if ( m_iDepth == 0 && m_dwClear != sm_dwClear )
+		Clear();
+	if ( m_iDepth >= PROFILESCOPE_DEPTH )
+		return false;
+
+	TCHAR szName[PROFILESCOPE_NAME];
+	size_t iLen = 0;
+	for ( ; *pszName != '\0' && iLen < COUNTOF(szName) - 1; ++pszName )
+		szName[iLen++] = *pszName;
+	if ( pszDetail != NULL && *pszDetail != '\0' && iLen < COUNTOF(szName) - 2 )
+	{
+		szName[iLen++] = ' ';
+		for ( ; *pszDetail != '\0' && iLen < COUNTOF(szName) - 1; ++pszDetail )
+			szName[iLen++] = *pszDetail;
+	}
+	szName[iLen] = '\0';
+	if ( dwId != PROFILESCOPE_NONE && iLen < COUNTOF(szName) - 12 )
+		sprintf(szName + iLen, " 0x%02lx", dwId);
+
+	// FNV-1a of the name, mixed with the parent so the same scope under different parents is kept apart.
+	DWORD dwParent = (m_iDepth > 0) ? m_Stack[m_iDepth - 1].m_dwRec : PROFILESCOPE_NONE;
+	DWORD dwHash = 2166136261U;
+	for ( LPCTSTR pch = szName; *pch != '\0'; ++pch )
+		dwHash = (dwHash ^ static_cast<BYTE>(*pch)) * 16777619U;
+	dwHash ^= (dwParent + 1) * 2654435761U;
+
+	ScopeFrame &frame = m_Stack[m_iDepth];
+	frame.m_dwRec = FindRec(dwHash, dwParent, szName);
+	frame.m_llStart = GetTime();
+	++m_iDepth;
+	return true;
+}
+
+void ScopeProfiler::Leave()
+{
+	if ( m_iDepth == 0 )
+		return;
+
+	--m_iDepth;
+	const ScopeFrame &frame = m_Stack[m_iDepth];
+	ULONGLONG llDuration = GetTime() - frame.m_llStart;
+
+	ScopeRec &rec = m_Recs[frame.m_dwRec];
+	rec.m_dwCount++;
+	rec.m_llTotal += llDuration;
+	if ( m_iDepth > 0 )
+		m_Recs[m_Stack[m_iDepth - 1].m_dwRec].m_llChild += llDuration;
+
+	if ( sm_iMode >= 2 )
+	{
+		if ( m_pEvents == NULL )
+			m_pEvents = new ScopeEvent[PROFILESCOPE_EVENTS];
+
+		ScopeEvent &event = m_pEvents[m_iEvents % PROFILESCOPE_EVENTS];
+		event.m_dwRec = frame.m_dwRec;
+		event.m_llStart = frame.m_llStart;
+		event.m_llDuration = llDuration;
+		++m_iEvents;
+	}
+}
+
+static void ScopeProfiler_CopyName(TCHAR *pszDest, LPCTSTR pszName)
+{
+	// Keep the name usable in both output formats. (';' separates folded frames)
+	for ( ; *pszName != '\0'; ++pszName, ++pszDest )
+	{
+		TCHAR ch = *pszName;
+		*pszDest = (ch == ';' || ch == '"' || ch == '\\' || static_cast<BYTE>(ch) < ' ') ? '_' : ch;
+	}
+	*pszDest = '\0';
+}
+
+void ScopeProfiler::WriteFolded(CFileText *pFile, LPCTSTR pszThread)
+{
+	// One line per scope: "thread;outer;...;scope <usec spent in the scope itself>"
+	SimpleThreadLock lock(m_mutex);
+	TCHAR szLine[(PROFILESCOPE_DEPTH + 1) * PROFILESCOPE_NAME];
+	DWORD dwPath[PROFILESCOPE_DEPTH];
+
+	for ( size_t i = 0; i < m_Recs.size(); ++i )
+	{
+		const ScopeRec &rec = m_Recs[i];
+		if ( rec.m_llTotal <= rec.m_llChild )
+			continue;
+
+		size_t iPath = 0;
+		for ( DWORD dwRec = static_cast<DWORD>(i); dwRec != PROFILESCOPE_NONE && iPath < PROFILESCOPE_DEPTH; dwRec = m_Recs[dwRec].m_dwParent )
+			dwPath[iPath++] = dwRec;
+
+		size_t iLen = strcpylen(szLine, pszThread, PROFILESCOPE_NAME);
+		while ( iPath > 0 )
+		{
+			szLine[iLen++] = ';';
+			ScopeProfiler_CopyName(szLine + iLen, m_Recs[dwPath[--iPath]].m_szName);
+			iLen += strlen(szLine + iLen);
+		}
+		pFile->Printf("%s %llu\n", szLine, rec.m_llTotal - rec.m_llChild);
+	}
+}
+
+void ScopeProfiler::WriteTrace(CFileText *pFile, unsigned int uThreadId, bool &fFirst)
+{
+	// Chrome trace "complete" events of the last scopes left.
+	SimpleThreadLock lock(m_mutex);
+	if ( m_pEvents == NULL )
+		return;
+
+	TCHAR szName[PROFILESCOPE_NAME];
+	size_t iFirst = (m_iEvents > PROFILESCOPE_EVENTS) ? m_iEvents - PROFILESCOPE_EVENTS : 0;
+	for ( size_t i = iFirst; i < m_iEvents; ++i )
+	{
+		const ScopeEvent &event = m_pEvents[i % PROFILESCOPE_EVENTS];
+		if ( event.m_dwRec >= m_Recs.size() )
+			continue;
+
+		ScopeProfiler_CopyName(szName, m_Recs[event.m_dwRec].m_szName);
+		pFile->Printf("%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%llu,\"pid\":1,\"tid\":%u}", fFirst ? "\n" : ",\n", szName, event.m_llStart, event.m_llDuration, uThreadId);
+		fFirst = false;
+	}
+}
+
+bool ScopeProfiler::Export(LPCTSTR pszFolded, LPCTSTR pszTrace)
+{
+	// Dump the scopes of every thread, as folded stacks (flamegraph.pl, speedscope)
+	// and as a Chrome trace (chrome://tracing, Perfetto).
+	CFileText fileFolded;
+	if ( !fileFolded.Open(pszFolded, OF_CREATE|OF_TEXT) )
+		return false;
+
+	CFileText fileTrace;
+	if ( !fileTrace.Open(pszTrace, OF_CREATE|OF_TEXT) )
+		return false;
+
+	fileTrace.Printf("{\"traceEvents\":[");
+	bool fFirst = true;
+
+	AbstractSphereThread *pDummy = DummySphereThread::getInstance();
+	size_t iThreadCount = ThreadHolder::getActiveThreads();
+	for ( size_t i = 0; i <= iThreadCount; ++i )
+	{
+		AbstractSphereThread *pThread = (i < iThreadCount) ? static_cast<AbstractSphereThread *>(ThreadHolder::getThreadAt(i)) : pDummy;
+		if ( pThread == NULL || (i < iThreadCount && pThread == pDummy) )
+			continue;
+
+		pThread->m_scopes.WriteFolded(&fileFolded, pThread->getName());
+		pThread->m_scopes.WriteTrace(&fileTrace, pThread->getId(), fFirst);
+	}
+
+	fileTrace.Printf("\n],\"displayTimeUnit\":\"ms\"}\n");
+	return true;
+}
+
+//
+// ProfileScope
+//
+void ProfileScope::Start(LPCTSTR pszName, LPCTSTR pszDetail, DWORD dwId)
+{
+	ScopeProfiler *pProfiler = &static_cast<AbstractSphereThread *>(ThreadHolder::current())->m_scopes;
+	if ( pProfiler->Enter(pszName, pszDetail, dwId) )
+		m_profiler = pProfiler;
+}
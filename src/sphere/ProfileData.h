@@ -2,6 +2,9 @@
 #define PROFILEDATA_H
 #pragma once
 
+#include "mutex.h"
+#include <vector>
+
 enum PROFILE_TYPE
 {
 	PROFILE_IDLE,		// Wait for stuff.
@@ -90,4 +93,103 @@ private:
 	ProfileTask& operator=(const ProfileTask& other);
 };
 
+// Nested named scopes (sector tick, packet 0x02, @Timer c_ogre, ...) timed in usec,
+// each thread keeps its own tree of them. Toggled with the PROFILESCOPES server verb.
+#define PROFILESCOPE_DEPTH		64			// deeper scopes are not recorded
+#define PROFILESCOPE_NAME		64			// name and detail of a scope
+#define PROFILESCOPE_EVENTS		0x10000		// trace events kept per thread (mode 2)
+#define PROFILESCOPE_NONE		0xFFFFFFFF
+
+class CFileText;
+
+class ScopeProfiler
+{
+public:
+	static volatile int sm_iMode;		// 0=off, 1=scope totals, 2=scope totals and trace events
+	static volatile DWORD sm_dwClear;	// bumped to clear the scopes of every thread
+
+private:
+	struct ScopeRec
+	{
+		DWORD m_dwHash;			// hash of the name and the parent
+		DWORD m_dwParent;		// enclosing scope, PROFILESCOPE_NONE at the top
+		DWORD m_dwCount;		// times entered
+		ULONGLONG m_llTotal;	// time spent inside
+		ULONGLONG m_llChild;	// time spent in nested scopes
+		TCHAR m_szName[PROFILESCOPE_NAME];
+	};
+
+	struct ScopeFrame
+	{
+		DWORD m_dwRec;
+		ULONGLONG m_llStart;
+	};
+
+	struct ScopeEvent
+	{
+		DWORD m_dwRec;
+		ULONGLONG m_llStart;
+		ULONGLONG m_llDuration;
+	};
+
+	std::vector<ScopeRec> m_Recs;
+	DWORD *m_pSlots;			// open addressing index of m_Recs
+	DWORD m_dwSlotMask;
+	ScopeFrame m_Stack[PROFILESCOPE_DEPTH];
+	size_t m_iDepth;
+	ScopeEvent *m_pEvents;		// ring of the last PROFILESCOPE_EVENTS scopes left
+	size_t m_iEvents;			// events recorded so far
+	DWORD m_dwClear;
+	SimpleMutex m_mutex;		// m_Recs only grows (and is only read by others) under it
+
+public:
+	ScopeProfiler();
+	~ScopeProfiler();
+
+private:
+	ScopeProfiler(const ScopeProfiler& copy);
+	ScopeProfiler& operator=(const ScopeProfiler& other);
+
+	DWORD FindRec(DWORD dwHash, DWORD dwParent, LPCTSTR pszName);
+	void Clear();
+
+public:
+	static ULONGLONG GetTime();
+	static bool Export(LPCTSTR pszFolded, LPCTSTR pszTrace);
+
+	bool Enter(LPCTSTR pszName, LPCTSTR pszDetail, DWORD dwId);
+	void Leave();
+	void WriteFolded(CFileText *pFile, LPCTSTR pszThread);
+	void WriteTrace(CFileText *pFile, unsigned int uThreadId, bool &fFirst);
+};
+
+class ProfileScope
+{
+private:
+	ScopeProfiler* m_profiler;
+
+public:
+	explicit ProfileScope(LPCTSTR pszName, LPCTSTR pszDetail = NULL) : m_profiler(NULL)
+	{
+		if ( ScopeProfiler::sm_iMode )
+			Start(pszName, pszDetail, PROFILESCOPE_NONE);
+	}
+	ProfileScope(LPCTSTR pszName, DWORD dwId) : m_profiler(NULL)
+	{
+		if ( ScopeProfiler::sm_iMode )
+			Start(pszName, NULL, dwId);
+	}
+	~ProfileScope(void)
+	{
+		if ( m_profiler != NULL )
+			m_profiler->Leave();
+	}
+
+private:
+	ProfileScope(const ProfileScope& copy);
+	ProfileScope& operator=(const ProfileScope& other);
+
+	void Start(LPCTSTR pszName, LPCTSTR pszDetail, DWORD dwId);
+};
+
 #endif // PROFILEDATA_H
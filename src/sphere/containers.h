@@ -2,27 +2,70 @@
 #define __CONTAINERS_H__
 #pragma once
 
+#include <stdint.h>
+
+#define CACHELINE_SIZE 64	// keep reader and writer fields on separate cache lines
+#define THREADSAFEQUEUE_CHUNK 64	// elements per ring of a ThreadSafeQueue (power of two)
+
+// acquire/release access to indices shared between threads
+#ifdef _WIN32
+	// msvc gives volatile accesses acquire/release semantics
+	inline size_t AtomicLoadAcquire(const volatile size_t* value) { return *value; }
+	inline void AtomicStoreRelease(volatile size_t* value, size_t newValue) { *value = newValue; }
+	inline bool AtomicCompareExchange(volatile size_t* value, size_t expected, size_t newValue)
+	{
+		return InterlockedCompareExchangePointer(reinterpret_cast<PVOID volatile*>(value), reinterpret_cast<PVOID>(newValue), reinterpret_cast<PVOID>(expected)) == reinterpret_cast<PVOID>(expected);
+	}
+#else
+	inline size_t AtomicLoadAcquire(const volatile size_t* value) { return __atomic_load_n(value, __ATOMIC_ACQUIRE); }
+	inline void AtomicStoreRelease(volatile size_t* value, size_t newValue) { __atomic_store_n(value, newValue, __ATOMIC_RELEASE); }
+	inline bool AtomicCompareExchange(volatile size_t* value, size_t expected, size_t newValue)
+	{
+		return __atomic_compare_exchange_n(value, &expected, newValue, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+	}
+#endif
+
 // a thread-safe implementation of a queue container that doesn't use any locks
 // this only works as long as there is only a single reader thread and writer thread
+// (writers on different threads must be serialised by a lock)
+// elements are stored in fixed size rings, chained as the writer fills them
 template<class T>
 class ThreadSafeQueue
 {
-public:
-	typedef std::list<T> list;
-	typedef typename std::list<T>::iterator iterator;
-	typedef typename std::list<T>::const_iterator const_iterator;
-
 private:
-	list m_list;
-	iterator m_head;
-	iterator m_tail;
+	struct Chunk
+	{
+		T m_items[THREADSAFEQUEUE_CHUNK];
+		Chunk* m_next;	// published to the reader through m_pushed
+	};
+
+	// reader
+	Chunk* m_readChunk;
+	size_t m_readIndex;
+	volatile size_t m_popped;
+	char m_readPadding[CACHELINE_SIZE];
+
+	// writer
+	Chunk* m_writeChunk;
+	size_t m_writeIndex;
+	volatile size_t m_pushed;
+	char m_writePadding[CACHELINE_SIZE];
 
 public:
-	ThreadSafeQueue()
+	ThreadSafeQueue() : m_readIndex(0), m_popped(0), m_writeIndex(0), m_pushed(0)
 	{
-		m_list.push_back(T()); // at least one element must be in the queue
-		m_head = m_list.begin();
-		m_tail = m_list.end();
+		m_readChunk = m_writeChunk = new Chunk;
+		m_readChunk->m_next = NULL;
+	}
+
+	~ThreadSafeQueue()
+	{
+		while (m_readChunk != NULL)
+		{
+			Chunk* next = m_readChunk->m_next;
+			delete m_readChunk;
+			m_readChunk = next;
+		}
 	}
 
 private:
@@ -33,42 +76,150 @@ public:
 	// Append an element to the end of the queue (writer)
 	void push(const T& value)
 	{
-		m_list.push_back(value);
-		m_tail = m_list.end();
-		clean();
-	}
+		if (m_writeIndex == THREADSAFEQUEUE_CHUNK)
+		{
+			// ring is full, chain a new one
+			Chunk* chunk = new Chunk;
+			chunk->m_next = NULL;
+			m_writeChunk->m_next = chunk;
+			m_writeChunk = chunk;
+			m_writeIndex = 0;
+		}
 
-	// Erase elements from before reader head (writer)
-	void clean(void)
-	{
-		m_list.erase(m_list.begin(), m_head);
+		m_writeChunk->m_items[m_writeIndex++] = value;
+		AtomicStoreRelease(&m_pushed, m_pushed + 1);
 	}
 
 	// Retrieve the number of elements in the queue (reader/writer)
 	size_t size(void) const
+	{
+		return AtomicLoadAcquire(&m_pushed) - AtomicLoadAcquire(&m_popped);
+	}
+
+	// Determine if the queue is empty (reader/writer)
+	bool empty(void) const
+	{
+		return size() == 0;
+	}
+
+	// Remove the first element from the queue (reader)
+	void pop(void)
 	{
 		if (empty())
-			return 0;
+			throw CException(LOGL_ERROR, 0, "No elements to read from queue.");
 
-		size_t toSkip = 1;
-		for (const_iterator it = m_list.begin(); it != m_head && it != m_list.end(); ++it)
-		{
-			if (it == m_list.end())
-				break;
+		nextChunk();
+		m_readIndex++;
+		AtomicStoreRelease(&m_popped, m_popped + 1);
+	}
+
+	// Retrieve the first element in the queue (reader)
+	T front(void)
+	{
+		if (empty())
+			throw CException(LOGL_ERROR, 0, "No elements to read from queue.");
+
+		nextChunk();
+		return m_readChunk->m_items[m_readIndex];
+	}
+
+private:
+	// Move on to the next ring once this one has been read (reader)
+	void nextChunk(void)
+	{
+		if (m_readIndex < THREADSAFEQUEUE_CHUNK)
+			return;
+
+		// an element is waiting, so the writer has chained the next ring
+		Chunk* next = m_readChunk->m_next;
+		delete m_readChunk;
+		m_readChunk = next;
+		m_readIndex = 0;
+	}
+};
 
-			toSkip++;
+// a bounded lock-free queue for multiple writer threads and a single reader thread
+// each cell carries a sequence number telling whether it is free, written or read
+template<class T>
+class ThreadSafeRing
+{
+private:
+	struct Cell
+	{
+		volatile size_t m_sequence;
+		T m_value;
+	};
+
+	Cell* m_cells;
+	size_t m_mask;
+	char m_padding[CACHELINE_SIZE];
+	volatile size_t m_writePos;	// next cell to claim (writers)
+	char m_writePadding[CACHELINE_SIZE];
+	volatile size_t m_readPos;	// next cell to read (reader)
+	char m_readPadding[CACHELINE_SIZE];
+
+public:
+	explicit ThreadSafeRing(size_t capacity) : m_writePos(0), m_readPos(0)
+	{
+		// round up to a power of two
+		size_t size = 2;
+		while (size < capacity)
+			size <<= 1;
+
+		m_cells = new Cell[size];
+		m_mask = size - 1;
+		for (size_t i = 0; i < size; ++i)
+			m_cells[i].m_sequence = i;
+	}
+
+	~ThreadSafeRing()
+	{
+		delete[] m_cells;
+	}
+
+private:
+	ThreadSafeRing(const ThreadSafeRing& copy);
+	ThreadSafeRing& operator=(const ThreadSafeRing& other);
+
+public:
+	// Append an element to the end of the queue, false if the queue is full (writers)
+	bool push(const T& value)
+	{
+		size_t pos = AtomicLoadAcquire(&m_writePos);
+		Cell* cell;
+		for (;;)
+		{
+			cell = &m_cells[pos & m_mask];
+			size_t sequence = AtomicLoadAcquire(&cell->m_sequence);
+			if (sequence == pos)
+			{
+				// cell is free, claim it
+				if (AtomicCompareExchange(&m_writePos, pos, pos + 1))
+					break;
+			}
+			else if (static_cast<intptr_t>(sequence - pos) < 0)
+			{
+				// cell hasn't been read yet (signed difference, the counters wrap)
+				return false;
+			}
+			pos = AtomicLoadAcquire(&m_writePos);
 		}
 
-		return m_list.size() - toSkip;
+		cell->m_value = value;
+		AtomicStoreRelease(&cell->m_sequence, pos + 1);
+		return true;
 	}
 
-	// Determine if the queue is empty (reader/writer)
-	bool empty(void) const
+	// Retrieve the number of elements in the queue, including those being written (reader/writers)
+	size_t size(void) const
 	{
-		iterator next = m_head;
-		++next;
+		return AtomicLoadAcquire(&m_writePos) - AtomicLoadAcquire(&m_readPos);
+	}
 
-		return (next == m_tail);
+	// Determine if the queue is empty (reader)
+	bool empty(void) const
+	{
+		return AtomicLoadAcquire(&m_cells[m_readPos & m_mask].m_sequence) != m_readPos + 1;
 	}
 
 	// Remove the first element from the queue (reader)
@@ -77,27 +228,18 @@ public:
 		if (empty())
 			throw CException(LOGL_ERROR, 0, "No elements to read from queue.");
 
-		iterator next = m_head;
-		++next;
-
-		if (next != m_tail)
-			m_head = next;
+		// free the cell for the writers' next lap
+		AtomicStoreRelease(&m_cells[m_readPos & m_mask].m_sequence, m_readPos + m_mask + 1);
+		AtomicStoreRelease(&m_readPos, m_readPos + 1);
 	}
 
 	// Retrieve the first element in the queue (reader)
 	T front(void) const
 	{
-		if (empty() == false)
-		{
-			iterator next = m_head;
-			++next;
-
-			if (next != m_tail)
-				return *next;
-		}
+		if (empty())
+			throw CException(LOGL_ERROR, 0, "No elements to read from queue.");
 
-		// this should never happen
-		throw CException(LOGL_ERROR, 0, "No elements to read from queue.");
+		return m_cells[m_readPos & m_mask].m_value;
 	}
 };
 
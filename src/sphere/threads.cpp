@@ -8,6 +8,9 @@
 #include <sys/prctl.h>
 #endif
 #include <algorithm>
+#ifdef THREAD_SAMPLE_CALLSTACK
+#include <cxxabi.h>
+#endif
 
 // number of exceptions after which we restart thread and think that the thread have gone in exceptioning loops
 #define EXCEPTIONS_ALLOWED	10
@@ -341,6 +344,13 @@ bool AbstractThread::isCurrentThread() const
 #endif
 }
 
+#ifdef THREAD_SAMPLE_CALLSTACK
+bool AbstractThread::raiseSignal(int sig) const
+{
+	return (pthread_kill(m_handle, sig) == 0);
+}
+#endif
+
 bool AbstractThread::checkStuck()
 {
 	if( isActive() )
@@ -363,6 +373,9 @@ bool AbstractThread::checkStuck()
 			//g_Log.Event(LOGL_CRIT, "'%s' thread hang, restarting...\n", m_name);
 			#ifdef THREAD_TRACK_CALLSTACK
 				static_cast<AbstractSphereThread*>(this)->printStackTrace();
+			#elif defined(THREAD_SAMPLE_CALLSTACK)
+				if ( static_cast<AbstractSphereThread*>(this)->requestStackTrace() )
+					static_cast<AbstractSphereThread*>(this)->printStackTrace();
 			#endif
 			terminate(false);
 			run();
@@ -477,6 +490,8 @@ AbstractSphereThread::AbstractSphereThread(const char *name, Priority priority)
 	m_stackPos = 0;
 	memset(m_stackInfo, 0, sizeof(m_stackInfo));
 	m_freezeCallStack = false;
+#elif defined(THREAD_SAMPLE_CALLSTACK)
+	m_stackFrameCount = 0;
 #endif
 
 	// profiles that apply to every thread
@@ -588,6 +603,63 @@ void AbstractSphereThread::printStackTrace()
 
 	freezeCallStack(false);
 }
+#elif defined(THREAD_SAMPLE_CALLSTACK)
+bool AbstractSphereThread::requestStackTrace()
+{
+	// ask the thread to record where it is now (see Signal_StackTrace), and give it some time to answer
+	if ( !isActive() || isCurrentThread() )
+		return false;
+
+	m_stackFrameCount = 0;
+	if ( !raiseSignal(THREAD_SAMPLE_SIGNAL) )
+		return false;
+
+	for ( int i = 0; i < 100; i++ )
+	{
+		if ( hasStackTrace() )
+			return true;
+		usleep(1000);
+	}
+	return false;
+}
+
+void AbstractSphereThread::printStackTrace()
+{
+	// print the callstack recorded by captureStackTrace(), the addresses can be resolved
+	// with addr2line when the executable has no symbols (link with -rdynamic)
+	int iFrames = m_stackFrameCount;
+	m_stackFrameCount = 0;
+	if ( iFrames <= 0 )
+		return;
+
+	unsigned int threadId = getId();
+	char **ppSymbols = backtrace_symbols(m_stackFrames, iFrames);
+
+	g_Log.EventDebug("__ thread (%u) __ |  # | _____________ function _____________ | __ address __\n", threadId);
+	for ( int i = 0; i < iFrames; i++ )
+	{
+		// "module(mangled+offset) [address]"
+		char *pszName = NULL;
+		char *pszDemangled = NULL;
+		if ( ppSymbols != NULL )
+		{
+			pszName = ppSymbols[i];
+			char *pszStart = strchr(pszName, '(');
+			char *pszEnd = (pszStart != NULL) ? strchr(pszStart, '+') : NULL;
+			if ( pszEnd != NULL && pszEnd > pszStart + 1 )
+			{
+				*pszEnd = '\0';
+				int iStatus = 0;
+				pszDemangled = abi::__cxa_demangle(pszStart + 1, NULL, NULL, &iStatus);
+				*pszEnd = '+';
+			}
+		}
+
+		g_Log.EventDebug(">>         %u     | %2d | %36s | %p\n", threadId, i, (pszDemangled != NULL) ? pszDemangled : ((pszName != NULL) ? pszName : "?"), m_stackFrames[i]);
+		free(pszDemangled);
+	}
+	free(ppSymbols);
+}
 #endif
 
 /*
@@ -21,6 +21,22 @@
 #	endif
 #endif
 
+// record the callstack only when it is needed (errors, signals, frozen threads) with backtrace(),
+// ADDTOCALLSTACK costs nothing then (linux only, via makefile)
+#ifdef THREAD_SAMPLE_CALLSTACK
+#	ifdef _WIN32
+#		error "THREAD_SAMPLE_CALLSTACK requires backtrace()"
+#	endif
+#	ifdef THREAD_TRACK_CALLSTACK
+#		undef THREAD_SAMPLE_CALLSTACK
+#	else
+#		include <execinfo.h>
+#		include <signal.h>
+#	endif
+#endif
+#define THREAD_SAMPLE_FRAMES	64	// deepest callstack recorded by THREAD_SAMPLE_CALLSTACK
+#define THREAD_SAMPLE_SIGNAL	SIGUSR2	// asks a frozen thread to record its callstack
+
 /**
  * Sphere threading system
  * Threads should be inherited from AbstractThread with overridden tick() method
@@ -140,6 +156,9 @@ public:
 	bool isActive() const;
 	bool isCurrentThread() const;
 	bool checkStuck();
+#ifdef THREAD_SAMPLE_CALLSTACK
+	bool raiseSignal(int sig) const;
+#endif
 
 	virtual void start();
 	virtual void terminate(bool ended);
@@ -177,6 +196,9 @@ private:
 	STACK_INFO_REC m_stackInfo[0x1000];
 	size_t m_stackPos;
 	bool m_freezeCallStack;
+#elif defined(THREAD_SAMPLE_CALLSTACK)
+	void *m_stackFrames[THREAD_SAMPLE_FRAMES];
+	volatile int m_stackFrameCount;	// frames recorded by captureStackTrace(), 0 = none
 #endif
 
 public:
@@ -209,9 +231,28 @@ public:
 
 	void pushStackCall(const char *name);
 	void printStackTrace(void);
+#elif defined(THREAD_SAMPLE_CALLSTACK)
+	inline void captureStackTrace(void)
+	{
+		m_stackFrameCount = backtrace(m_stackFrames, THREAD_SAMPLE_FRAMES);
+	}
+
+	inline bool hasStackTrace(void) const
+	{
+		return (m_stackFrameCount > 0);
+	}
+
+	inline void clearStackTrace(void)
+	{
+		m_stackFrameCount = 0;
+	}
+
+	bool requestStackTrace(void);
+	void printStackTrace(void);
 #endif
 
 	ProfileData m_profile;	// the current active statistical profile.
+	ScopeProfiler m_scopes;	// nested scopes timed by PROFILESCOPES.
 
 protected:
 	virtual bool shouldExit();
@@ -360,6 +401,40 @@ public:
 #else
 #define ADDTOCALLSTACK_INTENSIVE(_function_)
 #endif
+#elif defined(THREAD_SAMPLE_CALLSTACK)
+class StackDebugInformation
+{
+private:
+	StackDebugInformation();
+	StackDebugInformation(const StackDebugInformation& copy);
+	StackDebugInformation& operator=(const StackDebugInformation& other);
+
+public:
+	// remember where an error is raised, it is printed once caught
+	inline static void captureStackTrace()
+	{
+		static_cast<AbstractSphereThread *>(ThreadHolder::current())->captureStackTrace();
+	}
+
+	// the error is handled, don't print its callstack for a later one
+	inline static void clearStackTrace()
+	{
+		static_cast<AbstractSphereThread *>(ThreadHolder::current())->clearStackTrace();
+	}
+
+	inline static void printStackTrace()
+	{
+		AbstractSphereThread *thread = static_cast<AbstractSphereThread *>(ThreadHolder::current());
+		if ( !thread->hasStackTrace() )
+			thread->captureStackTrace();
+		thread->printStackTrace();
+	}
+};
+
+#define ADDTOCALLSTACK(_function_)
+#define ADDTOCALLSTACK_INTENSIVE(_function_)
+#define PAUSECALLSTACK
+#define UNPAUSECALLSTACK
 #else
 #define ADDTOCALLSTACK(_function_)
 #define ADDTOCALLSTACK_INTENSIVE(_function_)